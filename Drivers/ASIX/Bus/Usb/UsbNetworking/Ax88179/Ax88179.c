@@ -1040,3 +1040,200 @@ done:
 no_pkt:
    return Status;
 }
+
+/**
+  Send the queued frames to the adapter in a single bulk out transfer.
+
+  Each frame is preceded by its TX header and starts on a four byte
+  boundary.  The caller buffers of the frames are moved to the list
+  returned by GetStatus once the transfer succeeded.  On failure the
+  frames stay queued and are sent again by the next flush.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+  @retval EFI_SUCCESS         The frames were sent or none were queued
+  @retval EFI_NOT_READY       The transfer timed out
+  @retval EFI_DEVICE_ERROR    The transfer failed
+
+**/
+EFI_STATUS
+Ax88179TxFlush (
+  IN NIC_DEVICE *NicDevice
+  )
+{
+  EFI_USB_IO_PROTOCOL *UsbIo;
+  TX_PACKET           *Packet;
+  EFI_STATUS          Status;
+  UINTN               TransferLength;
+  UINT32              TransferStatus;
+  UINTN               Index;
+
+  if (NicDevice->TxPendingCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  //  Have the adapter pad the last frame rather than ending the
+  //  transfer on a USB packet boundary
+  //
+  if ((NicDevice->TxAggLength % NicDevice->UsbMaxPktSize) == 0) {
+    Packet = (TX_PACKET *) &NicDevice->TxAggBuf[NicDevice->TxAggLast];
+    Packet->TxHdr2 |= TXHDR2_PADDING;
+  }
+
+  //
+  //  Work around USB bus driver bug where a timeout set by receive
+  //  succeeds but the timeout expires immediately after, causing the
+  //  transmit operation to timeout.
+  //
+  TransferLength = NicDevice->TxAggLength;
+  UsbIo = NicDevice->UsbIo;
+  Status = UsbIo->UsbBulkTransfer (UsbIo,
+                                   BULK_OUT_ENDPOINT,
+                                   NicDevice->TxAggBuf,
+                                   &TransferLength,
+                                   0xfffffffe,
+                                   &TransferStatus);
+
+  if ((!EFI_ERROR (Status)) && (!EFI_ERROR (TransferStatus))) {
+    Status = EFI_SUCCESS;
+  } else if (EFI_TIMEOUT == Status && EFI_USB_ERR_TIMEOUT == TransferStatus) {
+    Status = EFI_NOT_READY;
+  } else {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Ax88179TxFlush: %d frames not sent, %r\n",
+            NicDevice->TxPendingCount, Status));
+    return Status;
+  }
+
+  for (Index = 0; Index < NicDevice->TxPendingCount; Index++) {
+    NicDevice->TxDone[(NicDevice->TxDoneHead + NicDevice->TxDoneCount) % TX_QUEUE_SIZE] = NicDevice->TxPending[Index];
+    NicDevice->TxDoneCount++;
+  }
+  NicDevice->TxPendingCount = 0;
+  NicDevice->TxAggLength = 0;
+
+  return Status;
+}
+
+/**
+  Move the frames of the current bulk in transfer into the receive ring.
+
+  Bulk in transfers are started as needed until the ring is full or the
+  adapter has no more data.  A transfer containing a bad frame is dropped
+  from that frame on.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+Ax88179RxRingFill (
+  IN NIC_DEVICE *NicDevice
+  )
+{
+  RX_PACKET *Packet;
+  UINT16    CurrentPktLen;
+  BOOLEAN   Valid;
+
+  while (NicDevice->RxRingCount < RX_RING_SIZE) {
+    if (NicDevice->PktCnt == 0) {
+      if (EFI_ERROR (Ax88179BulkIn (NicDevice)) || (NicDevice->PktCnt == 0)) {
+        break;
+      }
+    }
+
+    CurrentPktLen = *((UINT16*) (NicDevice->CurPktHdrOff + 2));
+    Valid = (BOOLEAN) ((CurrentPktLen & (RXHDR_DROP | RXHDR_CRCERR)) == 0);
+    CurrentPktLen &=  0x1fff;
+    CurrentPktLen -= 2; /*EEEE*/
+
+    if (!Valid || (CurrentPktLen < 60) ||
+        ((CurrentPktLen - 14) > MAX_ETHERNET_PKT_SIZE) ||
+        (*((UINT16*)NicDevice->CurPktOff)) != 0xEEEE) {
+      NicDevice->PktCnt = 0;
+      break;
+    }
+
+    Packet = &NicDevice->RxRing[(NicDevice->RxRingHead + NicDevice->RxRingCount) % RX_RING_SIZE];
+    Packet->Length = CurrentPktLen;
+    CopyMem (&Packet->Data[0], NicDevice->CurPktOff + 2, CurrentPktLen);
+    NicDevice->RxRingCount++;
+
+    NicDevice->PktCnt--;
+    NicDevice->CurPktHdrOff += 4;
+    NicDevice->CurPktOff += (CurrentPktLen + 2 + 7) & 0xfff8;
+  }
+}
+
+/**
+  Change the period of the receive timer.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+  @param [in] Period          New period in 100ns units
+
+**/
+VOID
+Ax88179RxPollPeriodSet (
+  IN NIC_DEVICE *NicDevice,
+  IN UINT64     Period
+  )
+{
+  if (NicDevice->RxPollPeriod != Period) {
+    NicDevice->RxPollPeriod = Period;
+    gBS->SetTimer (NicDevice->Timer, TimerPeriodic, Period);
+  }
+}
+
+/**
+  Timer routine which keeps the receive ring filled and sends the
+  frames left in the transmit queue.
+
+  The timer runs at TPL_CALLBACK, the same level the simple network
+  protocol routines raise to, so it never runs in the middle of one.
+
+  SN_Receive polls the adapter itself when the ring is empty, so the timer
+  only collects frames arriving while nobody calls it and skips the bulk
+  in transfer when SN_Receive polled since the last tick. An empty bulk in
+  transfer blocks for BULKIN_TIMEOUT, so the period is doubled up to
+  RX_POLL_PERIOD_IDLE each time no frame arrives, and goes back to
+  RX_POLL_PERIOD as soon as one does or a frame is transmitted.
+
+  @param [in] Event           Timer event
+  @param [in] Context         Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+EFIAPI
+Ax88179RxTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NIC_DEVICE *NicDevice;
+  UINTN      RxRingCount;
+
+  NicDevice = (NIC_DEVICE *) Context;
+  if ((EfiSimpleNetworkInitialized == NicDevice->SimpleNetworkData.State) &&
+      NicDevice->LinkUp && NicDevice->Complete) {
+    Ax88179TxFlush (NicDevice);
+
+    if (NicDevice->RxPolled) {
+      NicDevice->RxPolled = FALSE;
+      return;
+    }
+
+    RxRingCount = NicDevice->RxRingCount;
+    Ax88179RxRingFill (NicDevice);
+
+    if ((NicDevice->RxRingCount != RxRingCount) ||
+        (NicDevice->RxRingCount == RX_RING_SIZE)) {
+      Ax88179RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
+    } else {
+      Ax88179RxPollPeriodSet (NicDevice,
+                              MIN (NicDevice->RxPollPeriod * 2, RX_POLL_PERIOD_IDLE));
+    }
+  }
+}
@@ -72,10 +72,17 @@
 #define AX88179_BULKIN_SIZE_INK     2
 #define AX88179_MAX_BULKIN_SIZE    (1024 * AX88179_BULKIN_SIZE_INK)
 #define AX88179_MAX_PKT_SIZE  2048
+#define AX88179_MAX_BULKOUT_SIZE   (1024 * 16)
 
 #define HC_DEBUG        0
 #define ADD_MACPATHNOD  1
 #define BULKIN_TIMEOUT  3 //5000
+#define RX_RING_SIZE    32  ///<  Number of frames buffered by the receive timer
+#define RX_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (5)    ///<  Receive timer period while frames arrive
+#define RX_POLL_PERIOD_IDLE  EFI_TIMER_PERIOD_MILLISECONDS (20)  ///<  Longest receive timer period on an idle link
+#define TX_AGG_MAX_PKT  16  ///<  Maximum number of frames in one bulk out transfer
+#define TX_QUEUE_SIZE   32  ///<  Number of transmit buffers not yet returned by GetStatus
+#define TXHDR2_PADDING  0x80008000
 #define TX_RETRY        0
 #define AUTONEG_DELAY   1000000
 
@@ -279,14 +286,26 @@ typedef struct {
   UINT8                     *CurPktHdrOff;
   UINT8                     *CurPktOff;
 
-  TX_PACKET                 *TxTest;
+  RX_PACKET                 *RxRing;            ///<  Frames received by the timer, not yet returned
+  UINTN                     RxRingHead;         ///<  Index of the oldest frame in RxRing
+  UINTN                     RxRingCount;        ///<  Number of frames in RxRing
+  UINT64                    RxPollPeriod;       ///<  Current period of Timer
+  BOOLEAN                   RxPolled;           ///<  SN_Receive polled the adapter since the last timer tick
+
+  UINT8                     *TxAggBuf;          ///<  Frames for the next bulk out transfer
+  UINTN                     TxAggLength;        ///<  Number of bytes used in TxAggBuf
+  UINTN                     TxAggLast;          ///<  Offset of the last frame in TxAggBuf
+  VOID                      *TxPending[TX_AGG_MAX_PKT]; ///<  Caller buffers of the frames in TxAggBuf
+  UINTN                     TxPendingCount;     ///<  Number of frames in TxAggBuf
+  VOID                      *TxDone[TX_QUEUE_SIZE];     ///<  Sent buffers to return through GetStatus
+  UINTN                     TxDoneHead;         ///<  Index of the oldest buffer in TxDone
+  UINTN                     TxDoneCount;        ///<  Number of buffers in TxDone
 
   INT8                      MulticastHash[8];
   EFI_MAC_ADDRESS           MAC;
 
   UINT16                    CurMediumStatus;
   UINT16                    CurRxControl;
-  VOID *                    TxBuffer;
 
   EFI_DEVICE_PATH_PROTOCOL  *MyDevPath;
   BOOLEAN                   Grub_f;
@@ -1049,5 +1068,65 @@ Ax88179BulkIn(
   IN NIC_DEVICE *NicDevice
 );
 
+/**
+  Send the queued frames to the adapter in a single bulk out transfer.
+
+  The caller buffers of the frames are moved to the list returned by
+  GetStatus whether or not the transfer succeeded.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+  @retval EFI_SUCCESS         The frames were sent or none were queued
+  @retval EFI_NOT_READY       The transfer timed out
+  @retval EFI_DEVICE_ERROR    The transfer failed
+
+**/
+EFI_STATUS
+Ax88179TxFlush (
+  IN NIC_DEVICE *NicDevice
+  );
+
+/**
+  Move the frames of the current bulk in transfer into the receive ring.
+
+  Bulk in transfers are started as needed until the ring is full or the
+  adapter has no more data.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+Ax88179RxRingFill (
+  IN NIC_DEVICE *NicDevice
+  );
+
+/**
+  Timer routine which keeps the receive ring filled and sends the
+  frames left in the transmit queue.
+
+  @param [in] Event           Timer event
+  @param [in] Context         Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+EFIAPI
+Ax88179RxTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Change the period of the receive timer.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+  @param [in] Period          New period in 100ns units
+
+**/
+VOID
+Ax88179RxPollPeriodSet (
+  IN NIC_DEVICE *NicDevice,
+  IN UINT64     Period
+  );
+
 
 #endif  //  AX88179_H_
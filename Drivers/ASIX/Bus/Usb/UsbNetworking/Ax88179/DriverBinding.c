@@ -273,12 +273,20 @@ DriverStart (
 
 ERR:
 
+  if (NicDevice->Timer != NULL) {
+    gBS->CloseEvent (NicDevice->Timer);
+  }
+
   if (NicDevice->BulkInbuf != NULL) {
     gBS->FreePool (NicDevice->BulkInbuf);
   }
 
-  if (NicDevice->TxTest != NULL) {
-    gBS->FreePool (NicDevice->TxTest);
+  if (NicDevice->RxRing != NULL) {
+    gBS->FreePool (NicDevice->RxRing);
+  }
+
+  if (NicDevice->TxAggBuf != NULL) {
+    gBS->FreePool (NicDevice->TxAggBuf);
   }
 
   if (NicDevice->MyDevPath != NULL) {
@@ -437,12 +445,20 @@ DriverStop (
                         EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
                         );
     } else {
+      if (NicDevice->Timer != NULL) {
+        gBS->CloseEvent (NicDevice->Timer);
+      }
+
       if (NicDevice->BulkInbuf != NULL) {
         gBS->FreePool (NicDevice->BulkInbuf);
       }
 
-      if (NicDevice->TxTest != NULL) {
-        gBS->FreePool (NicDevice->TxTest);
+      if (NicDevice->RxRing != NULL) {
+        gBS->FreePool (NicDevice->RxRing);
+      }
+
+      if (NicDevice->TxAggBuf != NULL) {
+        gBS->FreePool (NicDevice->TxAggBuf);
       }
 
       if (NicDevice->MyDevPath != NULL) {
@@ -133,9 +133,19 @@ SN_GetStatus (
     //
     NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
 
-    if ((TxBuf != NULL) && (NicDevice->TxBuffer != NULL)) {
-      *TxBuf = NicDevice->TxBuffer;
-      NicDevice->TxBuffer = NULL;
+    //
+    //  Send the queued frames so their buffers can be recycled
+    //
+    Ax88179TxFlush (NicDevice);
+
+    if (TxBuf != NULL) {
+      if (NicDevice->TxDoneCount != 0) {
+        *TxBuf = NicDevice->TxDone[NicDevice->TxDoneHead];
+        NicDevice->TxDoneHead = (NicDevice->TxDoneHead + 1) % TX_QUEUE_SIZE;
+        NicDevice->TxDoneCount--;
+      } else {
+        *TxBuf = NULL;
+      }
     }
 
     Mode = SimpleNetwork->Mode;
@@ -354,6 +364,10 @@ SN_Initialize (
         //
         TmpState = Mode->State;
         Mode->State = EfiSimpleNetworkInitialized;
+        NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
+        NicDevice->PktCnt = 0;
+        NicDevice->RxRingHead = 0;
+        NicDevice->RxRingCount = 0;
         Status = SN_Reset (SimpleNetwork, FALSE);
         if (EFI_ERROR (Status)) {
           //
@@ -362,8 +376,13 @@ SN_Initialize (
           Mode->State = TmpState;
         } else {
           Mode->MediaPresentSupported = TRUE;
-          NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
           Mode->MediaPresent = Ax88179GetLinkStatus (NicDevice);
+
+          //
+          // Start receiving in the background
+          //
+          NicDevice->RxPollPeriod = 0;
+          Ax88179RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
         }
       } else {
         Status = EFI_UNSUPPORTED;
@@ -476,8 +495,9 @@ EXIT:
   size of the receive packet will be placed in BufferSize and
   EFI_BUFFER_TOO_SMALL will be returned.
 
-  This routine calls ::Ax88179Rx to update the media status and
-  empty the network adapter of receive packets.
+  Frames are taken from the receive ring, which ::Ax88179RxTimer fills in
+  the background.  When the ring is empty, this routine polls the adapter
+  itself so that a frame does not wait for the next timer tick.
 
   @param [in] SimpleNetwork    Protocol instance pointer
   @param [out] HeaderSize      The size, in bytes, of the media header to be filled in by
@@ -525,10 +545,9 @@ SN_Receive (
   ETHERNET_HEADER         *Header;
   EFI_SIMPLE_NETWORK_MODE *Mode;
   NIC_DEVICE              *NicDevice;
+  RX_PACKET               *Packet;
   EFI_STATUS              Status;
   UINT16                  Type = 0;
-  UINT16                  CurrentPktLen;
-  BOOLEAN                 Valid = TRUE;
   EFI_TPL                 TplPrevious;
 
   TplPrevious = gBS->RaiseTPL (TPL_CALLBACK);
@@ -563,54 +582,47 @@ SN_Receive (
         }
 
         //
-        //  Attempt to do bulk in
+        //  Return the oldest frame of the receive ring
         //
-        if (NicDevice->PktCnt == 0) {
-          Status = Ax88179BulkIn(NicDevice);
-          if (EFI_ERROR(Status))
-            goto  no_pkt;
+        if (NicDevice->RxRingCount == 0) {
+          Ax88179RxRingFill (NicDevice);
+          NicDevice->RxPolled = TRUE;
         }
-        CurrentPktLen = *((UINT16*) (NicDevice->CurPktHdrOff + 2));
-        if (CurrentPktLen & (RXHDR_DROP | RXHDR_CRCERR))
-          Valid = FALSE;
-        CurrentPktLen &=  0x1fff;
-        CurrentPktLen -= 2; /*EEEE*/
-
-        if (Valid && (60 <= CurrentPktLen) &&
-        ((CurrentPktLen - 14) <= MAX_ETHERNET_PKT_SIZE) &&
-            (*((UINT16*)NicDevice->CurPktOff)) == 0xEEEE) {
-          if (*BufferSize < (UINTN)CurrentPktLen) {
-            gBS->RestoreTPL (TplPrevious);
-            return EFI_BUFFER_TOO_SMALL;
-          }
-          *BufferSize = CurrentPktLen;
-          CopyMem (Buffer, NicDevice->CurPktOff + 2, CurrentPktLen);
 
-          Header = (ETHERNET_HEADER *) NicDevice->CurPktOff + 2;
+        if (NicDevice->RxRingCount == 0) {
+          Status = EFI_NOT_READY;
+          goto no_pkt;
+        }
 
-          if ((HeaderSize != NULL)  && ((*HeaderSize != 7720))) {
-            *HeaderSize = sizeof (*Header);
-          }
+        Packet = &NicDevice->RxRing[NicDevice->RxRingHead];
+        if (*BufferSize < (UINTN)Packet->Length) {
+          *BufferSize = Packet->Length;
+          gBS->RestoreTPL (TplPrevious);
+          return EFI_BUFFER_TOO_SMALL;
+        }
+        *BufferSize = Packet->Length;
+        CopyMem (Buffer, &Packet->Data[0], Packet->Length);
 
-          if (DestAddr != NULL) {
-            CopyMem (DestAddr, &Header->DestAddr, PXE_HWADDR_LEN_ETHER);
-          }
-          if (SrcAddr != NULL) {
-            CopyMem (SrcAddr, &Header->SrcAddr, PXE_HWADDR_LEN_ETHER);
-          }
-          if (Protocol != NULL) {
-            Type = Header->Type;
-            Type = (UINT16)((Type >> 8) | (Type << 8));
-            *Protocol = Type;
-          }
-          NicDevice->PktCnt--;
-          NicDevice->CurPktHdrOff += 4;
-          NicDevice->CurPktOff += (CurrentPktLen + 2 + 7) & 0xfff8;
-          Status = EFI_SUCCESS;
-        } else {
-          NicDevice->PktCnt = 0;
-          Status = EFI_NOT_READY;
+        Header = (ETHERNET_HEADER *) &Packet->Data[0];
+
+        if ((HeaderSize != NULL)  && ((*HeaderSize != 7720))) {
+          *HeaderSize = sizeof (*Header);
+        }
+
+        if (DestAddr != NULL) {
+          CopyMem (DestAddr, &Header->DestAddr, PXE_HWADDR_LEN_ETHER);
+        }
+        if (SrcAddr != NULL) {
+          CopyMem (SrcAddr, &Header->SrcAddr, PXE_HWADDR_LEN_ETHER);
         }
+        if (Protocol != NULL) {
+          Type = Header->Type;
+          Type = (UINT16)((Type >> 8) | (Type << 8));
+          *Protocol = Type;
+        }
+        NicDevice->RxRingHead = (NicDevice->RxRingHead + 1) % RX_RING_SIZE;
+        NicDevice->RxRingCount--;
+        Status = EFI_SUCCESS;
       } else {
         Status = EFI_NOT_READY;
       }
@@ -953,7 +965,7 @@ SN_Setup (
            0xff);
   Mode->IfType = NET_IFTYPE_ETHERNET;
   Mode->MacAddressChangeable = TRUE;
-  Mode->MultipleTxSupported = FALSE;
+  Mode->MultipleTxSupported = TRUE;
   Mode->MediaPresentSupported = TRUE;
   Mode->MediaPresent = FALSE;
   //
@@ -997,11 +1009,52 @@ SN_Setup (
     return Status;
   }
 
+  //
+  //  SN_Transmit queues frames in TxAggBuf, they are sent in one bulk
+  //  out transfer by Ax88179TxFlush
+  //
+  NicDevice->TxAggLength = 0;
+  NicDevice->TxPendingCount = 0;
+  NicDevice->TxDoneHead = 0;
+  NicDevice->TxDoneCount = 0;
   Status = gBS->AllocatePool (EfiBootServicesData,
-                               sizeof (TX_PACKET),
-                               (VOID **) &NicDevice->TxTest);
+                               AX88179_MAX_BULKOUT_SIZE,
+                               (VOID **) &NicDevice->TxAggBuf);
   if (EFI_ERROR (Status)) {
     gBS->FreePool (NicDevice->BulkInbuf);
+    NicDevice->BulkInbuf = NULL;
+    return Status;
+  }
+
+  //
+  //  Frames are received by a timer into the receive ring and
+  //  SN_Receive only removes them from the ring
+  //
+  NicDevice->RxRingHead = 0;
+  NicDevice->RxRingCount = 0;
+  Status = gBS->AllocatePool (EfiBootServicesData,
+                               RX_RING_SIZE * sizeof (RX_PACKET),
+                               (VOID **) &NicDevice->RxRing);
+  if (EFI_ERROR (Status)) {
+    gBS->FreePool (NicDevice->BulkInbuf);
+    gBS->FreePool (NicDevice->TxAggBuf);
+    NicDevice->BulkInbuf = NULL;
+    NicDevice->TxAggBuf = NULL;
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                              TPL_CALLBACK,
+                              Ax88179RxTimer,
+                              NicDevice,
+                              &NicDevice->Timer);
+  if (EFI_ERROR (Status)) {
+    gBS->FreePool (NicDevice->BulkInbuf);
+    gBS->FreePool (NicDevice->TxAggBuf);
+    gBS->FreePool (NicDevice->RxRing);
+    NicDevice->BulkInbuf = NULL;
+    NicDevice->TxAggBuf = NULL;
+    NicDevice->RxRing = NULL;
   }
 
   //
@@ -1071,7 +1124,7 @@ SN_Start (
       SetMem(&Mode->BroadcastAddress, PXE_HWADDR_LEN_ETHER, 0xff);
       Mode->IfType = NET_IFTYPE_ETHERNET;
       Mode->MacAddressChangeable = TRUE;
-      Mode->MultipleTxSupported = FALSE;
+      Mode->MultipleTxSupported = TRUE;
       Mode->MediaPresentSupported = TRUE;
       Mode->MediaPresent = FALSE;
 
@@ -1340,6 +1393,11 @@ SN_Shutdown (
       //
       NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
 
+      gBS->SetTimer (NicDevice->Timer, TimerCancel, 0);
+      NicDevice->RxPollPeriod = 0;
+      NicDevice->RxRingCount = 0;
+      Ax88179TxFlush (NicDevice);
+
       Status = Ax88179MacAddressGet (NicDevice, &Mode->PermanentAddress.Addr[0]);
       if (!EFI_ERROR (Status)) {
         //
@@ -1373,9 +1431,14 @@ SN_Shutdown (
   operation.  When the transmit is complete, the buffer is returned
   via the GetStatus() call.
 
-  This routine calls ::Ax88179Rx to empty the network adapter of
-  receive packets.  The routine then passes the transmit packet
-  to the network adapter.
+  The frame is copied behind an AX88179 TX header into the transmit
+  aggregation buffer.  A frame transmitted while no other frame is queued
+  is sent at once by ::Ax88179TxFlush, so a request does not wait for the
+  timer.  Frames queue up behind a transfer that timed out and are then
+  sent together when the buffer is full, from GetStatus() or from the
+  receive timer.  Buffer is returned by
+  GetStatus() after the transfer containing the frame has completed.  If
+  the transfer fails, the frame is not queued and the error is returned.
 
   @param [in] SimpleNetwork    Protocol instance pointer
   @param [in] HeaderSize        The size, in bytes, of the media header to be filled in by
@@ -1423,10 +1486,11 @@ SN_Transmit (
   ETHERNET_HEADER         *Header;
   EFI_SIMPLE_NETWORK_MODE *Mode;
   NIC_DEVICE              *NicDevice;
-  EFI_USB_IO_PROTOCOL     *UsbIo;
+  TX_PACKET               *Packet;
   EFI_STATUS              Status;
-  UINTN                   TransferLength;
-  UINT32                  TransferStatus;
+  UINTN                   Offset;
+  UINTN                   AggLast;
+  UINTN                   AggLength;
   UINT16                  Type = 0;
   EFI_TPL                 TplPrevious;
 
@@ -1466,17 +1530,52 @@ SN_Transmit (
           Status = EFI_INVALID_PARAMETER;
           goto EXIT;
         }
+        if (BufferSize > AX88179_MAX_PKT_SIZE) {
+          Status = EFI_INVALID_PARAMETER;
+          goto EXIT;
+        }
+
         //
-        //  Copy the packet into the USB buffer
+        //  Wait for GetStatus to recycle buffers when the queue is full
         //
-        // Buffer starting with 14 bytes 0
-        CopyMem (&NicDevice->TxTest->Data[0], Buffer, BufferSize);
-        NicDevice->TxTest->TxHdr1 = (UINT32) BufferSize;
-        NicDevice->TxTest->TxHdr2 = 0;
+        if (NicDevice->TxPendingCount + NicDevice->TxDoneCount >= TX_QUEUE_SIZE) {
+          Status = EFI_NOT_READY;
+          goto EXIT;
+        }
+
+        //
+        //  Send the queued frames first if this one does not fit
         //
-        //  Transmit the packet
+        Offset = ALIGN_VALUE (NicDevice->TxAggLength, 4);
+        if ((NicDevice->TxPendingCount == TX_AGG_MAX_PKT) ||
+            (Offset + sizeof (TX_PACKET) > AX88179_MAX_BULKOUT_SIZE)) {
+          Status = Ax88179TxFlush (NicDevice);
+          if (EFI_ERROR (Status)) {
+            goto EXIT;
+          }
+          Offset = 0;
+        }
+
         //
-        Header = (ETHERNET_HEADER *) &NicDevice->TxTest->Data[0];
+        //  The last frame may have been marked for padding by a transfer
+        //  that failed, it is no longer the last one
+        //
+        AggLast = NicDevice->TxAggLast;
+        AggLength = NicDevice->TxAggLength;
+        if (NicDevice->TxPendingCount != 0) {
+          ((TX_PACKET *) &NicDevice->TxAggBuf[AggLast])->TxHdr2 &= ~TXHDR2_PADDING;
+        }
+
+        //
+        //  Copy the packet into the USB buffer
+        //
+        // Buffer starting with 14 bytes 0
+        Packet = (TX_PACKET *) &NicDevice->TxAggBuf[Offset];
+        CopyMem (&Packet->Data[0], Buffer, BufferSize);
+        Packet->TxHdr1 = (UINT32) BufferSize;
+        Packet->TxHdr2 = 0;
+
+        Header = (ETHERNET_HEADER *) &Packet->Data[0];
         if (HeaderSize != 0) {
           if (DestAddr != NULL) {
             CopyMem (&Header->DestAddr, DestAddr, PXE_HWADDR_LEN_ETHER);
@@ -1495,36 +1594,45 @@ SN_Transmit (
           Header->Type = Type;
         }
 
-        if (NicDevice->TxTest->TxHdr1 < MIN_ETHERNET_PKT_SIZE) {
-          NicDevice->TxTest->TxHdr1 = MIN_ETHERNET_PKT_SIZE;
-          ZeroMem (&NicDevice->TxTest->Data[BufferSize],
+        if (Packet->TxHdr1 < MIN_ETHERNET_PKT_SIZE) {
+          Packet->TxHdr1 = MIN_ETHERNET_PKT_SIZE;
+          ZeroMem (&Packet->Data[BufferSize],
                     MIN_ETHERNET_PKT_SIZE - BufferSize);
         }
 
-        TransferLength = sizeof (NicDevice->TxTest->TxHdr1)
-                       + sizeof (NicDevice->TxTest->TxHdr2)
-                       + NicDevice->TxTest->TxHdr1;
         //
-        //  Work around USB bus driver bug where a timeout set by receive
-        //  succeeds but the timeout expires immediately after, causing the
-        //  transmit operation to timeout.
+        //  Queue the packet, it is transmitted by Ax88179TxFlush
         //
-        UsbIo = NicDevice->UsbIo;
-        Status = UsbIo->UsbBulkTransfer (UsbIo,
-                                           BULK_OUT_ENDPOINT,
-                                           &NicDevice->TxTest->TxHdr1,
-                                           &TransferLength,
-                                           0xfffffffe,
-                                           &TransferStatus);
-
-        if (!EFI_ERROR(Status) && !EFI_ERROR(Status)) {
-          NicDevice->TxBuffer = Buffer;
-          Status = EFI_SUCCESS;
-        } else if (EFI_TIMEOUT == Status && EFI_USB_ERR_TIMEOUT == TransferStatus) {
-          Status = EFI_NOT_READY;
-        } else {
-          Status = EFI_DEVICE_ERROR;
+        NicDevice->TxAggLast = Offset;
+        NicDevice->TxAggLength = Offset
+                               + sizeof (Packet->TxHdr1)
+                               + sizeof (Packet->TxHdr2)
+                               + Packet->TxHdr1;
+        NicDevice->TxPending[NicDevice->TxPendingCount] = Buffer;
+        NicDevice->TxPendingCount++;
+
+        //
+        //  Send a lone frame at once.  Behind a transfer that timed out it
+        //  stays queued and goes out with the next flush; any other error
+        //  takes it back out of the queue and is returned to the caller.
+        //
+        Status = EFI_SUCCESS;
+        if (NicDevice->TxPendingCount == 1) {
+          Status = Ax88179TxFlush (NicDevice);
+          if (Status == EFI_NOT_READY) {
+            Status = EFI_SUCCESS;
+          } else if (EFI_ERROR (Status)) {
+            NicDevice->TxPendingCount--;
+            NicDevice->TxAggLast = AggLast;
+            NicDevice->TxAggLength = AggLength;
+            goto EXIT;
+          }
         }
+
+        //
+        //  Poll quickly again, a reply is likely
+        //
+        Ax88179RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
       } else {
         //
         // No packets available.
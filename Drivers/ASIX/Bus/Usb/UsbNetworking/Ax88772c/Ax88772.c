@@ -1298,3 +1298,115 @@ no_pkt:
   return Status;
 }
 #endif
+
+/**
+  Move the frames of the current bulk in transfer into the receive ring.
+
+  Bulk in transfers are started as needed until the ring is full or the
+  adapter has no more data.  A transfer containing a bad frame is dropped
+  from that frame on.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+Ax88772RxRingFill (
+  IN NIC_DEVICE *NicDevice
+  )
+{
+  RX_TX_PACKET *Packet;
+  UINT16       CurrentPktLen;
+
+  while (NicDevice->RxRingCount < RX_RING_SIZE) {
+    if (0 == NicDevice->PktCnt) {
+      if (EFI_ERROR (Ax88772BulkIn (NicDevice)) || (0 == NicDevice->PktCnt)) {
+        break;
+      }
+    }
+
+    CurrentPktLen = *((UINT16*) (NicDevice->CurPktHdrOff));
+    CurrentPktLen &=  0x7ff;
+
+    if ((CurrentPktLen < 60) ||
+        ((CurrentPktLen - 14) > MAX_ETHERNET_PKT_SIZE)) {
+      NicDevice->PktCnt = 0;
+      break;
+    }
+
+    Packet = &NicDevice->RxRing[(NicDevice->RxRingHead + NicDevice->RxRingCount) % RX_RING_SIZE];
+    Packet->Length = CurrentPktLen;
+    CopyMem (&Packet->Data[0], NicDevice->CurPktOff, CurrentPktLen);
+    NicDevice->RxRingCount++;
+
+    NicDevice->PktCnt--;
+    NicDevice->CurPktHdrOff += (CurrentPktLen + 4 + 1) & 0xfffe;
+    NicDevice->CurPktOff = NicDevice->CurPktHdrOff + 4;
+  }
+}
+
+/**
+  Change the period of the receive timer.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+  @param [in] Period          New period in 100ns units
+
+**/
+VOID
+Ax88772RxPollPeriodSet (
+  IN NIC_DEVICE *NicDevice,
+  IN UINT64     Period
+  )
+{
+  if (NicDevice->RxPollPeriod != Period) {
+    NicDevice->RxPollPeriod = Period;
+    gBS->SetTimer (NicDevice->Timer, TimerPeriodic, Period);
+  }
+}
+
+/**
+  Timer routine which keeps the receive ring filled.
+
+  The timer runs at TPL_CALLBACK, the same level the simple network
+  protocol routines raise to, so it never runs in the middle of one.
+
+  SN_Receive polls the adapter itself when the ring is empty, so the timer
+  only collects frames arriving while nobody calls it and skips the bulk
+  in transfer when SN_Receive polled since the last tick. An empty bulk in
+  transfer blocks for BULKIN_TIMEOUT, so the period is doubled up to
+  RX_POLL_PERIOD_IDLE each time no frame arrives, and goes back to
+  RX_POLL_PERIOD as soon as one does or a frame is transmitted.
+
+  @param [in] Event           Timer event
+  @param [in] Context         Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+EFIAPI
+Ax88772RxTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NIC_DEVICE *NicDevice;
+  UINTN      RxRingCount;
+
+  NicDevice = (NIC_DEVICE *) Context;
+  if ((EfiSimpleNetworkInitialized == NicDevice->SimpleNetworkData.State) &&
+      NicDevice->LinkUp && NicDevice->Complete) {
+    if (NicDevice->RxPolled) {
+      NicDevice->RxPolled = FALSE;
+      return;
+    }
+
+    RxRingCount = NicDevice->RxRingCount;
+    Ax88772RxRingFill (NicDevice);
+
+    if ((NicDevice->RxRingCount != RxRingCount) ||
+        (NicDevice->RxRingCount == RX_RING_SIZE)) {
+      Ax88772RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
+    } else {
+      Ax88772RxPollPeriodSet (NicDevice,
+                              MIN (NicDevice->RxPollPeriod * 2, RX_POLL_PERIOD_IDLE));
+    }
+  }
+}
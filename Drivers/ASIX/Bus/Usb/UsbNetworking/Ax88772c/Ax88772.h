@@ -78,6 +78,9 @@
 #define USB_BUS_TIMEOUT     1000    ///<  USB timeout in milliseconds
 
 #define TIMER_MSEC          20              ///<  Polling interval for the NIC
+#define RX_RING_SIZE        32              ///<  Number of frames buffered by the receive timer
+#define RX_POLL_PERIOD      EFI_TIMER_PERIOD_MILLISECONDS (5)  ///<  Receive timer period while frames arrive
+#define RX_POLL_PERIOD_IDLE EFI_TIMER_PERIOD_MILLISECONDS (20)  ///<  Longest receive timer period on an idle link
 
 #define HC_DEBUG  0
 
@@ -364,6 +367,13 @@ typedef struct {
   UINT8                     *CurPktOff;
   UINT16                    PktCnt;
 
+  EFI_EVENT                 Timer;              ///<  Timer which receives packets into RxRing
+  RX_TX_PACKET              *RxRing;            ///<  Frames received by the timer, not yet returned
+  UINTN                     RxRingHead;         ///<  Index of the oldest frame in RxRing
+  UINTN                     RxRingCount;        ///<  Number of frames in RxRing
+  UINT64                    RxPollPeriod;       ///<  Current period of Timer
+  BOOLEAN                   RxPolled;           ///<  SN_Receive polled the adapter since the last timer tick
+
   RX_TX_PACKET              *TxTest;
 
   UINT8                     MulticastHash[8];
@@ -1036,6 +1046,47 @@ Ax88772BulkIn(
   IN NIC_DEVICE *NicDevice
 );
 
+/**
+  Move the frames of the current bulk in transfer into the receive ring.
+
+  Bulk in transfers are started as needed until the ring is full or the
+  adapter has no more data.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+Ax88772RxRingFill (
+  IN NIC_DEVICE *NicDevice
+  );
+
+/**
+  Timer routine which keeps the receive ring filled.
+
+  @param [in] Event           Timer event
+  @param [in] Context         Pointer to the NIC_DEVICE structure
+
+**/
+VOID
+EFIAPI
+Ax88772RxTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Change the period of the receive timer.
+
+  @param [in] NicDevice       Pointer to the NIC_DEVICE structure
+  @param [in] Period          New period in 100ns units
+
+**/
+VOID
+Ax88772RxPollPeriodSet (
+  IN NIC_DEVICE *NicDevice,
+  IN UINT64     Period
+  );
+
 //------------------------------------------------------------------------------
 
 #endif  //  AX88772_H_
@@ -285,10 +285,18 @@ DriverStart (
 
 ERR:
 
+  if (NicDevice->Timer != NULL) {
+    gBS->CloseEvent (NicDevice->Timer);
+  }
+
   if (NicDevice->BulkInbuf != NULL) {
     gBS->FreePool (NicDevice->BulkInbuf);
   }
 
+  if (NicDevice->RxRing != NULL) {
+    gBS->FreePool (NicDevice->RxRing);
+  }
+
   if (NicDevice->TxTest != NULL) {
     gBS->FreePool (NicDevice->TxTest);
   }
@@ -450,10 +458,18 @@ DriverStop (
                         EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
                         );
     } else {
+      if (NicDevice->Timer != NULL) {
+        gBS->CloseEvent (NicDevice->Timer);
+      }
+
       if (NicDevice->BulkInbuf != NULL) {
         gBS->FreePool (NicDevice->BulkInbuf);
       }
 
+      if (NicDevice->RxRing != NULL) {
+        gBS->FreePool (NicDevice->RxRing);
+      }
+
       if (NicDevice->TxTest != NULL) {
         gBS->FreePool (NicDevice->TxTest);
       }
@@ -353,6 +353,10 @@ SN_Initialize (
         //
         TmpState = Mode->State;
         Mode->State = EfiSimpleNetworkInitialized;
+        NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
+        NicDevice->PktCnt = 0;
+        NicDevice->RxRingHead = 0;
+        NicDevice->RxRingCount = 0;
         Status = SN_Reset (SimpleNetwork, FALSE);
         if (EFI_ERROR (Status)) {
           //
@@ -361,8 +365,13 @@ SN_Initialize (
           Mode->State = TmpState; // EfiSimpleNetworkInitialized;
         } else {
           Mode->MediaPresentSupported = TRUE;
-          NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
           Mode->MediaPresent = Ax88772GetLinkStatus (NicDevice);
+
+          //
+          // Start receiving in the background
+          //
+          NicDevice->RxPollPeriod = 0;
+          Ax88772RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
         }
       } else {
         Status = EFI_UNSUPPORTED;
@@ -475,8 +484,9 @@ EXIT:
   size of the receive packet will be placed in BufferSize and
   EFI_BUFFER_TOO_SMALL will be returned.
 
-  This routine calls ::Ax88179Rx to update the media status and
-  empty the network adapter of receive packets.
+  Frames are taken from the receive ring, which ::Ax88772RxTimer fills in
+  the background.  When the ring is empty, this routine polls the adapter
+  itself so that a frame does not wait for the next timer tick.
 
   @param [in] SimpleNetwork    Protocol instance pointer
   @param [out] HeaderSize      The size, in bytes, of the media header to be filled in by
@@ -524,10 +534,10 @@ SN_Receive (
   ETHERNET_HEADER         *Header;
   EFI_SIMPLE_NETWORK_MODE *Mode;
   NIC_DEVICE              *NicDevice = NULL;
+  RX_TX_PACKET            *Packet;
   EFI_STATUS              Status;
   EFI_TPL                 TplPrevious;
   UINT16                  Type;
-  UINT16                  CurrentPktLen;
 
 
   TplPrevious = gBS->RaiseTPL (TPL_CALLBACK);
@@ -562,51 +572,46 @@ SN_Receive (
         }
 
         //
-        //  Attempt to receive a packet
+        //  Return the oldest frame of the receive ring
         //
-        if (0 == NicDevice->PktCnt) {
-          Status = Ax88772BulkIn(NicDevice);
-          if (EFI_ERROR(Status)) {
-            goto  no_pkt;
-          }
+        if (NicDevice->RxRingCount == 0) {
+          Ax88772RxRingFill (NicDevice);
+          NicDevice->RxPolled = TRUE;
         }
 
-        CurrentPktLen = *((UINT16*) (NicDevice->CurPktHdrOff));
-        CurrentPktLen &=  0x7ff;
-
-        if ((60 <= CurrentPktLen) &&
-            (CurrentPktLen - 14 <= MAX_ETHERNET_PKT_SIZE)) {
-            if (*BufferSize < (UINTN)CurrentPktLen) {
-              gBS->RestoreTPL (TplPrevious);
-              return EFI_BUFFER_TOO_SMALL;
-            }
-
-            *BufferSize = CurrentPktLen;
-            CopyMem (Buffer, NicDevice->CurPktOff, CurrentPktLen);
-            Header = (ETHERNET_HEADER *) NicDevice->CurPktOff;
-
-            if ((HeaderSize != NULL)  && (*HeaderSize != 7720)) {
-              *HeaderSize = sizeof (*Header);
-            }
-            if (DestAddr != NULL) {
-              CopyMem (DestAddr, &Header->DestAddr, PXE_HWADDR_LEN_ETHER);
-            }
-            if (SrcAddr != NULL) {
-              CopyMem (SrcAddr, &Header->SrcAddr, PXE_HWADDR_LEN_ETHER);
-            }
-            if (Protocol != NULL) {
-              Type = Header->Type;
-              Type = (UINT16)((Type >> 8) | (Type << 8));
-              *Protocol = Type;
-            }
-            NicDevice->PktCnt--;
-            NicDevice->CurPktHdrOff += (CurrentPktLen + 4 + 1) & 0xfffe;
-            NicDevice->CurPktOff = NicDevice->CurPktHdrOff + 4;
-            Status = EFI_SUCCESS;
-        } else {
-          NicDevice->PktCnt = 0;
-          Status = EFI_DEVICE_ERROR;
+        if (0 == NicDevice->RxRingCount) {
+          Status = EFI_NOT_READY;
+          goto  no_pkt;
         }
+
+        Packet = &NicDevice->RxRing[NicDevice->RxRingHead];
+        if (*BufferSize < (UINTN)Packet->Length) {
+          *BufferSize = Packet->Length;
+          gBS->RestoreTPL (TplPrevious);
+          return EFI_BUFFER_TOO_SMALL;
+        }
+
+        *BufferSize = Packet->Length;
+        CopyMem (Buffer, &Packet->Data[0], Packet->Length);
+        Header = (ETHERNET_HEADER *) &Packet->Data[0];
+
+        if ((HeaderSize != NULL)  && (*HeaderSize != 7720)) {
+          *HeaderSize = sizeof (*Header);
+        }
+        if (DestAddr != NULL) {
+          CopyMem (DestAddr, &Header->DestAddr, PXE_HWADDR_LEN_ETHER);
+        }
+        if (SrcAddr != NULL) {
+          CopyMem (SrcAddr, &Header->SrcAddr, PXE_HWADDR_LEN_ETHER);
+        }
+        if (Protocol != NULL) {
+          Type = Header->Type;
+          Type = (UINT16)((Type >> 8) | (Type << 8));
+          *Protocol = Type;
+        }
+        NicDevice->RxRingHead = (NicDevice->RxRingHead + 1) % RX_RING_SIZE;
+        NicDevice->RxRingCount--;
+        Status = EFI_SUCCESS;
       } else {
         //
         //  Link no up
@@ -1011,6 +1016,41 @@ SN_Setup (
 
   if (EFI_ERROR (Status)) {
     gBS->FreePool (NicDevice->BulkInbuf);
+    NicDevice->BulkInbuf = NULL;
+    return Status;
+  }
+
+  //
+  //  Frames are received by a timer into the receive ring and
+  //  SN_Receive only removes them from the ring
+  //
+  NicDevice->RxRingHead = 0;
+  NicDevice->RxRingCount = 0;
+  Status = gBS->AllocatePool (EfiBootServicesData,
+                                   RX_RING_SIZE * sizeof (RX_TX_PACKET),
+                                   (VOID **) &NicDevice->RxRing);
+
+  if (EFI_ERROR (Status)) {
+    gBS->FreePool (NicDevice->BulkInbuf);
+    gBS->FreePool (NicDevice->TxTest);
+    NicDevice->BulkInbuf = NULL;
+    NicDevice->TxTest = NULL;
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                              TPL_CALLBACK,
+                              Ax88772RxTimer,
+                              NicDevice,
+                              &NicDevice->Timer);
+
+  if (EFI_ERROR (Status)) {
+    gBS->FreePool (NicDevice->BulkInbuf);
+    gBS->FreePool (NicDevice->TxTest);
+    gBS->FreePool (NicDevice->RxRing);
+    NicDevice->BulkInbuf = NULL;
+    NicDevice->TxTest = NULL;
+    NicDevice->RxRing = NULL;
     return Status;
   }
 
@@ -1340,6 +1380,7 @@ SN_Shutdown (
   EFI_SIMPLE_NETWORK_MODE *Mode;
   UINT32                  RxFilter;
   EFI_STATUS              Status;
+  NIC_DEVICE              *NicDevice;
   EFI_TPL                 TplPrevious;
 
   TplPrevious = gBS->RaiseTPL(TPL_CALLBACK);
@@ -1355,6 +1396,11 @@ SN_Shutdown (
       //
       // Stop the adapter
       //
+      NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
+      gBS->SetTimer (NicDevice->Timer, TimerCancel, 0);
+      NicDevice->RxPollPeriod = 0;
+      NicDevice->RxRingCount = 0;
+
       RxFilter = Mode->ReceiveFilterSetting;
       Mode->ReceiveFilterSetting = 0;
       Status = SN_Reset (SimpleNetwork, FALSE);
@@ -1552,6 +1598,11 @@ SN_Transmit (
         }
         if (EFI_SUCCESS == Status && EFI_SUCCESS == TransferStatus) {
           NicDevice->TxBuffer = Buffer;
+
+          //
+          //  A reply is likely, poll quickly again
+          //
+          Ax88772RxPollPeriodSet (NicDevice, RX_POLL_PERIOD);
         } else {
           if (EFI_DEVICE_ERROR == Status) {
             SN_Reset (SimpleNetwork, FALSE);
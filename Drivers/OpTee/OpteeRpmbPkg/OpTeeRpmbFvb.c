@@ -92,6 +92,183 @@ ReadWriteRpmb (
   return Status;
 }
 
+/**
+  Write the dirty ranges of the in-memory copy to the RPMB, oldest first.
+
+  Ranges which could not be written are kept so the next flush retries
+  them.
+
+  @param[in,out] Instance    MEM_INSTANCE pointer describing the device
+
+  @retval    EFI_SUCCESS     All dirty ranges were written
+  @retval    Others          Writing a range failed, see ReadWriteRpmb()
+**/
+STATIC
+EFI_STATUS
+FlushDirtyRanges (
+  IN OUT MEM_INSTANCE *Instance
+  )
+{
+  EFI_STATUS        Status;
+  RPMB_DIRTY_RANGE  *Range;
+  UINTN             Index;
+
+  for (Index = 0; Index < Instance->DirtyCount; Index++) {
+    Range = &Instance->Dirty[Index];
+    Status = ReadWriteRpmb (
+               SP_SVC_RPMB_WRITE,
+               (UINTN)Instance->MemBaseAddress + Range->Start,
+               Range->End - Range->Start,
+               Range->Start
+               );
+    if (EFI_ERROR (Status)) {
+      CopyMem (
+        &Instance->Dirty[0],
+        Range,
+        (Instance->DirtyCount - Index) * sizeof (RPMB_DIRTY_RANGE)
+        );
+      Instance->DirtyCount -= Index;
+      return Status;
+    }
+  }
+
+  Instance->DirtyCount = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Record that a range of the in-memory copy is about to be modified.
+
+  This must be called before the in-memory copy is updated. Ranges are
+  kept exact to the byte, OP-TEE merges partial RPMB data frames itself.
+
+  A range that starts exactly where the most recent dirty range ends is
+  merged into it. A multi-block RPMB write goes out in ascending address
+  order, so even a torn write keeps the order of the FVB writes.
+
+  A range that overlaps a dirty range rewrites data written earlier, e.g.
+  a variable or FTW State byte committing the data before it. Merging it
+  could let the commit reach the RPMB before the data, so the journal is
+  flushed first and the caller has to flush the new range as soon as the
+  in-memory copy is updated, making the commit durable before the FVB
+  call returns.
+
+  A flush of the root MMI handler that failed is retried first, so the
+  failure is reported to the next caller instead of being lost.
+
+  @param[in,out] Instance    MEM_INSTANCE pointer describing the device
+  @param[in]     Offset      Offset of the range in the firmware volume
+  @param[in]     NumBytes    Size of the range in bytes
+  @param[out]    Commit      TRUE if the caller must flush the journal
+                             after updating the in-memory copy
+
+  @retval    EFI_SUCCESS     The range was recorded
+  @retval    Others          Flushing the journal failed
+**/
+STATIC
+EFI_STATUS
+MarkDirty (
+  IN OUT MEM_INSTANCE *Instance,
+  IN     UINTN        Offset,
+  IN     UINTN        NumBytes,
+  OUT    BOOLEAN      *Commit
+  )
+{
+  EFI_STATUS        Status;
+  RPMB_DIRTY_RANGE  *Last;
+  UINTN             End;
+  UINTN             Index;
+  BOOLEAN           Barrier;
+
+  *Commit = FALSE;
+  if (NumBytes == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (Instance->FlushStatus)) {
+    Status = FlushDirtyRanges (Instance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    Instance->FlushStatus = EFI_SUCCESS;
+  }
+
+  End = Offset + NumBytes;
+
+  for (Index = 0; Index < Instance->DirtyCount; Index++) {
+    if ((Offset < Instance->Dirty[Index].End) &&
+        (End > Instance->Dirty[Index].Start)) {
+      *Commit = TRUE;
+      break;
+    }
+  }
+
+  if (!*Commit && (Instance->DirtyCount > 0)) {
+    Last = &Instance->Dirty[Instance->DirtyCount - 1];
+    if (Offset == Last->End) {
+      Last->End = End;
+      return EFI_SUCCESS;
+    }
+  }
+
+  Barrier = *Commit || (Instance->DirtyCount == RPMB_JOURNAL_ENTRIES);
+  if (Barrier) {
+    Status = FlushDirtyRanges (Instance);
+    if (EFI_ERROR (Status)) {
+      *Commit = FALSE;
+      return Status;
+    }
+  }
+
+  Instance->Dirty[Instance->DirtyCount].Start = Offset;
+  Instance->Dirty[Instance->DirtyCount].End   = End;
+  Instance->DirtyCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Root MMI handler writing the dirty ranges to the RPMB.
+
+  Every variable update, reclaim and the ExitBootServices notification is
+  handled within a single MMI, and root handlers run after the MMI's own
+  handler. Flushing here makes the FVB writes of an MMI reach the RPMB
+  before control returns to the normal world, with one RPMB transaction
+  per coalesced range instead of one per Write() call.
+
+  The FVB calls have already returned at this point. A failure is kept in
+  FlushStatus and the ranges stay in the journal, so the next Write() or
+  EraseBlocks() retries them and fails if the RPMB is still not writable.
+
+  @param[in]     DispatchHandle  The unique handle assigned to this handler
+  @param[in]     Context         Not used
+  @param[in,out] CommBuffer      Not used
+  @param[in,out] CommBufferSize  Not used
+
+  @retval    EFI_WARN_INTERRUPT_SOURCE_PENDING  Let other handlers run
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+OpTeeRpmbFvbMmiHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context        OPTIONAL,
+  IN OUT VOID        *CommBuffer     OPTIONAL,
+  IN OUT UINTN       *CommBufferSize OPTIONAL
+  )
+{
+  EFI_STATUS Status;
+
+  Status = FlushDirtyRanges (&mInstance);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %u ranges not written to RPMB: %r\n",
+      __func__, (UINT32)mInstance.DirtyCount, Status));
+  }
+  mInstance.FlushStatus = Status;
+
+  return EFI_WARN_INTERRUPT_SOURCE_PENDING;
+}
+
 /**
   The GetAttributes() function retrieves the attributes and
   current settings of the block.
@@ -300,6 +477,12 @@ OpTeeRpmbFvbRead (
 /**
   Writes the specified number of bytes from the input buffer to the block.
 
+  Only the in-memory copy is updated here and the range is recorded as
+  dirty. Dirty ranges are coalesced and written to the RPMB by the root
+  MMI handler before the MMI which issued the write returns. A write that
+  overlaps a dirty range commits earlier data and is written to the RPMB
+  before returning, see MarkDirty().
+
   The Write() function writes the specified number of bytes from
   the provided buffer to the specified block and offset. If the
   firmware volume is sticky write, the caller must ensure that
@@ -362,6 +545,7 @@ OpTeeRpmbFvbWrite (
   MEM_INSTANCE *Instance;
   EFI_STATUS   Status;
   VOID         *Base;
+  BOOLEAN      Commit;
 
   Instance = INSTANCE_FROM_FVB_THIS (This);
   if (!Instance->Initialized) {
@@ -372,11 +556,11 @@ OpTeeRpmbFvbWrite (
   }
   Base = (VOID *)(UINTN)Instance->MemBaseAddress + (Lba * Instance->BlockSize) +
          Offset;
-  Status = ReadWriteRpmb (
-             SP_SVC_RPMB_WRITE,
-             (UINTN)Buffer,
+  Status = MarkDirty (
+             Instance,
+             (Lba * Instance->BlockSize) + Offset,
              *NumBytes,
-             (Lba * Instance->BlockSize) + Offset
+             &Commit
              );
   if (EFI_ERROR (Status)) {
     return Status;
@@ -385,12 +569,20 @@ OpTeeRpmbFvbWrite (
   // Update the memory copy
   CopyMem (Base, Buffer, *NumBytes);
 
+  if (Commit) {
+    Status = FlushDirtyRanges (Instance);
+  }
+
   return Status;
 }
 
 /**
   Erases and initializes a firmware volume block.
 
+  As for Write(), only the in-memory copy is erased here and the blocks
+  reach the RPMB with the next flush of the dirty ranges, unless they
+  overlap a dirty range.
+
   The EraseBlocks() function erases one or more blocks as denoted
   by the variable argument list. The entire parameter list of
   blocks must be verified before erasing any blocks. If a block is
@@ -446,9 +638,9 @@ OpTeeRpmbFvbErase (
   UINTN   NumLba;
   EFI_LBA Start;
   VOID    *Base;
-  VOID    *Buf;
   VA_LIST Args;
   EFI_STATUS Status;
+  BOOLEAN Commit;
 
   Instance = INSTANCE_FROM_FVB_THIS (This);
 
@@ -463,25 +655,19 @@ OpTeeRpmbFvbErase (
     NumBytes = NumLba * Instance->BlockSize;
     Base = (VOID *)(UINTN)Instance->MemBaseAddress +
            (Start * Instance->BlockSize);
-    Buf = AllocatePool (NumLba * Instance->BlockSize);
-    if (Buf == NULL) {
-      return EFI_DEVICE_ERROR;
-    }
-    SetMem64 (Buf, NumLba * Instance->BlockSize, ~0UL);
-    // Write the device
-    Status = ReadWriteRpmb (
-               SP_SVC_RPMB_WRITE,
-               (UINTN)Buf,
-               NumBytes,
-               Start * Instance->BlockSize
-               );
+    Status = MarkDirty (Instance, Start * Instance->BlockSize, NumBytes, &Commit);
     if (EFI_ERROR (Status)) {
-      FreePool (Buf);
       return Status;
     }
     // Update the in memory copy
     SetMem64 (Base, NumLba * Instance->BlockSize, ~0UL);
-    FreePool (Buf);
+
+    if (Commit) {
+      Status = FlushDirtyRanges (Instance);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
   }
 
   VA_END (Args);
@@ -794,6 +980,7 @@ OpTeeRpmbFvbInit (
   VOID         *Addr;
   UINTN        FvLength;
   UINTN        NBlocks;
+  EFI_HANDLE   DispatchHandle;
 
   FvLength = PcdGet32 (PcdFlashNvStorageVariableSize) +
              PcdGet32 (PcdFlashNvStorageFtwWorkingSize) +
@@ -843,6 +1030,14 @@ OpTeeRpmbFvbInit (
                     );
   ASSERT_EFI_ERROR (Status);
 
+  // Write the ranges dirtied by an MMI before it returns
+  Status = gMmst->MmiHandlerRegister (
+                    OpTeeRpmbFvbMmiHandler,
+                    NULL,
+                    &DispatchHandle
+                    );
+  ASSERT_EFI_ERROR (Status);
+
   DEBUG ((DEBUG_INFO, "%a: Register OP-TEE RPMB Fvb\n", __func__));
   DEBUG ((DEBUG_INFO, "%a: Using NV store FV in-memory copy at 0x%lx\n",
     __func__, PatchPcdGet64 (PcdFlashNvStorageVariableBase64)));
@@ -26,9 +26,25 @@
 #define INSTANCE_FROM_FVB_THIS(a)  CR (a, MEM_INSTANCE, FvbProtocol, \
                                       FLASH_SIGNATURE)
 
+/**
+ Maximum number of dirty ranges held before the journal is flushed
+**/
+#define RPMB_JOURNAL_ENTRIES       16
+
 typedef struct _MEM_INSTANCE         MEM_INSTANCE;
 typedef EFI_STATUS (*MEM_INITIALIZE) (MEM_INSTANCE* Instance);
 
+/**
+  A range of the in-memory copy which has not been written to the RPMB
+  yet.
+**/
+typedef struct {
+    /// Offset of the first dirty byte
+    UINTN                               Start;
+    /// Offset following the last dirty byte
+    UINTN                               End;
+} RPMB_DIRTY_RANGE;
+
 /**
   This struct is used by the RPMB driver. Since the upper EDK2 layers
   expect byte addressable memory, we allocate a memory area of certain
@@ -52,6 +68,12 @@ struct _MEM_INSTANCE
     UINT16                              BlockSize;
     /// Number of allocated blocks
     UINT16                              NBlocks;
+    /// Dirty ranges in the order they have to reach the RPMB
+    RPMB_DIRTY_RANGE                    Dirty[RPMB_JOURNAL_ENTRIES];
+    /// Number of valid entries in Dirty
+    UINTN                               DirtyCount;
+    /// Result of the last flush done by the root MMI handler
+    EFI_STATUS                          FlushStatus;
 };
 
 #endif
@@ -58,6 +58,72 @@ Rand32 (
 }
 
 
+#define BENCHMARK_FRAMES  16
+
+/**
+  Time full screen blt operations and print the average number of
+  timestamp ticks per frame for each of them.
+
+**/
+VOID
+BenchmarkBlt (
+  VOID
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Buffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Color;
+  UINTN                          Width;
+  UINTN                          Height;
+  UINTN                          Loop;
+  UINT64                         Start;
+  UINT64                         Fill;
+  UINT64                         ToVideo;
+  UINT64                         FromVideo;
+
+  BltLibGetSizes (&Width, &Height);
+
+  Status = gBS->AllocatePool (
+                  EfiBootServicesData,
+                  Width * Height * sizeof (*Buffer),
+                  (VOID **) &Buffer
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  for (Loop = 0; Loop < Width * Height; Loop++) {
+    *(UINT32*) &Buffer[Loop] = (UINT32) (Loop * 0x010203);
+  }
+
+  Start = ReadTimestamp ();
+  for (Loop = 0; Loop < BENCHMARK_FRAMES; Loop++) {
+    *(UINT32*) (&Color) = (UINT32) (Loop * 0x102030);
+    BltLibVideoFill (&Color, 0, 0, Width, Height);
+  }
+  Fill = ReadTimestamp () - Start;
+
+  Start = ReadTimestamp ();
+  for (Loop = 0; Loop < BENCHMARK_FRAMES; Loop++) {
+    BltLibBufferToVideo (Buffer, 0, 0, Width, Height);
+  }
+  ToVideo = ReadTimestamp () - Start;
+
+  Start = ReadTimestamp ();
+  for (Loop = 0; Loop < BENCHMARK_FRAMES; Loop++) {
+    BltLibVideoToBltBuffer (Buffer, 0, 0, Width, Height);
+  }
+  FromVideo = ReadTimestamp () - Start;
+
+  Print (L"%dx%d, ticks per frame:\n", Width, Height);
+  Print (L"  VideoFill:        %ld\n", DivU64x32 (Fill, BENCHMARK_FRAMES));
+  Print (L"  BufferToVideo:    %ld\n", DivU64x32 (ToVideo, BENCHMARK_FRAMES));
+  Print (L"  VideoToBltBuffer: %ld\n", DivU64x32 (FromVideo, BENCHMARK_FRAMES));
+
+  gBS->FreePool (Buffer);
+}
+
+
 VOID
 TestFills (
   VOID
@@ -271,6 +337,8 @@ UefiMain (
     return Status;
   }
 
+  BenchmarkBlt ();
+
   TestFills ();
 
   TestColor ();
@@ -204,110 +204,194 @@ SetStatusInternal (
 }
 
 /**
-  Initiates a read operation on the Usb Serial Device.
+  Moves the data returned by a bulk-in transfer into the receive buffer.
+
+  The device prefixes each packet of a transfer with its own pair of status
+  bytes, so they are stripped per packet rather than once per transfer.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+  @param  PacketSize[in]       The max packet size of the bulk-in endpoint
+  @param  Data[in]             The data returned by the bulk-in transfer
+  @param  Length[in]           The number of bytes in Data
+
+**/
+STATIC
+VOID
+StoreReceivedData (
+  IN USB_SER_DEV  *UsbSerialDevice,
+  IN UINTN        PacketSize,
+  IN UINT8        *Data,
+  IN UINTN        Length
+  )
+{
+  UINTN  Offset;
+  UINTN  End;
+  UINTN  Index;
+
+  for (Offset = 0; Offset + FTDI_STATUS_BYTES <= Length; Offset += PacketSize) {
+    //
+    // update the statusvalue field of the usbserialdevice
+    //
+    SetStatusInternal (UsbSerialDevice, &Data[Offset]);
+
+    End = MIN (Offset + PacketSize, Length);
+    for (Index = Offset + FTDI_STATUS_BYTES; Index < End; Index++) {
+      if (((UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH) == UsbSerialDevice->DataBufferHead) {
+        return;
+      }
+      if (Data[Index] == 0x00) {
+        //
+        // This is null, do not add
+        //
+      } else {
+        UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferTail] = Data[Index];
+        UsbSerialDevice->DataBufferTail = (UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH;
+      }
+    }
+  }
+}
+
+/**
+  Reads the data the Usb Serial Device has received into the internal buffer.
+
+  Only as many packets as the internal buffer can absorb are requested. Data
+  beyond that stays queued in the device, which applies flow control on the
+  line. Reading continues for as long as the device returns full transfers.
 
   @param  UsbSerialDevice[in]        Handle to the USB device to read
-  @param  BufferSize[in, out]        On input, the size of the Buffer. On output,
-                                     the amount of data returned in Buffer.
-                                     Setting this to zero will initiate a read
-                                     and store all data returned in the internal
-                                     buffer.
-  @param  Buffer [out]               The buffer to return the data into.
 
   @retval EFI_SUCCESS                The data was read.
   @retval EFI_DEVICE_ERROR           The device reported an error.
-  @retval EFI_TIMEOUT                The data write was stopped due to a timeout.
+  @retval EFI_TIMEOUT                The data read was stopped due to a timeout.
 
 **/
 EFI_STATUS
 EFIAPI
 ReadDataFromUsb (
-  IN USB_SER_DEV  *UsbSerialDevice,
-  IN OUT UINTN    *BufferSize,
-  OUT VOID        *Buffer
+  IN USB_SER_DEV  *UsbSerialDevice
   )
 {
   EFI_STATUS  Status;
+  UINTN       PacketSize;
+  UINTN       RequestSize;
   UINTN       ReadBufferSize;
-  UINT8       *ReadBuffer;
-  UINTN       Index;
+  UINT32      FreeSpace;
   EFI_TPL     Tpl;
-  UINT8       StatusBuffer[2]; // buffer to store the status bytes
-
-  ReadBufferSize = 512;
-  ReadBuffer     = &(UsbSerialDevice->ReadBuffer[0]);
 
   if (UsbSerialDevice->Shutdown) {
     return EFI_DEVICE_ERROR;
   }
 
+  PacketSize = UsbSerialDevice->InEndpointDescriptor.MaxPacketSize;
+  if ((PacketSize <= FTDI_STATUS_BYTES) || (PacketSize > sizeof (UsbSerialDevice->ReadBuffer))) {
+    PacketSize = sizeof (UsbSerialDevice->ReadBuffer);
+  }
+
   Tpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-  Status = UsbSerialDataTransfer (
-             UsbSerialDevice,
-             EfiUsbDataIn,
-             ReadBuffer,
-             &ReadBufferSize,
-             FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
-             );
+  do {
+    FreeSpace = (UsbSerialDevice->DataBufferHead + SW_FIFO_DEPTH - UsbSerialDevice->DataBufferTail - 1) % SW_FIFO_DEPTH;
+    RequestSize = MIN (
+                    FreeSpace / (PacketSize - FTDI_STATUS_BYTES),
+                    sizeof (UsbSerialDevice->ReadBuffer) / PacketSize
+                    ) * PacketSize;
+    if (RequestSize == 0) {
+      Status = EFI_SUCCESS;
+      break;
+    }
+
+    ReadBufferSize = RequestSize;
+    Status = UsbSerialDataTransfer (
+               UsbSerialDevice,
+               EfiUsbDataIn,
+               UsbSerialDevice->ReadBuffer,
+               &ReadBufferSize,
+               FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    StoreReceivedData (UsbSerialDevice, PacketSize, UsbSerialDevice->ReadBuffer, ReadBufferSize);
+  } while (ReadBufferSize == RequestSize);
+
+  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
+    UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  } else {
+    UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
+  }
+
+  gBS->RestoreTPL (Tpl);
+
   if (EFI_ERROR (Status)) {
-    gBS->RestoreTPL (Tpl);
     if (Status == EFI_TIMEOUT) {
       return EFI_TIMEOUT;
     } else {
       return EFI_DEVICE_ERROR;
     }
   }
+  return EFI_SUCCESS;
+}
 
-  //
-  // Store the status bytes in the status buffer
-  //
-  for (Index = 0; Index < 2; Index++) {//only the first 2 bytes are status bytes
-    StatusBuffer[Index] = ReadBuffer[Index];
-  }
-  //
-  // update the statusvalue field of the usbserialdevice
-  //
-  Status = SetStatusInternal (UsbSerialDevice, StatusBuffer);
-  if (Status != EFI_SUCCESS) {
-  }
+/**
+  Sends the data coalesced in the transmit buffer to the Usb Serial Device.
 
-  //
-  // Store the read data in the read buffer, start at 2 to ignore status bytes
-  //
-  for (Index = 2; Index < ReadBufferSize; Index++) {
-    if (((UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH) == UsbSerialDevice->DataBufferHead) {
-      break;
-    }
-    if (ReadBuffer[Index] == 0x00) {
-      //
-      // This is null, do not add
-      //
-    } else {
-      UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferTail] = ReadBuffer[Index];
-      UsbSerialDevice->DataBufferTail = (UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH;
-    }
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+
+  @retval EFI_SUCCESS          The transmit buffer was emptied.
+  @retval EFI_TIMEOUT          The device did not take all of the data in time.
+                               The remainder is kept for the next flush.
+  @retval EFI_DEVICE_ERROR     The device reported an error. The buffered data
+                               is discarded.
+
+**/
+STATIC
+EFI_STATUS
+FlushTxBuffer (
+  IN USB_SER_DEV  *UsbSerialDevice
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+  EFI_TPL     Tpl;
+
+  if (UsbSerialDevice->Shutdown) {
+    UsbSerialDevice->TxLength = 0;
+    return EFI_DEVICE_ERROR;
   }
 
-  //
-  // Read characters out of the buffer to satisfy caller's request.
-  //
-  for (Index = 0; Index < *BufferSize; Index++) {
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      break;
-    }
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Length = UsbSerialDevice->TxLength;
+  Status = UsbSerialDataTransfer (
+             UsbSerialDevice,
+             EfiUsbDataOut,
+             UsbSerialDevice->TxBuffer,
+             &Length,
+             FTDI_TIMEOUT
+             );
+  if (!EFI_ERROR (Status)) {
+    UsbSerialDevice->TxLength = 0;
+  } else if ((Status == EFI_TIMEOUT) || (Status == EFI_NOT_READY)) {
     //
-    // Still have characters in the buffer to return
+    // Keep whatever the device did not accept
     //
-    ((UINT8 *)Buffer)[Index]        = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
-    UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
+    if (Length < UsbSerialDevice->TxLength) {
+      CopyMem (
+        UsbSerialDevice->TxBuffer,
+        &UsbSerialDevice->TxBuffer[Length],
+        UsbSerialDevice->TxLength - Length
+        );
+      UsbSerialDevice->TxLength -= Length;
+    }
+    Status = EFI_TIMEOUT;
+  } else {
+    UsbSerialDevice->TxLength = 0;
+    Status = EFI_DEVICE_ERROR;
   }
-  //
-  // Return actual number of bytes returned.
-  //
-  *BufferSize = Index;
+
   gBS->RestoreTPL (Tpl);
-  return EFI_SUCCESS;
+  return Status;
 }
 
 /**
@@ -362,8 +446,9 @@ SetInitialStatus (
 
 /**
   UsbSerialDriverCheckInput.
-  attempts to read data in from the device periodically, stores any read data
-  and updates the control attributes.
+  periodically sends any data waiting in the transmit buffer, then reads the
+  data the device has received into the receive buffer and updates the control
+  attributes.
 
   @param  Event[in]
   @param  Context[in]....The current instance of the USB serial device
@@ -376,36 +461,14 @@ UsbSerialDriverCheckInput (
   IN  VOID       *Context
   )
 {
-  UINTN        BufferSize;
   USB_SER_DEV  *UsbSerialDevice;
 
   UsbSerialDevice = (USB_SER_DEV*)Context;
 
-  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-    //
-    // Data buffer is empty, try to read from device
-    //
-    BufferSize = 0;
-    ReadDataFromUsb (UsbSerialDevice, &BufferSize, NULL);
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      //
-      // Data buffer still has no data, set the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
-    } else {
-      //
-      // Read has returned some data, clear the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
-    }
-  } else {
-    //
-    // Data buffer has data, no read attempt required
-    //
-    UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
+  if (UsbSerialDevice->TxLength != 0) {
+    FlushTxBuffer (UsbSerialDevice);
   }
+  ReadDataFromUsb (UsbSerialDevice);
 }
 
 /**
@@ -1039,6 +1102,52 @@ StatusError:
   }
 }
 
+/**
+  Internal function that performs a Usb Control Transfer to set the latency
+  timer of the Usb Serial Device.
+
+  @param  UsbIo[in]                  Usb Io Protocol instance pointer
+  @param  Latency[in]                The time in ms the device waits before
+                                     returning a partially filled packet
+
+  @retval EFI_SUCCESS                The latency timer was set on the Usb Serial
+                                     Device
+  @retval EFI_DEVICE_ERROR           The device is not functioning correctly
+
+**/
+EFI_STATUS
+EFIAPI
+SetLatencyTimerInternal (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                Latency
+  )
+{
+  EFI_STATUS              Status;
+  EFI_USB_DEVICE_REQUEST  DevReq;
+  UINT32                  ReturnValue;
+  UINT8                   ConfigurationValue;
+
+  DevReq.Request      = FTDI_COMMAND_SET_LATENCY_TIMER;
+  DevReq.RequestType  = USB_REQ_TYPE_VENDOR;
+  DevReq.Value        = Latency;
+  DevReq.Index        = FTDI_PORT_IDENTIFIER;
+  DevReq.Length       = 0; // indicates that there is no data phase in this transfer
+
+  Status = UsbIo->UsbControlTransfer (
+                    UsbIo,
+                    &DevReq,
+                    EfiUsbDataOut,
+                    WDR_SHORT_TIMEOUT,
+                    &ConfigurationValue,
+                    1,
+                    &ReturnValue
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return Status;
+}
+
 /**
   Internal function that performs a Usb Control Transfer to set the Dtr value on
   the Usb Serial Device.
@@ -1344,11 +1453,12 @@ GetControlBitsInternal (
     *Control |= EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE;
   }
   //
-  // check if the buffer is empty since only one is being used if it is empty
-  // set both the receive and transmit buffers to empty
+  // check if the receive and transmit buffers are empty
   //
-  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
+  if (UsbSerialDevice->TxLength == 0) {
     *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
     *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
   }
   //
@@ -1421,6 +1531,13 @@ ResetInternal (
   if (EFI_ERROR (Status)) {
     return EFI_DEVICE_ERROR;
   }
+
+  //
+  // Drop the data held in the driver's receive and transmit buffers as well
+  //
+  UsbSerialDevice->DataBufferHead = 0;
+  UsbSerialDevice->DataBufferTail = 0;
+  UsbSerialDevice->TxLength       = 0;
   return Status;
 }
 
@@ -1936,6 +2053,12 @@ UsbSerialDriverBindingStart (
 
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Shorten the latency timer so that polling an idle line returns quickly.
+  // Failure only makes polling slower, so it is not fatal.
+  //
+  SetLatencyTimerInternal (UsbSerialDevice->UsbIo, FTDI_LATENCY_TIMER);
+
   //
   // Publish Serial GUID and protocol
   //
@@ -1974,6 +2097,7 @@ UsbSerialDriverBindingStart (
   //
   UsbSerialDevice->DataBufferHead = 0;
   UsbSerialDevice->DataBufferTail = 0;
+  UsbSerialDevice->TxLength       = 0;
 
   UsbSerialDevice->ControllerNameTable = NULL;
   AddUnicodeString2 (
@@ -1995,7 +2119,8 @@ UsbSerialDriverBindingStart (
   ASSERT_EFI_ERROR (Status);
 
   //
-  // Create a polling loop to check for input
+  // Create a polling loop to fill the receive buffer and flush the transmit
+  // buffer
   //
 
   gBS->CreateEvent (
@@ -2005,14 +2130,10 @@ UsbSerialDriverBindingStart (
          UsbSerialDevice,
          &(UsbSerialDevice->PollingLoop)
          );
-  //
-  // add code to set trigger time based on baud rate
-  // setting to 0.5s for now
-  //
   gBS->SetTimer (
          UsbSerialDevice->PollingLoop,
          TimerPeriodic,
-         EFI_TIMER_PERIOD_MILLISECONDS (500)
+         EFI_TIMER_PERIOD_MILLISECONDS (FTDI_POLL_INTERVAL)
          );
 
   //
@@ -2218,6 +2339,7 @@ UsbSerialDriverBindingStop (
                0
                );
         gBS->CloseEvent (UsbSerialDevice->PollingLoop);
+        FlushTxBuffer (UsbSerialDevice);
         UsbSerialDevice->Shutdown = TRUE;
         FreeUnicodeStringTable (UsbSerialDevice->ControllerNameTable);
         FreePool (UsbSerialDevice->DataBuffer);
@@ -2462,9 +2584,9 @@ ReadSerialIo (
   )
 {
   UINTN        Index;
-  UINTN        RemainingCallerBufferSize;
   USB_SER_DEV  *UsbSerialDevice;
   EFI_STATUS   Status;
+  EFI_TPL      Tpl;
 
 
   if (*BufferSize == 0) {
@@ -2478,9 +2600,18 @@ ReadSerialIo (
   Status          = EFI_SUCCESS;
   UsbSerialDevice = USB_SER_DEV_FROM_THIS (This);
 
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   //
-  // Clear out any data that we already have in our internal buffer
+  // The polling loop keeps the internal buffer filled. Only go to the device
+  // directly when the buffer is empty and the loop cannot run at the caller's
+  // TPL.
   //
+  if ((UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) &&
+      (Tpl >= TPL_CALLBACK)) {
+    Status = ReadDataFromUsb (UsbSerialDevice);
+  }
+
   for (Index = 0; Index < *BufferSize; Index++) {
     if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
       break;
@@ -2492,25 +2623,7 @@ ReadSerialIo (
     ((UINT8 *)Buffer)[Index] = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
     UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
   }
-
-  //
-  // If we haven't filled the caller's buffer using data that we already had on
-  // hand We need to generate an additional USB request to try and fill the
-  // caller's buffer
-  //
-  if (Index != *BufferSize) {
-    RemainingCallerBufferSize = *BufferSize - Index;
-    Status = ReadDataFromUsb (
-               UsbSerialDevice,
-               &RemainingCallerBufferSize,
-               (VOID *)(((CHAR8 *)Buffer) + Index)
-               );
-    if (!EFI_ERROR (Status)) {
-      *BufferSize = RemainingCallerBufferSize + Index;
-    } else {
-      *BufferSize = Index;
-    }
-  }
+  *BufferSize = Index;
 
   if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
     //
@@ -2523,6 +2636,8 @@ ReadSerialIo (
     //
     UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
   }
+
+  gBS->RestoreTPL (Tpl);
   return Status;
 }
 
@@ -2550,6 +2665,8 @@ WriteSerialIo (
   EFI_STATUS   Status;
   USB_SER_DEV  *UsbSerialDevice;
   EFI_TPL      Tpl;
+  UINTN        Written;
+  UINTN        Count;
 
   UsbSerialDevice = USB_SER_DEV_FROM_THIS (This);
 
@@ -2559,22 +2676,49 @@ WriteSerialIo (
 
   Tpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-  Status = UsbSerialDataTransfer (
-             UsbSerialDevice,
-             EfiUsbDataOut,
-             Buffer,
-             BufferSize,
-             FTDI_TIMEOUT
-             );
+  //
+  // Coalesce the data into the transmit buffer, sending it on to the device
+  // whenever the buffer fills up
+  //
+  Status  = EFI_SUCCESS;
+  Written = 0;
+  while (Written < *BufferSize) {
+    if (UsbSerialDevice->TxLength == TX_BUFFER_SIZE) {
+      Status = FlushTxBuffer (UsbSerialDevice);
+      if ((Status == EFI_DEVICE_ERROR) ||
+          (UsbSerialDevice->TxLength == TX_BUFFER_SIZE)) {
+        break;
+      }
+    }
 
-  gBS->RestoreTPL (Tpl);
-  if (EFI_ERROR (Status)) {
-    if (Status == EFI_TIMEOUT){
-      return Status;
-    } else {
-      return EFI_DEVICE_ERROR;
+    Count = MIN (*BufferSize - Written, TX_BUFFER_SIZE - UsbSerialDevice->TxLength);
+    CopyMem (
+      &UsbSerialDevice->TxBuffer[UsbSerialDevice->TxLength],
+      (UINT8 *)Buffer + Written,
+      Count
+      );
+    UsbSerialDevice->TxLength += Count;
+    Written                   += Count;
+  }
+
+  if (Written == *BufferSize) {
+    Status = EFI_SUCCESS;
+    //
+    // The polling loop flushes the rest within FTDI_POLL_INTERVAL, but it
+    // cannot run while the caller is at or above its TPL
+    //
+    if (Tpl >= TPL_CALLBACK) {
+      Status = FlushTxBuffer (UsbSerialDevice);
+      if (Status == EFI_TIMEOUT) {
+        //
+        // The data is accepted, the remainder is retried by the next flush
+        //
+        Status = EFI_SUCCESS;
+      }
     }
   }
+  *BufferSize = Written;
 
-  return EFI_SUCCESS;
+  gBS->RestoreTPL (Tpl);
+  return Status;
 }
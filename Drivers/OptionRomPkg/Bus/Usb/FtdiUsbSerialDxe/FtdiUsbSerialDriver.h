@@ -161,6 +161,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define FTDI_MAX_RECEIVE_FIFO_DEPTH  384
 
+//
+// Every bulk-in packet from the FTDI device starts with 2 status bytes
+//
+#define FTDI_STATUS_BYTES  2
+
+//
+// Time in ms the device holds back a partially filled bulk-in packet. The
+// power-on default of 16 ms makes every poll of an idle line block that long.
+//
+#define FTDI_LATENCY_TIMER  2
+
+//
+// Period in ms of the polling loop that fills the receive buffer and flushes
+// the transmit buffer, which bounds how long small writes are held back
+//
+#define FTDI_POLL_INTERVAL  10
+
 //
 // FTDI Endpoint Descriptors
 //
@@ -172,6 +189,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define SW_FIFO_DEPTH 1024
 
+//
+// Size of the buffer used to coalesce small writes into larger bulk transfers
+//
+#define TX_BUFFER_SIZE  512
+
 //
 // struct to define a usb device as a vendor and product id pair
 //
@@ -245,6 +267,8 @@ typedef struct {
   CONTROL_BITS                  ControlValues;
   STATUS_BITS                   StatusValues;
   UINT8                         ReadBuffer[512];
+  UINTN                         TxLength;
+  UINT8                         TxBuffer[TX_BUFFER_SIZE];
 } USB_SER_DEV;
 
 #define USB_SER_DEV_FROM_THIS(a) \
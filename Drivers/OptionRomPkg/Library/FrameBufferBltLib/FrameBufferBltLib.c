@@ -33,6 +33,132 @@ INTN                            mPixelShl[4]; // R-G-B-Rsvd
 INTN                            mPixelShr[4]; // R-G-B-Rsvd
 
 
+/**
+  Convert a line of Blt pixels to the frame buffer pixel format.
+
+  The common RGBX layout only needs the red and blue bytes swapped, and is
+  converted one 32-bit pixel at a time. Other bitmask formats go through the
+  generic shift and mask conversion, with the masks and shifts held in locals
+  so that they are not reloaded for every pixel.
+
+  @param[out] Dst    Destination in frame buffer format
+  @param[in]  Src    Source Blt pixels
+  @param[in]  Width  Number of pixels
+
+**/
+STATIC
+VOID
+BltLibConvertToVideo (
+  OUT UINT8                                 *Dst,
+  IN  CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Src,
+  IN  UINTN                                 Width
+  )
+{
+  CONST UINT32  *Src32;
+  UINT32        *Dst32;
+  UINT32        Uint32;
+  UINT32        RedMask;
+  UINT32        GreenMask;
+  UINT32        BlueMask;
+  INTN          Shl[3];
+  INTN          Shr[3];
+  UINTN         BytesPerPixel;
+
+  Src32 = (CONST UINT32 *) Src;
+
+  if (mPixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    Dst32 = (UINT32 *) Dst;
+    while (Width-- > 0) {
+      Uint32 = *Src32++;
+      *Dst32++ = ((Uint32 & 0xff) << 16) | (Uint32 & 0xff00) | ((Uint32 >> 16) & 0xff);
+    }
+    return;
+  }
+
+  RedMask       = mPixelBitMasks.RedMask;
+  GreenMask     = mPixelBitMasks.GreenMask;
+  BlueMask      = mPixelBitMasks.BlueMask;
+  Shl[0]        = mPixelShl[0];
+  Shl[1]        = mPixelShl[1];
+  Shl[2]        = mPixelShl[2];
+  Shr[0]        = mPixelShr[0];
+  Shr[1]        = mPixelShr[1];
+  Shr[2]        = mPixelShr[2];
+  BytesPerPixel = mBltLibBytesPerPixel;
+
+  while (Width-- > 0) {
+    Uint32 = *Src32++;
+    *(UINT32*) Dst =
+      (UINT32) (
+          (((Uint32 << Shl[0]) >> Shr[0]) & RedMask) |
+          (((Uint32 << Shl[1]) >> Shr[1]) & GreenMask) |
+          (((Uint32 << Shl[2]) >> Shr[2]) & BlueMask)
+        );
+    Dst += BytesPerPixel;
+  }
+}
+
+
+/**
+  Convert a line of frame buffer pixels to Blt pixels.
+
+  @param[out] Dst    Destination Blt pixels
+  @param[in]  Src    Source in frame buffer format
+  @param[in]  Width  Number of pixels
+
+**/
+STATIC
+VOID
+BltLibConvertFromVideo (
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL         *Dst,
+  IN  CONST UINT8                           *Src,
+  IN  UINTN                                 Width
+  )
+{
+  UINT32        *Dst32;
+  UINT32        Uint32;
+  UINT32        RedMask;
+  UINT32        GreenMask;
+  UINT32        BlueMask;
+  INTN          Shl[3];
+  INTN          Shr[3];
+  UINTN         BytesPerPixel;
+
+  Dst32 = (UINT32 *) Dst;
+
+  if (mPixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    while (Width-- > 0) {
+      Uint32 = *(CONST UINT32 *) Src;
+      *Dst32++ = ((Uint32 & 0xff) << 16) | (Uint32 & 0xff00) | ((Uint32 >> 16) & 0xff);
+      Src += sizeof (UINT32);
+    }
+    return;
+  }
+
+  RedMask       = mPixelBitMasks.RedMask;
+  GreenMask     = mPixelBitMasks.GreenMask;
+  BlueMask      = mPixelBitMasks.BlueMask;
+  Shl[0]        = mPixelShl[0];
+  Shl[1]        = mPixelShl[1];
+  Shl[2]        = mPixelShl[2];
+  Shr[0]        = mPixelShr[0];
+  Shr[1]        = mPixelShr[1];
+  Shr[2]        = mPixelShr[2];
+  BytesPerPixel = mBltLibBytesPerPixel;
+
+  while (Width-- > 0) {
+    Uint32 = *(CONST UINT32 *) Src;
+    *Dst32++ =
+      (UINT32) (
+          (((Uint32 & RedMask)   >> Shl[0]) << Shr[0]) |
+          (((Uint32 & GreenMask) >> Shl[1]) << Shr[1]) |
+          (((Uint32 & BlueMask)  >> Shl[2]) << Shr[2])
+        );
+    Src += BytesPerPixel;
+  }
+}
+
+
 VOID
 ConfigurePixelBitMaskFormat (
   IN EFI_PIXEL_BITMASK          *BitMask
@@ -328,6 +454,13 @@ BltLibVideoFill (
         if (SizeInBytes > 0) {
           CopyMem (BltMemDst, (VOID*) &WideFill, SizeInBytes);
         }
+      } else if (UseWideFill && (mBltLibBytesPerPixel == 4) && (((UINTN) BltMemDst & 3) == 0)) {
+        //
+        // 32-bit pixels starting at an odd pixel are still 32-bit aligned:
+        // fill them directly instead of copying a prepared line.
+        //
+        VDEBUG ((DEBUG_INFO, "VideoFill (wide, 32-bit)\n"));
+        SetMem32 (BltMemDst, WidthInBytes, (UINT32) WideFill);
       } else {
         VDEBUG ((DEBUG_INFO, "VideoFill (not wide)\n"));
         if (!LineBufferReady) {
@@ -424,8 +557,6 @@ BltLibVideoToBltBufferEx (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Blt;
   VOID                            *BltMemSrc;
   VOID                            *BltMemDst;
-  UINTN                           X;
-  UINT32                          Uint32;
   UINTN                           Offset;
   UINTN                           WidthInBytes;
 
@@ -478,16 +609,8 @@ BltLibVideoToBltBufferEx (
     CopyMem (BltMemDst, BltMemSrc, WidthInBytes);
 
     if (mPixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
-      for (X = 0; X < Width; X++) {
-        Blt         = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (DstY * Delta) + (DestinationX + X) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-        Uint32 = *(UINT32*) (mBltLibLineBuffer + (X * mBltLibBytesPerPixel));
-        *(UINT32*) Blt =
-          (UINT32) (
-              (((Uint32 & mPixelBitMasks.RedMask)   >> mPixelShl[0]) << mPixelShr[0]) |
-              (((Uint32 & mPixelBitMasks.GreenMask) >> mPixelShl[1]) << mPixelShr[1]) |
-              (((Uint32 & mPixelBitMasks.BlueMask)  >> mPixelShl[2]) << mPixelShr[2])
-            );
-      }
+      Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (DstY * Delta) + DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+      BltLibConvertFromVideo (Blt, mBltLibLineBuffer, Width);
     }
   }
 
@@ -568,8 +691,6 @@ BltLibBufferToVideoEx (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Blt;
   VOID                            *BltMemSrc;
   VOID                            *BltMemDst;
-  UINTN                           X;
-  UINT32                          Uint32;
   UINTN                           Offset;
   UINTN                           WidthInBytes;
 
@@ -605,24 +726,20 @@ BltLibBufferToVideoEx (
     Offset = mBltLibBytesPerPixel * Offset;
     BltMemDst = (VOID*) (mBltLibFrameBuffer + Offset);
 
+    Blt =
+      (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) (
+          (UINT8 *) BltBuffer +
+          (SrcY * Delta) +
+          (SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
+        );
     if (mPixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
-      BltMemSrc = (VOID *) ((UINT8 *) BltBuffer + (SrcY * Delta));
+      BltMemSrc = (VOID *) Blt;
     } else {
-      for (X = 0; X < Width; X++) {
-        Blt =
-          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) (
-              (UINT8 *) BltBuffer +
-              (SrcY * Delta) +
-              ((SourceX + X) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
-            );
-        Uint32 = *(UINT32*) Blt;
-        *(UINT32*) (mBltLibLineBuffer + (X * mBltLibBytesPerPixel)) =
-          (UINT32) (
-              (((Uint32 << mPixelShl[0]) >> mPixelShr[0]) & mPixelBitMasks.RedMask) |
-              (((Uint32 << mPixelShl[1]) >> mPixelShr[1]) & mPixelBitMasks.GreenMask) |
-              (((Uint32 << mPixelShl[2]) >> mPixelShr[2]) & mPixelBitMasks.BlueMask)
-            );
-      }
+      //
+      // Convert into the line buffer, then write the frame buffer in
+      // one go rather than one pixel at a time.
+      //
+      BltLibConvertToVideo (mBltLibLineBuffer, Blt, Width);
       BltMemSrc = (VOID *) mBltLibLineBuffer;
     }
 
@@ -50,6 +50,39 @@ Usb3DebugPortWrite (
   IN UINTN     NumberOfBytes
   );
 
+/**
+  Send the debug output pending in the USB3 debug port buffer.
+
+  Does nothing when buffered output is disabled or nothing is pending.
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlush (
+  VOID
+  );
+
+/**
+  Return the buffered output statistics of the USB3 debug port.
+
+  @param  FlushCount       The number of bulk transfers sent from the buffer.
+  @param  BytesWritten     The number of bytes written to the buffer.
+  @param  BytesDropped     The number of bytes dropped because the debug host
+                           did not take them.
+
+  @retval RETURN_SUCCESS            The statistics were returned.
+  @retval RETURN_INVALID_PARAMETER  FlushCount, BytesWritten or BytesDropped is NULL.
+  @retval RETURN_NOT_READY          The debug port has no output buffer.
+  @retval RETURN_UNSUPPORTED        Buffered output is disabled.
+
+**/
+RETURN_STATUS
+EFIAPI
+Usb3DebugPortGetStatistics (
+  OUT UINT64   *FlushCount,
+  OUT UINT64   *BytesWritten,
+  OUT UINT64   *BytesDropped
+  );
 
 /**
   Polls a USB3 debug port to see if there is any data waiting to be read.
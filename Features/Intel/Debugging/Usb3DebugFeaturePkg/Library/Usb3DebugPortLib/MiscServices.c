@@ -8,6 +8,8 @@
 
 #include "Usb3DebugPortLibInternal.h"
 
+extern BOOLEAN  mUsb3InSmm;
+
 /**
   Verifies if the bit positions specified by a mask are set in a register.
 
@@ -88,6 +90,67 @@ Usb3DebugPortInitialize (
   return RETURN_SUCCESS;
 }
 
+/**
+  Return the time elapsed since a performance counter value was taken.
+
+  @param  TimeStamp        The performance counter value.
+
+  @return The elapsed time in microseconds.
+**/
+STATIC
+UINT64
+Usb3DebugPortElapsedTime (
+  IN UINT64    TimeStamp
+  )
+{
+  UINT64    Current;
+  UINT64    StartValue;
+  UINT64    EndValue;
+
+  Current = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (StartValue < EndValue) {
+    Current = Current - TimeStamp;
+  } else {
+    Current = TimeStamp - Current;
+  }
+
+  return DivU64x32 (GetTimeInNanoSecond (Current), 1000);
+}
+
+/**
+  Send the debug output pending in the instance buffer.
+
+  The pending data goes out in as few bulk transfers as possible. Data that
+  could not be sent because the debug host went away is dropped.
+
+  @param  Instance         The XHCI Instance.
+**/
+STATIC
+VOID
+Usb3DebugPortFlushBuffer (
+  IN USB3_DEBUG_PORT_INSTANCE   *Instance
+  )
+{
+  UINTN     Length;
+
+  Length = Instance->OutBufferLength;
+  if (Length == 0) {
+    return;
+  }
+
+  Instance->OutBufferLength = 0;
+  Instance->OutBufferLines  = 0;
+
+  Usb3DbgOut ((UINT8 *) (UINTN) Instance->OutBuffer, &Length);
+
+  //
+  // Usb3DbgOut() leaves the number of bytes not sent in Length
+  //
+  Instance->OutFlushCount++;
+  Instance->OutBytesDropped += Length;
+}
+
 /**
   Write data from buffer to USB debug port.
 
@@ -97,6 +160,13 @@ Usb3DebugPortInitialize (
   If Buffer is NULL, then ASSERT().
   If NumberOfBytes is zero, then return 0.
 
+  When PcdUsb3DebugPortBufferedOutput is TRUE, data is coalesced in the
+  instance buffer and sent once the buffer is full, several lines are
+  pending, the pending data is older than XHC_DEBUG_PORT_OUT_FLUSH_TIMEOUT
+  or an ASSERT message is written. In DXE a periodic timer also sends data
+  that no later write pushes out, see Usb3DebugPortLibDxeFlush.c. Output
+  is not buffered in SMM.
+
   @param  Buffer           Pointer to the data buffer to be written.
   @param  NumberOfBytes    Number of bytes to written to the serial device.
 
@@ -111,10 +181,152 @@ Usb3DebugPortWrite (
   IN UINTN     NumberOfBytes
   )
 {
-  Usb3DbgOut (Buffer, &NumberOfBytes);
+  USB3_DEBUG_PORT_INSTANCE  *Instance;
+  UINT8                     *OutBuffer;
+  UINT8                     *Data;
+  UINTN                     Remaining;
+  UINTN                     Count;
+  UINTN                     Index;
+
+  if (!FeaturePcdGet (PcdUsb3DebugPortBufferedOutput)) {
+    Usb3DbgOut (Buffer, &NumberOfBytes);
+    return NumberOfBytes;
+  }
+
+  Instance = GetUsb3DebugPortInstance ();
+  if ((Instance == NULL) || (Instance->OutBuffer == 0) || (!Instance->Ready) ||
+      Instance->OutBufferBusy) {
+    //
+    // Write synchronously until the instance and its buffer are ready, or
+    // when interrupting a write that is filling the buffer
+    //
+    Usb3DbgOut (Buffer, &NumberOfBytes);
+    return NumberOfBytes;
+  }
+
+  if (mUsb3InSmm) {
+    //
+    // No timer flushes the buffer in SMM, so the output of an SMI that hangs
+    // would be lost. Send what is pending, then write synchronously.
+    //
+    Instance->OutBufferBusy = TRUE;
+    Usb3DebugPortFlushBuffer (Instance);
+    Usb3DbgOut (Buffer, &NumberOfBytes);
+    Instance->OutBufferBusy = FALSE;
+    return NumberOfBytes;
+  }
+
+  Instance->OutBufferBusy = TRUE;
+
+  OutBuffer = (UINT8 *) (UINTN) Instance->OutBuffer;
+  Data      = Buffer;
+  Remaining = NumberOfBytes;
+  while (Remaining > 0) {
+    if (Instance->OutBufferLength == 0) {
+      Instance->OutBufferTimeStamp = GetPerformanceCounter ();
+    }
+
+    Count = MIN (Remaining, XHC_DEBUG_PORT_OUT_BUFFER_SIZE - Instance->OutBufferLength);
+    CopyMem (OutBuffer + Instance->OutBufferLength, Data, Count);
+    for (Index = 0; Index < Count; Index++) {
+      if (Data[Index] == '\n') {
+        Instance->OutBufferLines++;
+      }
+    }
+
+    Instance->OutBufferLength += (UINT32) Count;
+    Data      += Count;
+    Remaining -= Count;
+
+    if (Instance->OutBufferLength == XHC_DEBUG_PORT_OUT_BUFFER_SIZE) {
+      Usb3DebugPortFlushBuffer (Instance);
+    }
+  }
+
+  Instance->OutBytesWritten += NumberOfBytes;
+
+  //
+  // DebugAssert() writes its message before halting, so an ASSERT must not
+  // stay in the buffer.
+  //
+  if ((Instance->OutBufferLines >= XHC_DEBUG_PORT_OUT_FLUSH_LINES) ||
+      ((NumberOfBytes >= 6) && (CompareMem (Buffer, "ASSERT", 6) == 0)) ||
+      (Usb3DebugPortElapsedTime (Instance->OutBufferTimeStamp) >= XHC_DEBUG_PORT_OUT_FLUSH_TIMEOUT)) {
+    Usb3DebugPortFlushBuffer (Instance);
+  }
+
+  Instance->OutBufferBusy = FALSE;
   return NumberOfBytes;
 }
 
+/**
+  Send the debug output pending in the USB debug port buffer.
+
+  Does nothing when buffered output is disabled, nothing is pending or a
+  write or read being interrupted is using the buffer.
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlush (
+  VOID
+  )
+{
+  USB3_DEBUG_PORT_INSTANCE  *Instance;
+
+  if (!FeaturePcdGet (PcdUsb3DebugPortBufferedOutput)) {
+    return;
+  }
+
+  Instance = GetUsb3DebugPortInstance ();
+  if ((Instance != NULL) && (Instance->OutBuffer != 0) && (!Instance->OutBufferBusy)) {
+    Instance->OutBufferBusy = TRUE;
+    Usb3DebugPortFlushBuffer (Instance);
+    Instance->OutBufferBusy = FALSE;
+  }
+}
+
+/**
+  Return the buffered output statistics of the USB debug port.
+
+  @param  FlushCount       The number of bulk transfers sent from the buffer.
+  @param  BytesWritten     The number of bytes written to the buffer.
+  @param  BytesDropped     The number of bytes dropped because the debug host
+                           did not take them.
+
+  @retval RETURN_SUCCESS            The statistics were returned.
+  @retval RETURN_INVALID_PARAMETER  FlushCount, BytesWritten or BytesDropped is NULL.
+  @retval RETURN_NOT_READY          The debug port has no output buffer.
+  @retval RETURN_UNSUPPORTED        Buffered output is disabled.
+**/
+RETURN_STATUS
+EFIAPI
+Usb3DebugPortGetStatistics (
+  OUT UINT64   *FlushCount,
+  OUT UINT64   *BytesWritten,
+  OUT UINT64   *BytesDropped
+  )
+{
+  USB3_DEBUG_PORT_INSTANCE  *Instance;
+
+  if (!FeaturePcdGet (PcdUsb3DebugPortBufferedOutput)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((FlushCount == NULL) || (BytesWritten == NULL) || (BytesDropped == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Instance = GetUsb3DebugPortInstance ();
+  if ((Instance == NULL) || (Instance->OutBuffer == 0)) {
+    return RETURN_NOT_READY;
+  }
+
+  *FlushCount   = Instance->OutFlushCount;
+  *BytesWritten = Instance->OutBytesWritten;
+  *BytesDropped = Instance->OutBytesDropped;
+  return RETURN_SUCCESS;
+}
+
 /**
   Read data from USB debug port and save the datas in buffer.
 
@@ -137,7 +349,27 @@ Usb3DebugPortRead (
   IN  UINTN   NumberOfBytes
   )
 {
+  USB3_DEBUG_PORT_INSTANCE  *Instance;
+  BOOLEAN                   Busy;
+
+  Instance = NULL;
+  Busy     = FALSE;
+  if (FeaturePcdGet (PcdUsb3DebugPortBufferedOutput)) {
+    //
+    // The URB is shared with the output path, keep the periodic flush away
+    //
+    Instance = GetUsb3DebugPortInstance ();
+    if (Instance != NULL) {
+      Busy = Instance->OutBufferBusy;
+      Instance->OutBufferBusy = TRUE;
+    }
+  }
+
   Usb3DbgIn (Buffer, &NumberOfBytes);
+
+  if (Instance != NULL) {
+    Instance->OutBufferBusy = Busy;
+  }
   return NumberOfBytes;
 }
 
@@ -722,6 +722,7 @@ Usb3DebugPortDataTransfer (
   UINT32                          Dcctrl;
   EFI_PHYSICAL_ADDRESS            UsbBase;
   UINTN                           BytesToSend;
+  UINTN                           MaxLength;
   USB3_DEBUG_PORT_CONTROLLER      UsbDebugPort;
   EFI_STATUS                      Status;
   USB3_DEBUG_PORT_INSTANCE        UsbDbgInstance;
@@ -832,9 +833,13 @@ Usb3DebugPortDataTransfer (
     }
   }
 
+  //
+  // OUT data is sent in max packet sized transfers, IN data is polled 8 bytes each time
+  //
+  MaxLength   = (Direction == EfiUsbDataOut) ? XHC_DEBUG_PORT_OUT_DATA_LENGTH : XHC_DEBUG_PORT_DATA_LENGTH;
   BytesToSend = 0;
   while (*Length > 0) {
-    BytesToSend = ((*Length) > XHC_DEBUG_PORT_DATA_LENGTH) ? XHC_DEBUG_PORT_DATA_LENGTH : *Length;
+    BytesToSend = ((*Length) > MaxLength) ? MaxLength : *Length;
     XhcDataTransfer (
       Instance,
       Direction,
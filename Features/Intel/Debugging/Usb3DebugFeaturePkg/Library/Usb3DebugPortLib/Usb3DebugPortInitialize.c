@@ -591,7 +591,14 @@ InitializeUsb3DebugPort (
   //
   // Init data buffer used to transfer
   //
-  Instance->Urb.Data = (EFI_PHYSICAL_ADDRESS) (UINTN) AllocateAlignBuffer (XHC_DEBUG_PORT_DATA_LENGTH);
+  Instance->Urb.Data = (EFI_PHYSICAL_ADDRESS) (UINTN) AllocateAlignBuffer (XHC_DEBUG_PORT_OUT_DATA_LENGTH);
+
+  //
+  // Init buffer coalescing debug output
+  //
+  if (FeaturePcdGet (PcdUsb3DebugPortBufferedOutput)) {
+    Instance->OutBuffer = (EFI_PHYSICAL_ADDRESS) (UINTN) AllocateAlignBuffer (XHC_DEBUG_PORT_OUT_BUFFER_SIZE);
+  }
 
   //
   // Init DCDDI1 and DCDDI2
@@ -395,6 +395,28 @@ Usb3DebugPortLibDxeConstructor (
     }
   }
 
+  Usb3DebugPortFlushHooksInstall ();
+
+  return EFI_SUCCESS;
+}
+
+/**
+  The destructor function.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+Usb3DebugPortLibDxeDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  Usb3DebugPortFlushHooksRemove ();
   return EFI_SUCCESS;
 }
 
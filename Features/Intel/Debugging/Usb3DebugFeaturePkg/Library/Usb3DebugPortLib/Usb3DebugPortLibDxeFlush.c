@@ -0,0 +1,263 @@
+/** @file
+  Flush of the buffered USB3 debug port output in DXE.
+
+  Buffered output is otherwise only sent by the next write, so the timer
+  event below sends data left pending, and the ExitBootServices and reset
+  notifications send it before the debug port goes away.
+
+  Copyright (c) 2013 - 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/PcdLib.h>
+#include <Library/HobLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/Usb3DebugPortLib.h>
+#include <Protocol/ResetNotification.h>
+#include <Guid/MemoryAllocationHob.h>
+#include "Usb3DebugPortLibInternal.h"
+
+extern BOOLEAN                   mUsb3InSmm;
+extern USB3_DEBUG_PORT_INSTANCE  *mUsb3Instance;
+
+//
+// Only the module that created the timer event owns the flush events
+//
+BOOLEAN                          mUsb3FlushOwner            = FALSE;
+EFI_EVENT                        mUsb3ExitBootServicesEvent = NULL;
+EFI_EVENT                        mUsb3ResetNotifyEvent      = NULL;
+EFI_RESET_NOTIFICATION_PROTOCOL  *mUsb3ResetNotify          = NULL;
+
+/**
+  Send the buffered debug output left pending.
+
+  @param  Event         The timer event.
+  @param  Context       Not used.
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlushTimer (
+  IN EFI_EVENT    Event,
+  IN VOID         *Context
+  )
+{
+  Usb3DebugPortFlush ();
+}
+
+/**
+  Send the buffered debug output before the system is reset.
+
+  @param  ResetType     The type of reset to perform.
+  @param  ResetStatus   The status code for the reset.
+  @param  DataSize      The size, in bytes, of ResetData.
+  @param  ResetData     Optional data passed to ResetSystem().
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlushOnReset (
+  IN EFI_RESET_TYPE   ResetType,
+  IN EFI_STATUS       ResetStatus,
+  IN UINTN            DataSize,
+  IN VOID             *ResetData OPTIONAL
+  )
+{
+  Usb3DebugPortFlush ();
+}
+
+/**
+  Send the buffered debug output and stop the timer at ExitBootServices.
+
+  @param  Event         The ExitBootServices event.
+  @param  Context       Not used.
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlushOnExitBootServices (
+  IN EFI_EVENT    Event,
+  IN VOID         *Context
+  )
+{
+  if (mUsb3Instance->FlushEvent != 0) {
+    gBS->SetTimer ((EFI_EVENT) (UINTN) mUsb3Instance->FlushEvent, TimerCancel, 0);
+  }
+
+  Usb3DebugPortFlush ();
+}
+
+/**
+  Register the reset notification once the protocol is installed.
+
+  @param  Event         The protocol notify event.
+  @param  Context       Not used.
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortResetNotificationInstalled (
+  IN EFI_EVENT    Event,
+  IN VOID         *Context
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_RESET_NOTIFICATION_PROTOCOL  *ResetNotify;
+
+  Status = gBS->LocateProtocol (&gEfiResetNotificationProtocolGuid, NULL, (VOID **) &ResetNotify);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = ResetNotify->RegisterResetNotify (ResetNotify, Usb3DebugPortFlushOnReset);
+  if (!EFI_ERROR (Status)) {
+    mUsb3ResetNotify = ResetNotify;
+  }
+
+  gBS->CloseEvent (Event);
+  mUsb3ResetNotifyEvent = NULL;
+}
+
+/**
+  Check whether the library is linked into the DXE Core.
+
+  The DXE Core runs the library constructors before its event services are
+  initialized, so it must not create events from them.
+
+  @retval TRUE          The current module is the DXE Core.
+  @retval FALSE         The current module is a DXE driver or application.
+
+**/
+BOOLEAN
+Usb3DebugPortIsDxeCore (
+  VOID
+  )
+{
+  EFI_PEI_HOB_POINTERS               Hob;
+  EFI_HOB_MEMORY_ALLOCATION_MODULE   *ModuleHob;
+
+  for (Hob.Raw = GetHobList ();
+       (Hob.Raw = GetNextHob (EFI_HOB_TYPE_MEMORY_ALLOCATION, Hob.Raw)) != NULL;
+       Hob.Raw = GET_NEXT_HOB (Hob)) {
+    ModuleHob = (EFI_HOB_MEMORY_ALLOCATION_MODULE *) Hob.Raw;
+    if (CompareGuid (&ModuleHob->MemoryAllocationHeader.Name, &gEfiHobMemoryAllocModuleGuid)) {
+      return CompareGuid (&ModuleHob->ModuleName, &gEfiCallerIdGuid);
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Create the events flushing the buffered debug output periodically, at
+  ExitBootServices and before a system reset.
+
+  Nothing is created in SMM, in the DXE Core, when buffered output is
+  disabled or when another module already owns the events. Output buffered
+  by the DXE Core is sent by the events of the first DXE driver loaded.
+
+**/
+VOID
+Usb3DebugPortFlushHooksInstall (
+  VOID
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_EVENT                  Event;
+  VOID                       *Registration;
+
+  if (!FeaturePcdGet (PcdUsb3DebugPortBufferedOutput) || mUsb3InSmm || (gBS == NULL)) {
+    return;
+  }
+
+  if (Usb3DebugPortIsDxeCore ()) {
+    return;
+  }
+
+  if ((mUsb3Instance == NULL) || (mUsb3Instance->OutBuffer == 0) ||
+      (!mUsb3Instance->Ready) || (mUsb3Instance->FlushEvent != 0)) {
+    return;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  Usb3DebugPortFlushTimer,
+                  NULL,
+                  &Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = gBS->SetTimer (
+                  Event,
+                  TimerPeriodic,
+                  EFI_TIMER_PERIOD_MICROSECONDS (XHC_DEBUG_PORT_OUT_FLUSH_TIMEOUT)
+                  );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Event);
+    return;
+  }
+
+  mUsb3Instance->FlushEvent = (EFI_PHYSICAL_ADDRESS) (UINTN) Event;
+  mUsb3FlushOwner           = TRUE;
+
+  gBS->CreateEvent (
+         EVT_SIGNAL_EXIT_BOOT_SERVICES,
+         TPL_NOTIFY,
+         Usb3DebugPortFlushOnExitBootServices,
+         NULL,
+         &mUsb3ExitBootServicesEvent
+         );
+
+  mUsb3ResetNotifyEvent = EfiCreateProtocolNotifyEvent (
+                            &gEfiResetNotificationProtocolGuid,
+                            TPL_CALLBACK,
+                            Usb3DebugPortResetNotificationInstalled,
+                            NULL,
+                            &Registration
+                            );
+}
+
+/**
+  Close the events created by Usb3DebugPortFlushHooksInstall().
+
+  The pending output is sent first, so that a module unloading does not take
+  it away.
+
+**/
+VOID
+Usb3DebugPortFlushHooksRemove (
+  VOID
+  )
+{
+  if (!mUsb3FlushOwner) {
+    return;
+  }
+
+  Usb3DebugPortFlush ();
+
+  if (mUsb3ResetNotify != NULL) {
+    mUsb3ResetNotify->UnregisterResetNotify (mUsb3ResetNotify, Usb3DebugPortFlushOnReset);
+    mUsb3ResetNotify = NULL;
+  }
+
+  if (mUsb3ResetNotifyEvent != NULL) {
+    gBS->CloseEvent (mUsb3ResetNotifyEvent);
+    mUsb3ResetNotifyEvent = NULL;
+  }
+
+  if (mUsb3ExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (mUsb3ExitBootServicesEvent);
+    mUsb3ExitBootServicesEvent = NULL;
+  }
+
+  gBS->CloseEvent ((EFI_EVENT) (UINTN) mUsb3Instance->FlushEvent);
+  mUsb3Instance->FlushEvent = 0;
+  mUsb3FlushOwner           = FALSE;
+}
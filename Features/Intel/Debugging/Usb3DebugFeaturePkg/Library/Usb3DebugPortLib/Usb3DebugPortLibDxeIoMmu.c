@@ -143,7 +143,7 @@ Usb3MapDmaBuffers (
   Usb3MapOneDmaBuffer (
     PciIo,
     Instance->Urb.Data,
-    XHC_DEBUG_PORT_DATA_LENGTH
+    XHC_DEBUG_PORT_OUT_DATA_LENGTH
     );
 
   Usb3MapOneDmaBuffer (
@@ -691,6 +691,8 @@ Usb3DebugPortLibDxeConstructor (
     }
   }
 
+  Usb3DebugPortFlushHooksInstall ();
+
   return EFI_SUCCESS;
 }
 
@@ -710,6 +712,8 @@ Usb3DebugPortLibDxeDestructor (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
+  Usb3DebugPortFlushHooksRemove ();
+
   if ((mUsb3Instance != NULL) && (mUsb3Instance->PciIoEvent != 0)) {
     //
     // Close the event created.
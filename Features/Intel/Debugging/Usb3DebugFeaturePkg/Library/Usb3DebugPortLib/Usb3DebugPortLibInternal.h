@@ -57,10 +57,30 @@
 #define XHC_USBSTS_HALT               BIT0
 
 //
-// Transfer the data of 8 bytes each time
+// Receive the data of 8 bytes each time
 //
 #define XHC_DEBUG_PORT_DATA_LENGTH   8
 
+//
+// Maximum data sent by one bulk OUT transfer, one SuperSpeed max packet
+//
+#define XHC_DEBUG_PORT_OUT_DATA_LENGTH  1024
+
+//
+// Size of the buffer coalescing debug output when buffered output is enabled
+//
+#define XHC_DEBUG_PORT_OUT_BUFFER_SIZE  XHC_DEBUG_PORT_OUT_DATA_LENGTH
+
+//
+// Buffered output is flushed once this many lines are pending
+//
+#define XHC_DEBUG_PORT_OUT_FLUSH_LINES  8
+
+//
+// Buffered output older than this (in microseconds) is flushed on the next write
+//
+#define XHC_DEBUG_PORT_OUT_FLUSH_TIMEOUT  10000
+
 //
 // Indicate the timeout when data is transferred. 0 means infinite timeout.
 //
@@ -509,6 +529,34 @@ typedef struct _USB3_DEBUG_PORT_INSTANCE {
   // URB
   //
   URB                                     Urb;
+
+  //
+  // Buffer coalescing debug output, the number of bytes and lines pending
+  // in it and the performance counter value when it was last empty
+  //
+  EFI_PHYSICAL_ADDRESS                    OutBuffer;
+  UINT32                                  OutBufferLength;
+  UINT32                                  OutBufferLines;
+  UINT64                                  OutBufferTimeStamp;
+
+  //
+  // Buffered output statistics
+  //
+  UINT64                                  OutFlushCount;
+  UINT64                                  OutBytesWritten;
+  UINT64                                  OutBytesDropped;
+
+  //
+  // The flag indicates the buffer or the URB is in use, the periodic flush
+  // must not touch them
+  //
+  BOOLEAN                                 OutBufferBusy;
+
+  //
+  // Periodic flush timer event, created by the first DXE module that finds
+  // it unset
+  //
+  EFI_PHYSICAL_ADDRESS                    FlushEvent;
 } USB3_DEBUG_PORT_INSTANCE;
 
 #pragma pack()
@@ -884,4 +932,23 @@ XhcDataTransfer (
   OUT    UINT32                              *TransferResult
   );
 
+/**
+  Create the events flushing the buffered debug output periodically, at
+  ExitBootServices and before a system reset.
+
+**/
+VOID
+Usb3DebugPortFlushHooksInstall (
+  VOID
+  );
+
+/**
+  Close the events created by Usb3DebugPortFlushHooksInstall().
+
+**/
+VOID
+Usb3DebugPortFlushHooksRemove (
+  VOID
+  );
+
 #endif //__SERIAL_PORT_LIB_USB__
@@ -55,6 +55,42 @@ Usb3DebugPortWrite (
   return 0;
 }
 
+/**
+  Send the debug output pending in the USB3 debug port buffer.
+
+  Does nothing when buffered output is disabled or nothing is pending.
+
+**/
+VOID
+EFIAPI
+Usb3DebugPortFlush (
+  VOID
+  )
+{
+}
+
+/**
+  Return the buffered output statistics of the USB3 debug port.
+
+  @param  FlushCount       The number of bulk transfers sent from the buffer.
+  @param  BytesWritten     The number of bytes written to the buffer.
+  @param  BytesDropped     The number of bytes dropped because the debug host
+                           did not take them.
+
+  @retval RETURN_UNSUPPORTED    Always.
+
+**/
+RETURN_STATUS
+EFIAPI
+Usb3DebugPortGetStatistics (
+  OUT UINT64   *FlushCount,
+  OUT UINT64   *BytesWritten,
+  OUT UINT64   *BytesDropped
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
+
 
 /**
   Read data from USB3 debug port and save the datas in buffer.
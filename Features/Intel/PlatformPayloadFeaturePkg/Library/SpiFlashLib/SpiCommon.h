@@ -20,6 +20,7 @@
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
 #include <Library/TimerLib.h>
+#include <Library/CacheMaintenanceLib.h>
 #include <Guid/SpiFlashInfoGuid.h>
 #include "RegsSpi.h"
 
@@ -31,6 +32,16 @@
 #define WAIT_TIME    6000000    ///< Wait Time = 6 seconds = 6000000 microseconds
 #define WAIT_PERIOD  10         ///< Wait Period = 10 microseconds
 
+///
+/// Largest BIOS region which is decoded below 4GB and may be read through MMIO
+///
+#define SPI_BIOS_MMIO_MAX_SIZE  SIZE_16MB
+
+///
+/// Flash page size used to compare data before a write cycle
+///
+#define SPI_FLASH_PAGE_SIZE  256
+
 ///
 /// Flash cycle Type
 ///
@@ -71,6 +82,8 @@ typedef struct {
   UINT8         NumberOfComponents;
   UINT16        Flags;
   UINT32        Component1StartAddr;
+  UINT32        BiosRegionSize;
+  UINTN         BiosMmioBase;
 } SPI_INSTANCE;
 
 /**
@@ -43,8 +43,10 @@ SpiConstructor (
   VOID
   )
 {
+  EFI_STATUS         Status;
   UINT32             ScSpiBar0;
   UINT8              Comp0Density;
+  UINT32             BiosRegionSize;
   SPI_INSTANCE       *SpiInstance;
   EFI_HOB_GUID_TYPE  *GuidHob;
   SPI_FLASH_INFO     *SpiFlashInfo;
@@ -147,11 +149,111 @@ SpiConstructor (
   //
   SpiInstance->StrapBaseAddress &= B_SPI_FDBAR_FPSBA;
 
+  //
+  // The BIOS region is decoded right below 4GB, so it can be read through MMIO
+  // instead of hardware sequencing cycles.
+  //
+  Status = SpiGetRegionAddress (FlashRegionBios, NULL, &BiosRegionSize);
+  if (!EFI_ERROR (Status) && (BiosRegionSize != 0) && (BiosRegionSize <= SPI_BIOS_MMIO_MAX_SIZE)) {
+    SpiInstance->BiosRegionSize = BiosRegionSize;
+    SpiInstance->BiosMmioBase   = (UINTN)(SIZE_4GB - BiosRegionSize);
+    DEBUG ((DEBUG_INFO, "BIOS region mapped at 0x%lx, size 0x%x\n", (UINT64)SpiInstance->BiosMmioBase, BiosRegionSize));
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Check if a flash range is decoded in the memory mapped BIOS window.
+
+  @param[in] SpiInstance          SPI instance
+  @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
+  @param[in] Address              The Flash Linear Address relative to the region.
+  @param[in] ByteCount            Number of bytes of the range.
+
+  @retval TRUE                    The range can be accessed through MMIO.
+  @retval FALSE                   The range must be accessed through SPI cycles.
+**/
+STATIC
+BOOLEAN
+SpiIsMemoryMapped (
+  IN     SPI_INSTANCE       *SpiInstance,
+  IN     FLASH_REGION_TYPE  FlashRegionType,
+  IN     UINT32             Address,
+  IN     UINT32             ByteCount
+  )
+{
+  return (BOOLEAN)((FlashRegionType == FlashRegionBios) &&
+                   (SpiInstance->BiosMmioBase != 0) &&
+                   (Address < SpiInstance->BiosRegionSize) &&
+                   (ByteCount <= SpiInstance->BiosRegionSize - Address));
+}
+
+/**
+  Flush and invalidate CPU cache lines of a memory mapped flash range
+  after it has been written or erased through SPI cycles.
+
+  @param[in] SpiInstance          SPI instance
+  @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
+  @param[in] Address              The Flash Linear Address relative to the region.
+  @param[in] ByteCount            Number of bytes of the range.
+**/
+STATIC
+VOID
+SpiInvalidateMemoryMappedRange (
+  IN     SPI_INSTANCE       *SpiInstance,
+  IN     FLASH_REGION_TYPE  FlashRegionType,
+  IN     UINT32             Address,
+  IN     UINT32             ByteCount
+  )
+{
+  if ((ByteCount != 0) && SpiIsMemoryMapped (SpiInstance, FlashRegionType, Address, ByteCount)) {
+    WriteBackInvalidateDataCacheRange ((VOID *)(SpiInstance->BiosMmioBase + Address), ByteCount);
+  }
+}
+
+/**
+  Check if a flash range is in erased state.
+
+  @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
+  @param[in] Address              The Flash Linear Address relative to the region.
+  @param[in] ByteCount            Number of bytes of the range.
+
+  @retval TRUE                    All bytes of the range are 0xFF.
+  @retval FALSE                   The range is not blank or could not be read.
+**/
+STATIC
+BOOLEAN
+SpiFlashIsBlank (
+  IN     FLASH_REGION_TYPE  FlashRegionType,
+  IN     UINT32             Address,
+  IN     UINT32             ByteCount
+  )
+{
+  UINT8   Data[SPI_FLASH_PAGE_SIZE];
+  UINT32  Offset;
+  UINT32  ChunkSize;
+  UINT32  Index;
+
+  for (Offset = 0; Offset < ByteCount; Offset += ChunkSize) {
+    ChunkSize = MIN (sizeof (Data), ByteCount - Offset);
+    if (EFI_ERROR (SpiFlashRead (FlashRegionType, Address + Offset, ChunkSize, Data))) {
+      return FALSE;
+    }
+
+    for (Index = 0; Index < ChunkSize; Index++) {
+      if (Data[Index] != 0xFF) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Read data from the flash part.
+  Reads within the memory mapped BIOS region are copied directly from MMIO.
 
   @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
   @param[in] Address              The Flash Linear Address must fall within a region for which BIOS has access permissions.
@@ -172,7 +274,18 @@ SpiFlashRead (
   OUT    UINT8              *Buffer
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS    Status;
+  SPI_INSTANCE  *SpiInstance;
+
+  SpiInstance = GetSpiInstance ();
+  if (SpiInstance == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (SpiIsMemoryMapped (SpiInstance, FlashRegionType, Address, ByteCount)) {
+    CopyMem (Buffer, (VOID *)(SpiInstance->BiosMmioBase + Address), ByteCount);
+    return EFI_SUCCESS;
+  }
 
   Status = SendSpiCmd (FlashRegionType, FlashCycleRead, Address, ByteCount, Buffer);
   return Status;
@@ -180,6 +293,7 @@ SpiFlashRead (
 
 /**
   Write data to the flash part.
+  Flash pages which already hold the data are not programmed again.
 
   @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
   @param[in] Address              The Flash Linear Address must fall within a region for which BIOS has access permissions.
@@ -199,14 +313,61 @@ SpiFlashWrite (
   IN     UINT8              *Buffer
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS    Status;
+  SPI_INSTANCE  *SpiInstance;
+  UINT8         Current[SPI_FLASH_PAGE_SIZE];
+  UINT32        Offset;
+  UINT32        ChunkSize;
+  UINT32        RunOffset;
+  UINT32        RunLength;
+  BOOLEAN       Unchanged;
+
+  SpiInstance = GetSpiInstance ();
+  if (SpiInstance == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Compare the data one flash page at a time and program only runs of pages
+  // which differ. Regions are 4KB aligned, so region relative addresses have
+  // the same page alignment as flash linear addresses.
+  //
+  Status    = EFI_SUCCESS;
+  RunOffset = 0;
+  RunLength = 0;
+  Offset    = 0;
+  while (Offset < ByteCount) {
+    ChunkSize = SPI_FLASH_PAGE_SIZE - ((Address + Offset) & (SPI_FLASH_PAGE_SIZE - 1));
+    ChunkSize = MIN (ChunkSize, ByteCount - Offset);
+
+    Unchanged = (BOOLEAN)(!EFI_ERROR (SpiFlashRead (FlashRegionType, Address + Offset, ChunkSize, Current)) &&
+                          (CompareMem (Current, Buffer + Offset, ChunkSize) == 0));
+    if (!Unchanged) {
+      if (RunLength == 0) {
+        RunOffset = Offset;
+      }
+
+      RunLength += ChunkSize;
+    }
+
+    Offset += ChunkSize;
+
+    if ((RunLength != 0) && (Unchanged || (Offset == ByteCount))) {
+      Status    = SendSpiCmd (FlashRegionType, FlashCycleWrite, Address + RunOffset, RunLength, Buffer + RunOffset);
+      RunLength = 0;
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+  }
 
-  Status = SendSpiCmd (FlashRegionType, FlashCycleWrite, Address, ByteCount, Buffer);
+  SpiInvalidateMemoryMappedRange (SpiInstance, FlashRegionType, Address, ByteCount);
   return Status;
 }
 
 /**
   Erase some area on the flash part.
+  4KB blocks which are already blank are not erased again.
 
   @param[in] FlashRegionType      The Flash Region type for flash cycle which is listed in the Descriptor.
   @param[in] Address              The Flash Linear Address must fall within a region for which BIOS has access permissions.
@@ -224,9 +385,54 @@ SpiFlashErase (
   IN     UINT32             ByteCount
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS    Status;
+  SPI_INSTANCE  *SpiInstance;
+  UINT32        Offset;
+  UINT32        RunOffset;
+  UINT32        RunLength;
+  BOOLEAN       Blank;
+
+  SpiInstance = GetSpiInstance ();
+  if (SpiInstance == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Let SendSpiCmd report unaligned requests
+  //
+  if (((Address % SIZE_4KB) != 0) || ((ByteCount % SIZE_4KB) != 0)) {
+    return SendSpiCmd (FlashRegionType, FlashCycleErase, Address, ByteCount, NULL);
+  }
+
+  //
+  // Skip blocks which are already blank. Runs of dirty blocks are erased with
+  // one command so SendSpiCmd can still use 64KB erase cycles.
+  //
+  Status    = EFI_SUCCESS;
+  RunOffset = 0;
+  RunLength = 0;
+  for (Offset = 0; Offset < ByteCount; ) {
+    Blank = SpiFlashIsBlank (FlashRegionType, Address + Offset, SIZE_4KB);
+    if (!Blank) {
+      if (RunLength == 0) {
+        RunOffset = Offset;
+      }
+
+      RunLength += SIZE_4KB;
+    }
+
+    Offset += SIZE_4KB;
+
+    if ((RunLength != 0) && (Blank || (Offset == ByteCount))) {
+      Status    = SendSpiCmd (FlashRegionType, FlashCycleErase, Address + RunOffset, RunLength, NULL);
+      RunLength = 0;
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+  }
 
-  Status = SendSpiCmd (FlashRegionType, FlashCycleErase, Address, ByteCount, NULL);
+  SpiInvalidateMemoryMappedRange (SpiInstance, FlashRegionType, Address, ByteCount);
   return Status;
 }
 
@@ -454,6 +454,16 @@ VkTimer (
   DEBUG ((DEBUG_VK_TIMER_ENTRY_EXIT, "VkTimer Start\n"));
   VkContext = (VK_CONTEXT *)Context;
 
+  //
+  // Without the Blt interposer, or once in a while to catch direct frame
+  // buffer writes, treat all keyboard regions as damaged.
+  //
+  VkContext->ReadbackFallbackCheck++;
+  if (!VkContext->IsBltHooked || (VkContext->ReadbackFallbackCheck >= VK_READBACK_FALLBACK_INTERVAL)) {
+    VkContext->Damage               |= VK_DAMAGE_ALL;
+    VkContext->ReadbackFallbackCheck = 0;
+  }
+
   //
   // Update keyboard UI layout
   //
@@ -855,6 +865,8 @@ VkApiStart (
 
   InitializeListHead (&VkContext->NotifyList);
 
+  VkInstallBltHook (VkContext);
+
   Status = SetCharacterPosition (VkContext, 800, 600);
   ASSERT_EFI_ERROR (Status);
 
@@ -1020,6 +1032,8 @@ VkApiStop (
     VkContext->SimpleTextInEx.WaitForKeyEx = NULL;
   }
 
+  VkRemoveBltHook (VkContext);
+
   NotifyList = &VkContext->NotifyList;
   if (NotifyList != NULL) {
     while (!IsListEmpty (NotifyList)) {
@@ -1129,6 +1129,216 @@ KeyboardLayoutHandler (
   return Status;
 }
 
+///
+/// Virtual keyboard context and original Blt function of the interposed GOP
+///
+STATIC VK_CONTEXT                       *mVkBltHookContext = NULL;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL     *mVkBltHookGop     = NULL;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL_BLT mVkOriginalBlt     = NULL;
+
+/**
+  Check if two rectangles overlap.
+
+  @param[in] X1, Y1, Width1, Height1  First rectangle.
+  @param[in] X2, Y2, Width2, Height2  Second rectangle.
+
+  @retval TRUE                        The rectangles overlap.
+  @retval FALSE                       The rectangles do not overlap.
+
+**/
+STATIC
+BOOLEAN
+VkIsRectOverlapped (
+  IN UINTN X1,
+  IN UINTN Y1,
+  IN UINTN Width1,
+  IN UINTN Height1,
+  IN UINTN X2,
+  IN UINTN Y2,
+  IN UINTN Width2,
+  IN UINTN Height2
+  )
+{
+  return (BOOLEAN) ((X1 < X2 + Width2) && (X2 < X1 + Width1) &&
+                    (Y1 < Y2 + Height2) && (Y2 < Y1 + Height1));
+}
+
+/**
+  GOP Blt interposer.
+
+  Record which keyboard regions are overdrawn, then forward the request to
+  the original Blt function.
+
+  @param[in] This          Protocol instance pointer.
+  @param[in] BltBuffer     The data to transfer to the graphics screen.
+  @param[in] BltOperation  The operation to perform.
+  @param[in] SourceX       The X coordinate of the source for BltOperation.
+  @param[in] SourceY       The Y coordinate of the source for BltOperation.
+  @param[in] DestinationX  The X coordinate of the destination for BltOperation.
+  @param[in] DestinationY  The Y coordinate of the destination for BltOperation.
+  @param[in] Width         Width of rectangle in BltBuffer in pixels.
+  @param[in] Height        Height of rectangle in BltBuffer in pixels.
+  @param[in] Delta         Bytes in a row of the BltBuffer.
+
+  @retval The status returned by the original Blt function.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+VkGraphicsOutputBlt (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL      *This,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *BltBuffer   OPTIONAL,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_OPERATION BltOperation,
+  IN  UINTN                             SourceX,
+  IN  UINTN                             SourceY,
+  IN  UINTN                             DestinationX,
+  IN  UINTN                             DestinationY,
+  IN  UINTN                             Width,
+  IN  UINTN                             Height,
+  IN  UINTN                             Delta         OPTIONAL
+  )
+{
+  VK_CONTEXT *VkContext;
+  UINTN      HorizontalResolution;
+  UINTN      VerticalResolution;
+
+  VkContext = mVkBltHookContext;
+  if ((VkContext != NULL) && (This == mVkBltHookGop) &&
+      (BltOperation != EfiBltVideoToBltBuffer) && (Width != 0) && (Height != 0)) {
+    HorizontalResolution = This->Mode->Info->HorizontalResolution;
+    VerticalResolution   = This->Mode->Info->VerticalResolution;
+
+    if (VkIsRectOverlapped (
+          DestinationX, DestinationY, Width, Height,
+          0, VerticalResolution - VkContext->IconBltHeight,
+          VkContext->IconBltWidth, VkContext->IconBltHeight)) {
+      VkContext->Damage |= VK_DAMAGE_ICON;
+    }
+
+    if (VkIsRectOverlapped (
+          DestinationX, DestinationY, Width, Height,
+          HorizontalResolution - VkContext->IconBltWidth, VerticalResolution - VkContext->IconBltHeight,
+          VkContext->IconBltWidth, VkContext->IconBltHeight)) {
+      VkContext->Damage |= VK_DAMAGE_SCREEN_CHECK;
+    }
+
+    if (VkIsRectOverlapped (
+          DestinationX, DestinationY, Width, Height,
+          VkContext->VkBodyBltStartX, VkContext->VkBodyBltStartY,
+          VkContext->VkBodyBltWidth, VkContext->VkBodyBltHeight)) {
+      VkContext->Damage |= VK_DAMAGE_BODY;
+    }
+  }
+
+  return mVkOriginalBlt (
+           This,
+           BltBuffer,
+           BltOperation,
+           SourceX,
+           SourceY,
+           DestinationX,
+           DestinationY,
+           Width,
+           Height,
+           Delta
+           );
+}
+
+/**
+  Interpose the GOP Blt function to learn about draws overlapping the keyboard.
+
+  Only one GOP is interposed. Other instances keep reading back the screen
+  on every check.
+
+  @param[in, out] VkContext  Pointer to virtual keyboard's context
+
+**/
+VOID
+VkInstallBltHook (
+  IN OUT VK_CONTEXT *VkContext
+  )
+{
+  EFI_TPL OldTpl;
+
+  VkContext->Damage                = VK_DAMAGE_ALL;
+  VkContext->ReadbackFallbackCheck = 0;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (mVkOriginalBlt == NULL) {
+    mVkBltHookGop      = VkContext->GraphicsOutput;
+    mVkOriginalBlt     = mVkBltHookGop->Blt;
+    mVkBltHookGop->Blt = VkGraphicsOutputBlt;
+  }
+  if ((mVkBltHookContext == NULL) && (mVkBltHookGop == VkContext->GraphicsOutput)) {
+    mVkBltHookContext      = VkContext;
+    VkContext->IsBltHooked = TRUE;
+  }
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Remove the GOP Blt interposer and free the read back buffer.
+
+  If another driver has interposed Blt on top of this one, the interposer
+  stays in place and only forwards requests.
+
+  @param[in, out] VkContext  Pointer to virtual keyboard's context
+
+**/
+VOID
+VkRemoveBltHook (
+  IN OUT VK_CONTEXT *VkContext
+  )
+{
+  EFI_TPL OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (VkContext->IsBltHooked) {
+    mVkBltHookContext      = NULL;
+    VkContext->IsBltHooked = FALSE;
+    if (mVkBltHookGop->Blt == VkGraphicsOutputBlt) {
+      mVkBltHookGop->Blt = mVkOriginalBlt;
+      mVkBltHookGop      = NULL;
+      mVkOriginalBlt     = NULL;
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (VkContext->ReadbackBuffer != NULL) {
+    FreePool (VkContext->ReadbackBuffer);
+    VkContext->ReadbackBuffer     = NULL;
+    VkContext->ReadbackBufferSize = 0;
+  }
+}
+
+/**
+  Get the reusable buffer to read back a screen region.
+
+  @param[in, out] VkContext  Pointer to virtual keyboard's context
+  @param[in]      Size       Required buffer size in bytes.
+
+  @retval Buffer of at least Size bytes, or NULL if out of resources.
+
+**/
+STATIC
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *
+VkGetReadbackBuffer (
+  IN OUT VK_CONTEXT *VkContext,
+  IN     UINTN      Size
+  )
+{
+  if (VkContext->ReadbackBufferSize < Size) {
+    if (VkContext->ReadbackBuffer != NULL) {
+      FreePool (VkContext->ReadbackBuffer);
+    }
+    VkContext->ReadbackBuffer     = AllocateZeroPool (Size);
+    VkContext->ReadbackBufferSize = (VkContext->ReadbackBuffer != NULL) ? Size : 0;
+  }
+
+  return VkContext->ReadbackBuffer;
+}
+
 /**
   This routine is used to check if icon has been cleared.
 
@@ -1156,11 +1366,20 @@ CheckIconCleared (
     return Status;
   }
 
+  if (VkContext->IsIconShowed && ((VkContext->Damage & VK_DAMAGE_ICON) == 0)) {
+    //
+    // Nothing has been drawn over the icon.
+    //
+    VkContext->IconReDrawCheck = 0;
+    return Status;
+  }
+  VkContext->Damage &= ~VK_DAMAGE_ICON;
+
   //
   // Check if right-bottomed region is black, if yes, clean screen happened, need to re-draw keyboard.
   //
   VerticalResolution    = VkContext->GraphicsOutput->Mode->Info->VerticalResolution;
-  BltBuffer             = AllocateZeroPool (VkContext->IconBltSize);
+  BltBuffer             = VkGetReadbackBuffer (VkContext, VkContext->IconBltSize);
   if (BltBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1177,7 +1396,6 @@ CheckIconCleared (
                                         VkContext->IconBltWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
                                         );
   if (EFI_ERROR (Status)) {
-    FreePool (BltBuffer);
     return Status;
   }
   VkContext->IsIconShowed = TRUE;
@@ -1216,10 +1434,6 @@ CheckIconCleared (
     }
   }
 
-  if (BltBuffer != NULL) {
-    FreePool (BltBuffer);
-  }
-
   VkContext->IconReDrawCheck = 0;
 
   return Status;
@@ -1290,13 +1504,14 @@ CheckScreenCleared (
 
   IsScreenCleared = FALSE;
   Status          = EFI_SUCCESS;
-  if ((gST->ConOut->Mode->CursorColumn == 0) && (gST->ConOut->Mode->CursorRow == 0)) {
+  if (((VkContext->Damage & VK_DAMAGE_SCREEN_CHECK) != 0) &&
+      (gST->ConOut->Mode->CursorColumn == 0) && (gST->ConOut->Mode->CursorRow == 0)) {
     //
     // System may call gST->ConOut->ClearScreen
     //
     HorizontalResolution  = VkContext->GraphicsOutput->Mode->Info->HorizontalResolution;
     VerticalResolution    = VkContext->GraphicsOutput->Mode->Info->VerticalResolution;
-    BltBuffer             = AllocateZeroPool (VkContext->IconBltSize);
+    BltBuffer             = VkGetReadbackBuffer (VkContext, VkContext->IconBltSize);
     if (BltBuffer == NULL) {
       return EFI_OUT_OF_RESOURCES;
     }
@@ -1315,7 +1530,6 @@ CheckScreenCleared (
                                           VkContext->IconBltWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
                                           );
     if (EFI_ERROR (Status)) {
-      FreePool (BltBuffer);
       return Status;
     }
     BltSize = VkContext->IconBltHeight * VkContext->IconBltWidth;
@@ -1327,8 +1541,8 @@ CheckScreenCleared (
       }
       BltBufferIndex++;
     }
-    FreePool (BltBuffer);
   }
+  VkContext->Damage &= ~VK_DAMAGE_SCREEN_CHECK;
 
   if (IsScreenCleared) {
     VkContext->IsIconShowed   = FALSE;
@@ -1377,7 +1591,15 @@ CheckBackgroundChanged (
     return EFI_SUCCESS;
   }
 
-  BltBuffer = AllocateZeroPool (VkContext->VkBodyBltSize);
+  if ((VkContext->Damage & VK_DAMAGE_BODY) == 0) {
+    //
+    // Nothing has been drawn over the keyboard body.
+    //
+    return EFI_SUCCESS;
+  }
+  VkContext->Damage &= ~VK_DAMAGE_BODY;
+
+  BltBuffer = VkGetReadbackBuffer (VkContext, VkContext->VkBodyBltSize);
   if (BltBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1394,7 +1616,6 @@ CheckBackgroundChanged (
                                         VkContext->VkBodyBltWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
                                         );
   if (EFI_ERROR (Status)) {
-    FreePool (BltBuffer);
     return Status;
   }
   if (CompareMem (BltBuffer, VkContext->VkBodyCompoundBltBuffer, VkContext->VkBodyBltSize) != 0) {
@@ -1403,10 +1624,6 @@ CheckBackgroundChanged (
     DrawKeyboardLayout (VkContext);
   }
 
-  if (BltBuffer != NULL) {
-    FreePool (BltBuffer);
-  }
-
   return Status;
 }
 
@@ -103,6 +103,19 @@ extern EFI_COMPONENT_NAME2_PROTOCOL  gVirtualKeyboardComponentName2;
 ///
 #define TRANSPARENCY_WEIGHT 50
 
+///
+/// Screen regions reported as damaged by the GOP Blt interposer
+///
+#define VK_DAMAGE_ICON                BIT0
+#define VK_DAMAGE_SCREEN_CHECK        BIT1
+#define VK_DAMAGE_BODY                BIT2
+#define VK_DAMAGE_ALL                 (VK_DAMAGE_ICON | VK_DAMAGE_SCREEN_CHECK | VK_DAMAGE_BODY)
+
+///
+/// Poll intervals between fallback read backs, which catch direct frame buffer writes
+///
+#define VK_READBACK_FALLBACK_INTERVAL 50
+
 typedef struct _VK_CONTEXT VK_CONTEXT;
 
 typedef enum _VK_KEY_TYPE {
@@ -379,6 +392,20 @@ struct _VK_CONTEXT {
   ///
   UINTN                             PreviousX;
   UINTN                             PreviousY;
+
+  ///
+  /// Damage tracking
+  /// Regions overdrawn through GOP Blt since they were last checked
+  ///
+  BOOLEAN                           IsBltHooked;
+  UINT32                            Damage;
+  UINT32                            ReadbackFallbackCheck;
+
+  ///
+  /// Reusable buffer for reading back screen regions
+  ///
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *ReadbackBuffer;
+  UINTN                             ReadbackBufferSize;
 };
 
 ///
@@ -681,6 +708,28 @@ VkGetMappingFont (
   OUT UINT32     *FontPtr
   );
 
+/**
+  Interpose the GOP Blt function to learn about draws overlapping the keyboard.
+
+  @param[in, out] VkContext  Pointer to virtual keyboard's context
+
+**/
+VOID
+VkInstallBltHook (
+  IN OUT VK_CONTEXT *VkContext
+  );
+
+/**
+  Remove the GOP Blt interposer and free the read back buffer.
+
+  @param[in, out] VkContext  Pointer to virtual keyboard's context
+
+**/
+VOID
+VkRemoveBltHook (
+  IN OUT VK_CONTEXT *VkContext
+  );
+
 /**
   This routine is used to check if icon has been cleared.
 
@@ -22,6 +22,11 @@ HII_ELEMENT  gElementInfo[] = {
   { L"VALUE=",  FIXED_STR_LEN (L"VALUE=")  }
 };
 
+STATIC CONST CHAR16  mHexDigits[] = L"0123456789abcdef";
+
+STATIC HII_PARSED_REQUEST  *mRequestCache[HII_REQUEST_CACHE_ENTRIES];
+STATIC UINTN               mNextRequestCacheEntry;
+
 /**
   Converts the unicode character of the string from uppercase to lowercase.
   This is a internal function.
@@ -303,209 +308,127 @@ GetValueOfNumber (
 }
 
 /**
-  Initializes HII_STRING instance allocating buffer.
-
-  @param[in, out]  This    Pointer to HII_STRING instance.
-  @param[in]  Size    Size of initial allocation.
-
-  @retval EFI_SUCCESS           Allocated buffer successfully.
-  @retval EFI_OUT_OF_RESOURCES  Out of memory.
-**/
-EFI_STATUS
-HiiStringInit (
-  IN OUT HII_STRING  *This,
-  IN     UINTN       Size
-  )
-{
-  ASSERT (This != NULL);
-
-  This->StringLength = 0;
-
-  if (Size == 0) {
-    This->String            = NULL;
-    This->PrivateBufferSize = 0;
-    return EFI_SUCCESS;
-  }
-
-  This->String = (EFI_STRING)AllocatePool (Size);
-
-  if (This->String != NULL) {
-    This->String[0]         = L'\0';
-    This->PrivateBufferSize = Size;
-  } else {
-    This->PrivateBufferSize = 0;
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  return EFI_SUCCESS;
-}
+  Converts a hex digit to its value. Characters that are not hex digits are
+  treated as 0.
 
-/**
-  Frees HiiString Buffer
+  @param[in]  Digit  The hex digit.
 
-  @param[in, out]  This    Pointer to HII_STRING instance.
+  @return The value of Digit.
 
 **/
-VOID
-HiiStringFree (
-  IN OUT HII_STRING  *This
+STATIC
+UINT8
+HiiHexDigitValue (
+  IN CHAR16  Digit
   )
 {
-  ASSERT (This != NULL);
-
-  if (This->String != NULL) {
-    FreePool (This->String);
-    This->String            = NULL;
-    This->PrivateBufferSize = 0;
+  if ((Digit >= L'0') && (Digit <= L'9')) {
+    return (UINT8)(Digit - L'0');
+  } else if ((Digit >= L'A') && (Digit <= L'F')) {
+    return (UINT8)(Digit - L'A' + 0xa);
+  } else if ((Digit >= L'a') && (Digit <= L'f')) {
+    return (UINT8)(Digit - L'a' + 0xa);
   }
+
+  return 0;
 }
 
 /**
-  If buffer doesn't exist, allocate it. If the existing buffer is less than
-  requested, allocate a larger one.
+  Writes a value as lowercase hex digits, most significant byte first.
 
-  @param[in, out]  This    Pointer to HII_STRING instance.
-  @param[in]  Size    Requested buffer size.
+  @param[out]  String  Buffer to write Width * 2 characters to.
+  @param[in]   Value   The value, least significant byte first.
+  @param[in]   Width   The number of bytes in Value.
 
-  @retval EFI_SUCCESS           Buffer allocated.
-  @retval EFI_OUT_OF_RESOURCES  OUt of memory.
+  @return Pointer after the last character written.
 
 **/
-EFI_STATUS
-HiiStringSetMinBufferSize (
-  IN OUT HII_STRING  *This,
-  IN     UINTN       Size
+STATIC
+EFI_STRING
+HiiEncodeValue (
+  OUT EFI_STRING   String,
+  IN  CONST UINT8  *Value,
+  IN  UINTN        Width
   )
 {
-  UINTN       ThisStringSize;
-  EFI_STRING  NewAlloc;
-
-  ThisStringSize = (This->StringLength + 1) * sizeof (CHAR16);
-
-  if (Size > This->PrivateBufferSize) {
-    NewAlloc = (EFI_STRING)AllocatePool (Size);
-    if (NewAlloc == NULL) {
-      return EFI_OUT_OF_RESOURCES;
-    }
-
-    CopyMem (NewAlloc, This->String, ThisStringSize);
-    FreePool (This->String);
-    This->String            = NewAlloc;
-    This->PrivateBufferSize = Size;
+  while (Width > 0) {
+    Width--;
+    *String++ = mHexDigits[Value[Width] >> 4];
+    *String++ = mHexDigits[Value[Width] & 0xf];
   }
 
-  return EFI_SUCCESS;
+  return String;
 }
 
 /**
-  Append a string to the string in HII_STRING instance.
+  Decodes a <Number> string straight into a block, least significant byte
+  first. Bytes the string does not cover are set to 0.
 
-  @param[in, out]  This    Pointer to HII_STRING instance.
-  @param[in]  String  String to append.
+  @param[in]   String  The number string. It may end in \0 or &.
+  @param[out]  Value   Buffer to receive Width bytes, or NULL to only measure
+                       the string.
+  @param[in]   Width   The number of bytes to write to Value.
 
-  @retval EFI_SUCCESS           String is appended.
-  @retval EFI_OUT_OF_RESOURCES  OUt of memory.
+  @return The length of the number string in characters.
 
 **/
-EFI_STATUS
-HiiStringAppend (
-  IN OUT HII_STRING  *This,
-  IN     EFI_STRING  String
+STATIC
+UINTN
+HiiDecodeValue (
+  IN  EFI_STRING  String,
+  OUT UINT8       *Value OPTIONAL,
+  IN  UINTN       Width
   )
 {
-  EFI_STATUS  Status;
-  UINTN       ThisStringSize;
-  UINTN       StringSize;
-  UINTN       MaxLen;
+  UINTN  Length;
+  UINTN  Index;
+  UINTN  Digit;
 
-  if ((This == NULL) || (String == NULL)) {
-    return EFI_INVALID_PARAMETER;
+  for (Length = 0; String[Length] != L'\0' && String[Length] != L'&'; Length++) {
   }
 
-  ThisStringSize = (This->StringLength + 1) * sizeof (CHAR16);
-  StringSize     = HII_STR_SIZE (String);
+  if (Value != NULL) {
+    for (Index = 0, Digit = Length; Index < Width; Index++) {
+      Value[Index] = 0;
+      if (Digit > 0) {
+        Value[Index] = HiiHexDigitValue (String[--Digit]);
+      }
 
-  if (ThisStringSize + StringSize > This->PrivateBufferSize) {
-    MaxLen = (ThisStringSize + StringSize) * 2;
-    Status = HiiStringSetMinBufferSize (This, MaxLen);
-    if (EFI_ERROR (Status)) {
-      return Status;
+      if (Digit > 0) {
+        Value[Index] |= (UINT8)(HiiHexDigitValue (String[--Digit]) << 4);
+      }
     }
   }
 
-  //
-  // Append the incoming string
-  //
-  CopyMem (&This->String[This->StringLength], String, StringSize);
-  This->StringLength += StringSize / sizeof (CHAR16) - 1;
-
-  return EFI_SUCCESS;
+  return Length;
 }
 
 /**
-  Append a number to the string in HII_STRING instance.
+  Hashes a Null-terminated Unicode string and returns its length.
 
-  @param[in, out]  This    Pointer to HII_STRING instance.
-  @param[in]  Number  Number to append.
-  @param[in]  Length  Length of Number.
+  @param[in]   String  The string to hash.
+  @param[out]  Length  The length of String in characters.
+
+  @return The FNV-1a hash of String.
 
-  @retval EFI_SUCCESS           Number is appended.
-  @retval EFI_OUT_OF_RESOURCES  OUt of memory.
 **/
-EFI_STATUS
-HiiStringAppendValue (
-  IN OUT  HII_STRING  *This,
-  IN      UINT8       *Number,
-  IN      UINTN       Length
+STATIC
+UINT32
+HiiHashString (
+  IN  EFI_STRING  String,
+  OUT UINTN       *Length
   )
 {
-  EFI_STATUS  Status;
-  UINTN       ThisStringSize;
-  UINTN       Index;
-  UINTN       Index2;
-  UINT8       Nibble;
-  UINTN       MaxLen;
-
-  CHAR16  *String;
-
-  if (Length == 0) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  ThisStringSize = (This->StringLength + 1) * sizeof (CHAR16);
+  UINT32  Hash;
+  UINTN   Index;
 
-  if (ThisStringSize + Length * 2 * sizeof (CHAR16) > This->PrivateBufferSize) {
-    MaxLen = (ThisStringSize + Length * 2 * sizeof (CHAR16)) * 2; // Double requested string length.
-    Status = HiiStringSetMinBufferSize (This, MaxLen);
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+  Hash = 0x811C9DC5;
+  for (Index = 0; String[Index] != L'\0'; Index++) {
+    Hash = (Hash ^ String[Index]) * 0x01000193;
   }
 
-  String              = This->String + This->StringLength;
-  This->StringLength += Length * 2;
-
-  Index = Length;
-
-  do {
-    Index--;
-    Nibble = Number[Index] >> 4;
-
-    for (Index2 = 0; Index2 < 2; Index2++) {
-      if (Nibble < 0xa) {
-        *String = '0' + Nibble;
-      } else {
-        *String = 'a' + Nibble - 0xa;
-      }
-
-      Nibble = Number[Index] & 0xf;
-      String++;
-    }
-  } while (Index > 0);
-
-  *String = '\0';
-
-  return EFI_SUCCESS;
+  *Length = Index;
+  return Hash;
 }
 
 /**
@@ -611,84 +534,77 @@ GetEndOfConfigHdr (
 }
 
 /**
-  This helper function is to be called by drivers to map configuration data
-  stored in byte array ("block") formats such as UEFI Variables into current
-  configuration strings.
+  Parse the <BlockName> elements of a <ConfigRequest>.
 
-  @param[in]  This                   A pointer to the EFI_HII_CONFIG_ROUTING_PROTOCOL
-                                 instance.
-  @param[in]  ConfigRequest          A null-terminated Unicode string in
-                                 <ConfigRequest> format.
-  @param[in]  Block                  Array of bytes defining the block's configuration.
-  @param[in]  BlockSize              Length in bytes of Block.
-  @param[out]  Config                 Filled-in configuration string. String allocated
-                                 by the function. Returned only if call is
-                                 successful. It is <ConfigResp> string format.
-  @param[out]  Progress               A pointer to a string filled in with the offset of
-                                 the most recent & before the first failing
-                                 name/value pair (or the beginning of the string if
-                                 the failure is in the first name/value pair) or
-                                 the terminating NULL if all was successful.
+  This is a internal function.
 
-  @retval EFI_SUCCESS            The request succeeded. Progress points to the null
-                                 terminator at the end of the ConfigRequest
-                                 string.
-  @retval EFI_OUT_OF_RESOURCES   Not enough memory to allocate Config. Progress
-                                 points to the first character of ConfigRequest.
-  @retval EFI_INVALID_PARAMETER  Passing in a NULL for the ConfigRequest or
-                                 Block parameter would result in this type of
-                                 error. Progress points to the first character of
-                                 ConfigRequest.
-  @retval EFI_DEVICE_ERROR       Block not large enough. Progress undefined.
+  @param[in]   ConfigRequest  A null-terminated Unicode string in
+                              <ConfigRequest> format.
+  @param[in]   Length         Length of ConfigRequest in characters.
+  @param[in]   Hash           Hash of ConfigRequest.
+  @param[out]  Parsed         The parsed request. On error, it holds the
+                              elements parsed before the failing one and must
+                              be freed by the caller. NULL if out of memory.
+  @param[out]  Progress       Points at the '&' preceding the first element
+                              that could not be parsed.
+
+  @retval EFI_SUCCESS            The request was parsed.
+  @retval EFI_OUT_OF_RESOURCES   Out of memory.
   @retval EFI_INVALID_PARAMETER  Encountered non <BlockName> formatted string.
-                                 Block is left updated and Progress points at
-                                 the "&" preceding the first non-<BlockName>.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-HiiBlockToConfig (
-  IN  CONST EFI_HII_CONFIG_ROUTING_PROTOCOL  *This,
-  IN  CONST EFI_STRING                       ConfigRequest,
-  IN  CONST UINT8                            *Block,
-  IN  CONST UINTN                            BlockSize,
-  OUT EFI_STRING                             *Config,
-  OUT EFI_STRING                             *Progress
+ParseConfigRequest (
+  IN  EFI_STRING          ConfigRequest,
+  IN  UINTN               Length,
+  IN  UINT32              Hash,
+  OUT HII_PARSED_REQUEST  **Parsed,
+  OUT EFI_STRING          *Progress
   )
 {
-  EFI_STATUS  Status;
-  EFI_STRING  StringPtr;
-  EFI_STRING  OrigPtr;
-  CHAR16      CharBackup;
-  UINTN       Offset;
-  UINTN       Width;
-  UINT8       *Value;
-  HII_STRING  HiiString;
-  HII_NUMBER  HiiNumber;
-
-  if ((This == NULL) || (Progress == NULL) || (Config == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
+  EFI_STATUS          Status;
+  HII_PARSED_REQUEST  *Request;
+  HII_BLOCK_ELEMENT   *Element;
+  UINTN               MaxElements;
+  EFI_STRING          StringPtr;
+  EFI_STRING          OrigPtr;
+  HII_NUMBER          HiiNumber;
 
-  if ((Block == NULL) || (ConfigRequest == NULL)) {
+  //
+  // The shortest element is "OFFSET=0&WIDTH=0&"
+  //
+  MaxElements = Length / (gElementInfo[ElementOffsetHdr].ElementLength +
+                          gElementInfo[ElementWidthHdr].ElementLength + 3) + 1;
+
+  Request = AllocatePool (
+              sizeof (HII_PARSED_REQUEST) +
+              MaxElements * sizeof (HII_BLOCK_ELEMENT) +
+              2 * (Length + 1) * sizeof (CHAR16)
+              );
+  *Parsed = Request;
+  if (Request == NULL) {
     *Progress = ConfigRequest;
-    return EFI_INVALID_PARAMETER;
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  StringPtr = ConfigRequest;
-
-  Status = HiiStringInit (&HiiString, MAX_STRING_LENGTH);
-  if (EFI_ERROR (Status)) {
-    *Progress = ConfigRequest;
-    return Status;
-  }
+  Request->Hash         = Hash;
+  Request->Length       = Length;
+  Request->ConfigLength = Length;
+  Request->ElementCount = 0;
+  Request->Elements     = (HII_BLOCK_ELEMENT *)(Request + 1);
+  Request->Request      = (EFI_STRING)(Request->Elements + MaxElements);
+  Request->Template     = Request->Request + Length + 1;
+  CopyMem (Request->Request, ConfigRequest, (Length + 1) * sizeof (CHAR16));
+  CopyMem (Request->Template, ConfigRequest, (Length + 1) * sizeof (CHAR16));
+  HiiToLower (Request->Template);
 
   HiiNumberInit (&HiiNumber);
 
   //
   // Jump <ConfigHdr>
   //
-  StringPtr = GetEndOfConfigHdr (StringPtr);
+  StringPtr = GetEndOfConfigHdr (ConfigRequest);
   if (StringPtr == NULL) {
     //
     //  Invalid header.
@@ -698,45 +614,22 @@ HiiBlockToConfig (
     goto Exit;
   }
 
-  if (*StringPtr == L'\0') {
-    *Progress = StringPtr;
-    HiiStringAppend (&HiiString, ConfigRequest);
-    HiiToLower (HiiString.String);
-
-    //
-    // Do not free HiiString.String with HiiStringFree;
-    //
-    *Config = HiiString.String;
-    return EFI_SUCCESS;
-  }
-
-  //
-  // Copy <ConfigHdr> and an additional '&' to <ConfigResp>
-  //
-  CharBackup   = StringPtr[0];
-  StringPtr[0] = L'\0';         // Temporarily change & to L'\0'
-  Status       = HiiStringAppend (&HiiString, ConfigRequest);
-  if (EFI_ERROR (Status)) {
-    *Progress = ConfigRequest;
-    goto Exit;
-  }
-
-  StringPtr[0] = CharBackup;
-
   //
   // Parse each <RequestElement> if exists
   // Only <BlockName> format is supported by this help function.
   // <BlockName> ::= 'OFFSET='<Number>&'WIDTH='<Number>
   //
+  while (*StringPtr != L'\0') {
+    //
+    // OrigPtr starts at "OFFSET=", and StringPtr points to value.
+    //
+    OrigPtr   = StringPtr;
+    StringPtr = FindElmentValue (ElementOffsetHdr, StringPtr);
+    if (StringPtr == NULL) {
+      StringPtr = OrigPtr;
+      break;
+    }
 
-  //
-  // while search for "OFFSET="
-  // When "OFFSET=" is found, OrigPtr starts at "OFFSET=", and StringPtr points to value.
-  //
-  while (*StringPtr != 0 &&
-         (OrigPtr = StringPtr, (StringPtr = FindElmentValue (ElementOffsetHdr, StringPtr)) != NULL)
-         )
-  {
     //
     // Get Offset
     //
@@ -751,8 +644,9 @@ HiiBlockToConfig (
       goto Exit;
     }
 
-    Offset     = HiiNumber.Value;
-    StringPtr += HiiNumber.StringLength + 1;
+    Element         = &Request->Elements[Request->ElementCount];
+    Element->Offset = HiiNumber.Value;
+    StringPtr      += HiiNumber.StringLength + 1;
 
     //
     // Get Width
@@ -775,53 +669,25 @@ HiiBlockToConfig (
       goto Exit;
     }
 
-    Width      = HiiNumber.Value;
-    StringPtr += HiiNumber.StringLength;
+    Element->Width = HiiNumber.Value;
+    StringPtr     += HiiNumber.StringLength;
 
-    if ((*StringPtr != 0) && (*StringPtr != L'&')) {
+    if ((*StringPtr != L'\0') && (*StringPtr != L'&')) {
       *Progress =  OrigPtr - 1;
       Status    = EFI_INVALID_PARAMETER;
       goto Exit;
     }
 
-    //
-    // Calculate Value and convert it to hex string.
-    //
-    if (Offset + Width > BlockSize) {
-      *Progress = StringPtr;
-      Status    = EFI_DEVICE_ERROR;
-      goto Exit;
-    }
-
-    Value = (UINT8 *)Block + Offset;
+    Element->End = StringPtr - ConfigRequest;
+    Request->ElementCount++;
 
-    CharBackup = *StringPtr;
-    *StringPtr = L'\0';
-
-    Status = HiiStringAppend (&HiiString, OrigPtr);
-    if (EFI_ERROR (Status)) {
-      *Progress = ConfigRequest;  // Out of memory
-      goto Exit;
-    }
-
-    *StringPtr = CharBackup;  // End of section of string OrigPtr
-
-    Status = HiiStringAppend (&HiiString, L"&VALUE=");
-    if (EFI_ERROR (Status)) {
-      *Progress = ConfigRequest;  // Out of memory
+    if (Element->Width == 0) {
+      *Progress = OrigPtr - 1;
+      Status    = EFI_INVALID_PARAMETER;
       goto Exit;
     }
 
-    Status = HiiStringAppendValue (&HiiString, Value, Width);
-    if (EFI_ERROR (Status)) {
-      if (Status == EFI_OUT_OF_RESOURCES) {
-        *Progress = ConfigRequest;  // Out of memory
-      } else {
-        *Progress =  OrigPtr - 1;
-      }
-
-      goto Exit;
-    }
+    Request->ConfigLength += gElementInfo[ElementValueHdr].ElementLength + 1 + Element->Width * 2;
 
     //
     // If L'\0', parsing is finished. Otherwise skip L'&' to continue
@@ -830,12 +696,6 @@ HiiBlockToConfig (
       break;
     }
 
-    Status = HiiStringAppend (&HiiString, L"&");
-    if (EFI_ERROR (Status)) {
-      *Progress = ConfigRequest;  // Out of memory
-      goto Exit;
-    }
-
     StringPtr++;  // Skip L'&'
   }
 
@@ -845,24 +705,217 @@ HiiBlockToConfig (
     goto Exit;
   }
 
-  HiiToLower (HiiString.String);
-  *Progress = StringPtr;
+  Status = EFI_SUCCESS;
 
+Exit:
   HiiNumberFree (&HiiNumber);
 
+  return Status;
+}
+
+/**
+  Look up a parsed <ConfigRequest> in the cache.
+
+  This is a internal function.
+
+  @param[in]  ConfigRequest  The <ConfigRequest> string.
+  @param[in]  Length         Length of ConfigRequest in characters.
+  @param[in]  Hash           Hash of ConfigRequest.
+
+  @retval Pointer to the parsed request.
+  @retval NULL if ConfigRequest has not been parsed before.
+
+**/
+STATIC
+HII_PARSED_REQUEST *
+FindParsedRequest (
+  IN EFI_STRING  ConfigRequest,
+  IN UINTN       Length,
+  IN UINT32      Hash
+  )
+{
+  HII_PARSED_REQUEST  *Request;
+  UINTN               Index;
+
+  for (Index = 0; Index < HII_REQUEST_CACHE_ENTRIES; Index++) {
+    Request = mRequestCache[Index];
+    if ((Request != NULL) &&
+        (Request->Hash == Hash) &&
+        (Request->Length == Length) &&
+        (CompareMem (Request->Request, ConfigRequest, Length * sizeof (CHAR16)) == 0))
+    {
+      return Request;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add a parsed <ConfigRequest> to the cache, replacing the oldest entry.
+
+  This is a internal function.
+
+  @param[in]  Request  The parsed request. The cache takes ownership of it.
+
+**/
+STATIC
+VOID
+CacheParsedRequest (
+  IN HII_PARSED_REQUEST  *Request
+  )
+{
+  if (mRequestCache[mNextRequestCacheEntry] != NULL) {
+    FreePool (mRequestCache[mNextRequestCacheEntry]);
+  }
+
+  mRequestCache[mNextRequestCacheEntry] = Request;
+  mNextRequestCacheEntry                = (mNextRequestCacheEntry + 1) % HII_REQUEST_CACHE_ENTRIES;
+}
+
+/**
+  This helper function is to be called by drivers to map configuration data
+  stored in byte array ("block") formats such as UEFI Variables into current
+  configuration strings.
+
+  @param[in]  This                   A pointer to the EFI_HII_CONFIG_ROUTING_PROTOCOL
+                                 instance.
+  @param[in]  ConfigRequest          A null-terminated Unicode string in
+                                 <ConfigRequest> format.
+  @param[in]  Block                  Array of bytes defining the block's configuration.
+  @param[in]  BlockSize              Length in bytes of Block.
+  @param[out]  Config                 Filled-in configuration string. String allocated
+                                 by the function. Returned only if call is
+                                 successful. It is <ConfigResp> string format.
+  @param[out]  Progress               A pointer to a string filled in with the offset of
+                                 the most recent & before the first failing
+                                 name/value pair (or the beginning of the string if
+                                 the failure is in the first name/value pair) or
+                                 the terminating NULL if all was successful.
+
+  @retval EFI_SUCCESS            The request succeeded. Progress points to the null
+                                 terminator at the end of the ConfigRequest
+                                 string.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to allocate Config. Progress
+                                 points to the first character of ConfigRequest.
+  @retval EFI_INVALID_PARAMETER  Passing in a NULL for the ConfigRequest or
+                                 Block parameter would result in this type of
+                                 error. Progress points to the first character of
+                                 ConfigRequest.
+  @retval EFI_DEVICE_ERROR       Block not large enough. Progress undefined.
+  @retval EFI_INVALID_PARAMETER  Encountered non <BlockName> formatted string.
+                                 Block is left updated and Progress points at
+                                 the "&" preceding the first non-<BlockName>.
+
+**/
+EFI_STATUS
+EFIAPI
+HiiBlockToConfig (
+  IN  CONST EFI_HII_CONFIG_ROUTING_PROTOCOL  *This,
+  IN  CONST EFI_STRING                       ConfigRequest,
+  IN  CONST UINT8                            *Block,
+  IN  CONST UINTN                            BlockSize,
+  OUT EFI_STRING                             *Config,
+  OUT EFI_STRING                             *Progress
+  )
+{
+  EFI_STATUS          Status;
+  EFI_STATUS          ParseStatus;
+  EFI_STRING          ParseProgress;
+  EFI_STRING          String;
+  HII_PARSED_REQUEST  *Request;
+  HII_BLOCK_ELEMENT   *Element;
+  UINTN               Length;
+  UINTN               Start;
+  UINTN               Index;
+  UINT32              Hash;
+
+  if ((This == NULL) || (Progress == NULL) || (Config == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Block == NULL) || (ConfigRequest == NULL)) {
+    *Progress = ConfigRequest;
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *Config = NULL;
+
   //
-  // Do not free HiiString.String with HiiStringFree. The caller will
-  // consume it when EFI_SUCCESS.
+  // Setup browsers convert the same varstore requests over and over, so keep
+  // the parsed form of recent requests around.
   //
-  *Config = HiiString.String;
+  ParseStatus   = EFI_SUCCESS;
+  ParseProgress = ConfigRequest;
+  Hash        = HiiHashString (ConfigRequest, &Length);
+  Request     = FindParsedRequest (ConfigRequest, Length, Hash);
+  if (Request == NULL) {
+    ParseStatus = ParseConfigRequest (ConfigRequest, Length, Hash, &Request, &ParseProgress);
+    if (Request == NULL) {
+      *Progress = ParseProgress;
+      return ParseStatus;
+    }
 
-  return EFI_SUCCESS;
+    if (!EFI_ERROR (ParseStatus)) {
+      CacheParsedRequest (Request);
+    }
+  }
 
-Exit:
-  HiiStringFree (&HiiString);
-  HiiNumberFree (&HiiNumber);
+  //
+  // Check the elements against BlockSize in request order, so an element
+  // outside of Block is reported ahead of a later malformed one.
+  //
+  for (Index = 0; Index < Request->ElementCount; Index++) {
+    Element = &Request->Elements[Index];
+    if (Element->Offset + Element->Width > BlockSize) {
+      *Progress = ConfigRequest + Element->End;
+      Status    = EFI_DEVICE_ERROR;
+      goto Exit;
+    }
+  }
 
-  *Config = NULL;
+  if (EFI_ERROR (ParseStatus)) {
+    *Progress = ParseProgress;
+    Status    = ParseStatus;
+    goto Exit;
+  }
+
+  String = AllocatePool ((Request->ConfigLength + 1) * sizeof (CHAR16));
+  if (String == NULL) {
+    *Progress = ConfigRequest;
+    Status    = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  //
+  // Copy the request text up to the end of each element, then its value.
+  //
+  *Config = String;
+  Start   = 0;
+  for (Index = 0; Index < Request->ElementCount; Index++) {
+    Element = &Request->Elements[Index];
+    CopyMem (String, Request->Template + Start, (Element->End - Start) * sizeof (CHAR16));
+    String   += Element->End - Start;
+    *String++ = L'&';
+    CopyMem (
+      String,
+      gElementInfo[ElementValueHdr].ElementString,
+      gElementInfo[ElementValueHdr].ElementLength * sizeof (CHAR16)
+      );
+    String += gElementInfo[ElementValueHdr].ElementLength;
+    String  = HiiEncodeValue (String, Block + Element->Offset, Element->Width);
+    Start   = Element->End;
+  }
+
+  CopyMem (String, Request->Template + Start, (Length - Start + 1) * sizeof (CHAR16));
+
+  *Progress = ConfigRequest + Length;
+  Status    = EFI_SUCCESS;
+
+Exit:
+  if (EFI_ERROR (ParseStatus)) {
+    FreePool (Request);
+  }
 
   return Status;
 }
@@ -1026,30 +1079,25 @@ HiiConfigToBlock (
       goto Exit;
     }
 
-    Status = GetValueOfNumber (&HiiNumber, StringPtr);
-    if (EFI_ERROR (Status)) {
-      if (Status == EFI_OUT_OF_RESOURCES) {
-        *Progress = ConfigResp;  // Out of memory
-      } else {
-        *Progress = OrigPtr - 1;
-      }
-
+    if (*StringPtr == L'\0') {
+      *Progress = OrigPtr - 1;
+      Status    = EFI_INVALID_PARAMETER;
       goto Exit;
     }
 
     //
-    // Update the Block with configuration info
+    // Update the Block with configuration info, decoding the value in place
     //
     if ((Block != NULL) && (Offset + Width <= BufferSize)) {
-      CopyMem (Block + Offset, HiiNumber.NumberPtr, Width);
+      StringPtr += HiiDecodeValue (StringPtr, Block + Offset, Width);
+    } else {
+      StringPtr += HiiDecodeValue (StringPtr, NULL, 0);
     }
 
     if (Offset + Width > MaxBlockSize) {
       MaxBlockSize = Offset + Width;
     }
 
-    StringPtr += HiiNumber.StringLength;
-
     if ((*StringPtr != L'\0') && (*StringPtr != L'&')) {
       *Progress = OrigPtr - 1;
       Status    = EFI_INVALID_PARAMETER;
@@ -21,10 +21,9 @@
 #define MAX_STRING_LENGTH  1024
 
 ///
-/// Returns the size of a Null-terminated Unicode string in bytes, including the
-/// Null terminator.
+/// Number of parsed <ConfigRequest> strings kept by HiiBlockToConfig.
 ///
-#define HII_STR_SIZE(str)  ((HiiStrLen (str) + 1) * sizeof (*str))
+#define HII_REQUEST_CACHE_ENTRIES  8
 
 ///
 /// HII_NUMBER definitions
@@ -46,18 +45,29 @@ typedef struct {
 } HII_NUMBER;
 
 ///
-/// HII_STRING definitions
+/// One <BlockName> element of a parsed <ConfigRequest>.
 ///
 typedef struct {
-  // Public variables
-  EFI_STRING    String;           ///< String that is maintained here, and futures
-                                  ///< calls will append to it.
-  UINTN         StringLength;     ///< Length of String.
+  UINTN    Offset;
+  UINTN    Width;
+  UINTN    End;                   ///< Index in the request of the '&' or '\0'
+                                  ///< that follows the WIDTH value.
+} HII_BLOCK_ELEMENT;
 
-  // Private variables
-  UINTN         PrivateBufferSize; ///< Length of allocated String. This reduces
-                                   ///< reallocations as strings are appended.
-} HII_STRING;
+///
+/// A parsed <ConfigRequest>. The element array, a copy of the request used as
+/// the cache key and the request with its hex digits lowered all follow the
+/// structure in the same allocation.
+///
+typedef struct {
+  UINT32               Hash;
+  UINTN                Length;        ///< Length of the request in characters.
+  UINTN                ConfigLength;  ///< Length of the resulting <ConfigResp>.
+  UINTN                ElementCount;
+  HII_BLOCK_ELEMENT    *Elements;
+  EFI_STRING           Request;
+  EFI_STRING           Template;      ///< Request text copied into <ConfigResp>.
+} HII_PARSED_REQUEST;
 
 #define FIXED_STR_LEN(String)  (sizeof (String) / sizeof (CHAR16) - 1)
 
@@ -162,6 +162,24 @@ TestPointEndOfPeiMtrrFunctional (
   VOID
   );
 
+/**
+  This service verifies the PEI boot performance at the end of PEI.
+
+  Test subject: PEI boot performance.
+  Test overview: Verify the PEI phase and every PEIM entry point complete within
+                 PcdTestPointPeiPhaseBudget and PcdTestPointPeimBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the PEIMs over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiBootPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies bus master enable (BME) is disabled at the end of PEI.
 
@@ -521,6 +539,24 @@ TestPointReadyToBootTcgMorEnabled (
   VOID
   );
 
+/**
+  This service verifies the DXE boot performance at Ready To Boot.
+
+  Test subject: DXE boot performance.
+  Test overview: Verify the DXE phase and every DXE driver entry point and driver binding
+                 Start() complete within PcdTestPointDxePhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the drivers over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies SMI handler profiling.
 
@@ -618,6 +654,24 @@ TestPointExitBootServices (
   VOID
   );
 
+/**
+  This service verifies the BDS boot performance after Exit Boot Services is invoked.
+
+  Test subject: BDS boot performance.
+  Test overview: Verify the BDS phase and every driver binding Start() in BDS complete
+                 within PcdTestPointBdsPhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Dumps the phase duration and the drivers over budget to the debug log.
+                       The TestPoint table cannot be updated after Exit Boot Services.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointExitBootServicesBootPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies the system state within SMM after Exit Boot Services is invoked.
 
@@ -770,6 +824,14 @@ TestPointSmmExitBootServices (
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_HSTI_TABLE_FUNCTIONAL_ERROR_CODE                        L"0x08010000"
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_HSTI_TABLE_FUNCTIONAL_ERROR_STRING                      L"No HSTI\r\n"
 
+// Byte 9 - Performance
+#define TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET                                 BIT0
+#define TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET                              BIT1
+#define   TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET_ERROR_CODE                         L"0x09000000"
+#define   TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET_ERROR_STRING                       L"PEI boot performance budget exceeded\r\n"
+#define   TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_CODE                      L"0x09010000"
+#define   TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_STRING                    L"DXE boot performance budget exceeded\r\n"
+
 #pragma pack (1)
 
 typedef struct {
@@ -154,6 +154,8 @@ OnReadyToBootLater (
   TestPointReadyToBootTcgTrustedBootEnabled ();
   TestPointReadyToBootTcgMorEnabled ();
   TestPointReadyToBootEsrtTableFunctional ();
+
+  TestPointReadyToBootBootPerformanceBudget ();
 }
 
 /**
@@ -219,6 +221,7 @@ OnEndOfFirmware (
   Status = BoardInitEndOfFirmware ();
   ASSERT_EFI_ERROR(Status);
 
+  TestPointExitBootServicesBootPerformanceBudget ();
   TestPointExitBootServices ();
 }
 
@@ -69,6 +69,8 @@ PlatformInitEndOfPei (
 
   TestPointEndOfPeiMtrrFunctional ();
 
+  TestPointEndOfPeiBootPerformanceBudget ();
+
   return Status;
 }
 
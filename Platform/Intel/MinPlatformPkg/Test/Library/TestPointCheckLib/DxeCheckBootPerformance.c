@@ -0,0 +1,281 @@
+/** @file
+  Compares the boot performance records published in the FPDT against the
+  board supplied boot performance budgets.
+
+Copyright (c) 2019, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <PiDxe.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/TestPointLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PerformanceLib.h>
+#include <IndustryStandard/Acpi.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+
+#define BOOT_PERFORMANCE_MAX_OPEN_RECORDS  32
+#define BOOT_PERFORMANCE_NS_PER_MS         1000000
+
+typedef struct {
+  UINT16      ProgressID;
+  EFI_GUID    Guid;
+  UINT64      Timestamp;
+} BOOT_PERFORMANCE_OPEN_RECORD;
+
+VOID *
+TestPointGetAcpi (
+  IN UINT32  Signature
+  );
+
+/**
+  Return the performance table header of the FPDT boot performance table.
+
+  @return The FBPT header, or NULL if the FPDT is not published yet.
+**/
+EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER *
+GetBootPerformanceTable (
+  VOID
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER                              *Fpdt;
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER              *Record;
+  EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_POINTER_RECORD  *Pointer;
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER               *Fbpt;
+  UINTN                                                    Offset;
+
+  Fpdt = TestPointGetAcpi (EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE);
+  if (Fpdt == NULL) {
+    return NULL;
+  }
+
+  for (Offset = sizeof(*Fpdt); Offset + sizeof(*Record) <= Fpdt->Length; Offset += Record->Length) {
+    Record = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)((UINT8 *)Fpdt + Offset);
+    if (Record->Length == 0) {
+      break;
+    }
+    if ((Record->Type == EFI_ACPI_5_0_FPDT_RECORD_TYPE_FIRMWARE_BASIC_BOOT_POINTER) &&
+        (Record->Length >= sizeof(*Pointer))) {
+      Pointer = (EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_POINTER_RECORD *)Record;
+      Fbpt = (EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER *)(UINTN)Pointer->BootPerformanceTablePointer;
+      if ((Fbpt == NULL) || (Fbpt->Signature != EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_SIGNATURE)) {
+        return NULL;
+      }
+      return Fbpt;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Return the GUID event record at Offset in the record buffer, and advance Offset past it.
+
+  All the extended performance records start with the FPDT_GUID_EVENT_RECORD
+  layout, other record types are skipped.
+
+  @param[in]      Records      Performance record buffer.
+  @param[in]      RecordsSize  Size of the performance record buffer in bytes.
+  @param[in, out] Offset       Offset of the next record in the buffer.
+
+  @return The next GUID event record, or NULL at the end of the buffer.
+**/
+FPDT_GUID_EVENT_RECORD *
+GetNextBootPerformanceRecord (
+  IN     UINT8  *Records,
+  IN     UINTN  RecordsSize,
+  IN OUT UINTN  *Offset
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER  *Record;
+
+  while (*Offset + sizeof(*Record) <= RecordsSize) {
+    Record = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)(Records + *Offset);
+    if ((Record->Length == 0) || (*Offset + Record->Length > RecordsSize)) {
+      break;
+    }
+    *Offset += Record->Length;
+    if ((Record->Type >= FPDT_GUID_EVENT_TYPE) &&
+        (Record->Type <= FPDT_GUID_QWORD_STRING_EVENT_TYPE) &&
+        (Record->Length >= sizeof(FPDT_GUID_EVENT_RECORD))) {
+      return (FPDT_GUID_EVENT_RECORD *)Record;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check if the record is the start or the end of a boot phase.
+
+  @param[in] Event      GUID event record.
+  @param[in] Phase      Boot phase name, such as "PEI", "DXE" or "BDS".
+
+  @retval TRUE   The record is the cross module record of the phase.
+  @retval FALSE  The record is not the cross module record of the phase.
+**/
+BOOLEAN
+IsBootPhaseRecord (
+  IN FPDT_GUID_EVENT_RECORD  *Event,
+  IN CONST CHAR8             *Phase
+  )
+{
+  FPDT_DYNAMIC_STRING_EVENT_RECORD  *StringEvent;
+  UINTN                             StringSize;
+
+  if ((Event->Header.Type != FPDT_DYNAMIC_STRING_EVENT_TYPE) ||
+      ((Event->ProgressID != PERF_CROSSMODULE_START_ID) && (Event->ProgressID != PERF_CROSSMODULE_END_ID))) {
+    return FALSE;
+  }
+
+  StringEvent = (FPDT_DYNAMIC_STRING_EVENT_RECORD *)Event;
+  StringSize  = Event->Header.Length - OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String);
+  if (StringSize < AsciiStrSize (Phase)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(AsciiStrnCmp (StringEvent->String, Phase, AsciiStrSize (Phase)) == 0);
+}
+
+/**
+  Check boot phase and per-driver durations against the boot performance budgets.
+
+  Phase is timed from its cross module start record to its cross module end
+  record, or to now if the phase has not ended yet. Every driver entry point and
+  driver binding Start() that begins within the phase is checked against the
+  driver budget.
+
+  @param[in] Phase         Boot phase name, such as "DXE" or "BDS".
+  @param[in] PhaseBudget   Budget of the whole phase in milliseconds, 0 means no budget.
+  @param[in] DriverBudget  Budget of one driver entry point or Start() in milliseconds, 0 means no budget.
+
+  @retval EFI_SUCCESS    All measured durations are within budget.
+  @retval EFI_NOT_FOUND  The FPDT boot performance table is not published.
+  @retval EFI_TIMEOUT    At least one duration exceeds its budget.
+**/
+EFI_STATUS
+TestPointCheckBootPerformance (
+  IN CONST CHAR8  *Phase,
+  IN UINT32       PhaseBudget,
+  IN UINT32       DriverBudget
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER  *Fbpt;
+  FPDT_GUID_EVENT_RECORD                      *Event;
+  BOOT_PERFORMANCE_OPEN_RECORD                Open[BOOT_PERFORMANCE_MAX_OPEN_RECORDS];
+  UINTN                                       OpenCount;
+  UINTN                                       Index;
+  UINTN                                       Offset;
+  UINT64                                      Now;
+  UINT64                                      PhaseStart;
+  UINT64                                      PhaseEnd;
+  UINT64                                      Duration;
+  EFI_STATUS                                  Status;
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Enter\n"));
+
+  Now  = GetTimeInNanoSecond (GetPerformanceCounter ());
+  Fbpt = GetBootPerformanceTable ();
+  if (Fbpt == NULL) {
+    DEBUG ((DEBUG_ERROR, "No FPDT boot performance table\n"));
+    DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Locate the phase window first, so records of earlier phases are not charged to this one.
+  //
+  PhaseStart = 0;
+  PhaseEnd   = MAX_UINT64;
+  Offset     = sizeof(*Fbpt);
+  while ((Event = GetNextBootPerformanceRecord ((UINT8 *)Fbpt, Fbpt->Length, &Offset)) != NULL) {
+    if (IsBootPhaseRecord (Event, Phase)) {
+      if (Event->ProgressID == PERF_CROSSMODULE_START_ID) {
+        PhaseStart = Event->Timestamp;
+      } else {
+        PhaseEnd = Event->Timestamp;
+      }
+    }
+  }
+
+  Status = EFI_SUCCESS;
+  if (PhaseStart == 0) {
+    DEBUG ((DEBUG_WARN, "No %a phase record, phase budget not checked\n", Phase));
+  } else {
+    Duration = ((PhaseEnd == MAX_UINT64) ? Now : PhaseEnd) - PhaseStart;
+    DEBUG ((DEBUG_INFO, "%a phase - %ld ms (budget %d ms)\n", Phase, DivU64x32 (Duration, BOOT_PERFORMANCE_NS_PER_MS), PhaseBudget));
+    if ((PhaseBudget != 0) && (Duration > MultU64x32 (PhaseBudget, BOOT_PERFORMANCE_NS_PER_MS))) {
+      DEBUG ((DEBUG_ERROR, "%a phase exceeds its budget\n", Phase));
+      Status = EFI_TIMEOUT;
+    }
+  }
+
+  if (DriverBudget == 0) {
+    DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+    return Status;
+  }
+
+  //
+  // Pair up the start and end records. Entry points nest when a driver loads
+  // and starts another image, so search the open records from the newest one.
+  //
+  OpenCount = 0;
+  Offset    = sizeof(*Fbpt);
+  while ((Event = GetNextBootPerformanceRecord ((UINT8 *)Fbpt, Fbpt->Length, &Offset)) != NULL) {
+    switch (Event->ProgressID) {
+    case MODULE_START_ID:
+    case MODULE_DB_START_ID:
+      if ((Event->Timestamp < PhaseStart) || (Event->Timestamp >= PhaseEnd)) {
+        break;
+      }
+      if (OpenCount == BOOT_PERFORMANCE_MAX_OPEN_RECORDS) {
+        DEBUG ((DEBUG_WARN, "Too many nested performance records, %g not checked\n", &Event->Guid));
+        break;
+      }
+      Open[OpenCount].ProgressID = Event->ProgressID;
+      Open[OpenCount].Timestamp  = Event->Timestamp;
+      CopyGuid (&Open[OpenCount].Guid, &Event->Guid);
+      OpenCount++;
+      break;
+
+    case MODULE_END_ID:
+    case MODULE_DB_END_ID:
+      for (Index = OpenCount; Index > 0; Index--) {
+        if ((Open[Index - 1].ProgressID == Event->ProgressID - 1) &&
+            CompareGuid (&Open[Index - 1].Guid, &Event->Guid)) {
+          break;
+        }
+      }
+      if (Index == 0) {
+        break;
+      }
+      Index--;
+      Duration = Event->Timestamp - Open[Index].Timestamp;
+      if (Duration > MultU64x32 (DriverBudget, BOOT_PERFORMANCE_NS_PER_MS)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%g %a - %ld ms exceeds the driver budget %d ms\n",
+          &Event->Guid,
+          (Event->ProgressID == MODULE_END_ID) ? "Entry" : "Start",
+          DivU64x32 (Duration, BOOT_PERFORMANCE_NS_PER_MS),
+          DriverBudget
+          ));
+        Status = EFI_TIMEOUT;
+      }
+      CopyMem (&Open[Index], &Open[Index + 1], (OpenCount - Index - 1) * sizeof(Open[0]));
+      OpenCount--;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+  return Status;
+}
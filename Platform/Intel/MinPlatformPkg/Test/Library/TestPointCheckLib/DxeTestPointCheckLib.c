@@ -153,6 +153,13 @@ TestPointGetAcpi (
   IN UINT32  Signature
   );
 
+EFI_STATUS
+TestPointCheckBootPerformance (
+  IN CONST CHAR8  *Phase,
+  IN UINT32       PhaseBudget,
+  IN UINT32       DriverBudget
+  );
+
 GLOBAL_REMOVE_IF_UNREFERENCED ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT  mTestPointStruct = {
   PLATFORM_TEST_POINT_VERSION,
   PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
@@ -1241,6 +1248,63 @@ TestPointReadyToBootTcgMorEnabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the DXE boot performance at Ready To Boot.
+
+  Test subject: DXE boot performance.
+  Test overview: Verify the DXE phase and every DXE driver entry point and driver binding
+                 Start() complete within PcdTestPointDxePhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the drivers over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+
+  if ((mFeatureImplemented[9] & TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootBootPerformanceBudget - Enter\n"));
+
+  Result = TRUE;
+  Status = TestPointCheckBootPerformance (
+             "DXE",
+             PcdGet32 (PcdTestPointDxePhaseBudget),
+             PcdGet32 (PcdTestPointDxeDriverBudget)
+             );
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_CODE \
+        TEST_POINT_READY_TO_BOOT \
+        TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_STRING
+      );
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      9,
+      TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the system state after Exit Boot Services is invoked.
 
@@ -1259,6 +1323,49 @@ TestPointExitBootServices (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the BDS boot performance after Exit Boot Services is invoked.
+
+  Test subject: BDS boot performance.
+  Test overview: Verify the BDS phase and every driver binding Start() in BDS complete
+                 within PcdTestPointBdsPhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Dumps the phase duration and the drivers over budget to the debug log.
+                       The TestPoint table cannot be updated after Exit Boot Services.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointExitBootServicesBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // Enabled together with the Ready To Boot check. No memory may be allocated
+  // here, so the result only goes to the debug log.
+  //
+  if ((mFeatureImplemented[9] & TEST_POINT_BYTE9_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointExitBootServicesBootPerformanceBudget - Enter\n"));
+
+  Status = TestPointCheckBootPerformance (
+             "BDS",
+             PcdGet32 (PcdTestPointBdsPhaseBudget),
+             PcdGet32 (PcdTestPointDxeDriverBudget)
+             );
+  if (EFI_ERROR(Status)) {
+    DEBUG ((DEBUG_ERROR, "BDS boot performance budget exceeded - %r\n", Status));
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointExitBootServicesBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize feature data.
 
@@ -0,0 +1,218 @@
+/** @file
+  Compares the PEI performance records against the board supplied boot
+  performance budgets.
+
+Copyright (c) 2019, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/TestPointLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PerformanceLib.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+
+#define BOOT_PERFORMANCE_MAX_OPEN_RECORDS  32
+#define BOOT_PERFORMANCE_NS_PER_MS         1000000
+
+typedef struct {
+  UINT16      ProgressID;
+  EFI_GUID    Guid;
+  UINT64      Timestamp;
+} BOOT_PERFORMANCE_OPEN_RECORD;
+
+/**
+  Return the next GUID event record in the PEI performance HOBs.
+
+  PeiPerformanceLib starts a new HOB when the current one is full, so the
+  records of one boot may span several HOBs. All the extended performance
+  records start with the FPDT_GUID_EVENT_RECORD layout, other record types
+  are skipped.
+
+  @param[in, out] GuidHob  Current PEI performance HOB, NULL at the end.
+  @param[in, out] Offset   Offset of the next record in the current HOB.
+
+  @return The next GUID event record, or NULL at the end of the records.
+**/
+FPDT_GUID_EVENT_RECORD *
+GetNextBootPerformanceRecord (
+  IN OUT EFI_HOB_GUID_TYPE  **GuidHob,
+  IN OUT UINTN              *Offset
+  )
+{
+  FPDT_PEI_EXT_PERF_HEADER                     *PeiPerformanceLogHeader;
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER  *Record;
+  UINT8                                        *Records;
+
+  while (*GuidHob != NULL) {
+    PeiPerformanceLogHeader = GET_GUID_HOB_DATA (*GuidHob);
+    Records                 = (UINT8 *)(PeiPerformanceLogHeader + 1);
+    while (*Offset + sizeof(*Record) <= PeiPerformanceLogHeader->SizeOfAllEntries) {
+      Record = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)(Records + *Offset);
+      if ((Record->Length == 0) || (*Offset + Record->Length > PeiPerformanceLogHeader->SizeOfAllEntries)) {
+        break;
+      }
+      *Offset += Record->Length;
+      if ((Record->Type >= FPDT_GUID_EVENT_TYPE) &&
+          (Record->Type <= FPDT_GUID_QWORD_STRING_EVENT_TYPE) &&
+          (Record->Length >= sizeof(FPDT_GUID_EVENT_RECORD))) {
+        return (FPDT_GUID_EVENT_RECORD *)Record;
+      }
+    }
+    *GuidHob = GetNextGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid, GET_NEXT_HOB (*GuidHob));
+    *Offset  = 0;
+  }
+
+  return NULL;
+}
+
+/**
+  Check if the record is the start or the end of a boot phase.
+
+  @param[in] Event      GUID event record.
+  @param[in] Phase      Boot phase name, such as "PEI".
+
+  @retval TRUE   The record is the cross module record of the phase.
+  @retval FALSE  The record is not the cross module record of the phase.
+**/
+BOOLEAN
+IsBootPhaseRecord (
+  IN FPDT_GUID_EVENT_RECORD  *Event,
+  IN CONST CHAR8             *Phase
+  )
+{
+  FPDT_DYNAMIC_STRING_EVENT_RECORD  *StringEvent;
+  UINTN                             StringSize;
+
+  if ((Event->Header.Type != FPDT_DYNAMIC_STRING_EVENT_TYPE) ||
+      ((Event->ProgressID != PERF_CROSSMODULE_START_ID) && (Event->ProgressID != PERF_CROSSMODULE_END_ID))) {
+    return FALSE;
+  }
+
+  StringEvent = (FPDT_DYNAMIC_STRING_EVENT_RECORD *)Event;
+  StringSize  = Event->Header.Length - OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String);
+  if (StringSize < AsciiStrSize (Phase)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(AsciiStrnCmp (StringEvent->String, Phase, AsciiStrSize (Phase)) == 0);
+}
+
+/**
+  Check the PEI phase and per-PEIM durations against the boot performance budgets.
+
+  The PEI phase is timed from its cross module start record to now. Every PEIM
+  entry point is checked against the PEIM budget.
+
+  @param[in] PhaseBudget   Budget of the PEI phase in milliseconds, 0 means no budget.
+  @param[in] PeimBudget    Budget of one PEIM entry point in milliseconds, 0 means no budget.
+
+  @retval EFI_SUCCESS    All measured durations are within budget.
+  @retval EFI_NOT_FOUND  No PEI performance record is found.
+  @retval EFI_TIMEOUT    At least one duration exceeds its budget.
+**/
+EFI_STATUS
+TestPointCheckBootPerformance (
+  IN UINT32  PhaseBudget,
+  IN UINT32  PeimBudget
+  )
+{
+  EFI_HOB_GUID_TYPE             *FirstGuidHob;
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  FPDT_GUID_EVENT_RECORD        *Event;
+  BOOT_PERFORMANCE_OPEN_RECORD  Open[BOOT_PERFORMANCE_MAX_OPEN_RECORDS];
+  UINTN                         OpenCount;
+  UINTN                         Index;
+  UINTN                         Offset;
+  UINT64                        Now;
+  UINT64                        PhaseStart;
+  UINT64                        Duration;
+  EFI_STATUS                    Status;
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Enter\n"));
+
+  Now          = GetTimeInNanoSecond (GetPerformanceCounter ());
+  FirstGuidHob = GetFirstGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid);
+  if (FirstGuidHob == NULL) {
+    DEBUG ((DEBUG_ERROR, "No PEI performance record\n"));
+    DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+    return EFI_NOT_FOUND;
+  }
+
+  Status     = EFI_SUCCESS;
+  PhaseStart = 0;
+  OpenCount  = 0;
+  GuidHob    = FirstGuidHob;
+  Offset     = 0;
+  while ((Event = GetNextBootPerformanceRecord (&GuidHob, &Offset)) != NULL) {
+    switch (Event->ProgressID) {
+    case PERF_CROSSMODULE_START_ID:
+      if (IsBootPhaseRecord (Event, "PEI")) {
+        PhaseStart = Event->Timestamp;
+      }
+      break;
+
+    case MODULE_START_ID:
+      if (PeimBudget == 0) {
+        break;
+      }
+      if (OpenCount == BOOT_PERFORMANCE_MAX_OPEN_RECORDS) {
+        DEBUG ((DEBUG_WARN, "Too many nested performance records, %g not checked\n", &Event->Guid));
+        break;
+      }
+      Open[OpenCount].ProgressID = Event->ProgressID;
+      Open[OpenCount].Timestamp  = Event->Timestamp;
+      CopyGuid (&Open[OpenCount].Guid, &Event->Guid);
+      OpenCount++;
+      break;
+
+    case MODULE_END_ID:
+      for (Index = OpenCount; Index > 0; Index--) {
+        if (CompareGuid (&Open[Index - 1].Guid, &Event->Guid)) {
+          break;
+        }
+      }
+      if (Index == 0) {
+        break;
+      }
+      Index--;
+      Duration = Event->Timestamp - Open[Index].Timestamp;
+      if (Duration > MultU64x32 (PeimBudget, BOOT_PERFORMANCE_NS_PER_MS)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%g Entry - %ld ms exceeds the PEIM budget %d ms\n",
+          &Event->Guid,
+          DivU64x32 (Duration, BOOT_PERFORMANCE_NS_PER_MS),
+          PeimBudget
+          ));
+        Status = EFI_TIMEOUT;
+      }
+      CopyMem (&Open[Index], &Open[Index + 1], (OpenCount - Index - 1) * sizeof(Open[0]));
+      OpenCount--;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  if (PhaseStart == 0) {
+    DEBUG ((DEBUG_WARN, "No PEI phase record, phase budget not checked\n"));
+  } else {
+    Duration = Now - PhaseStart;
+    DEBUG ((DEBUG_INFO, "PEI phase - %ld ms (budget %d ms)\n", DivU64x32 (Duration, BOOT_PERFORMANCE_NS_PER_MS), PhaseBudget));
+    if ((PhaseBudget != 0) && (Duration > MultU64x32 (PhaseBudget, BOOT_PERFORMANCE_NS_PER_MS))) {
+      DEBUG ((DEBUG_ERROR, "PEI phase exceeds its budget\n"));
+      Status = EFI_TIMEOUT;
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+  return Status;
+}
@@ -52,6 +52,12 @@ TestPointVtdEngine (
   VOID
   );
 
+EFI_STATUS
+TestPointCheckBootPerformance (
+  IN UINT32  PhaseBudget,
+  IN UINT32  PeimBudget
+  );
+
 GLOBAL_REMOVE_IF_UNREFERENCED ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT  mTestPointStruct = {
   PLATFORM_TEST_POINT_VERSION,
   PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
@@ -469,6 +475,64 @@ TestPointEndOfPeiPciBusMasterDisabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the PEI boot performance at the end of PEI.
+
+  Test subject: PEI boot performance.
+  Test overview: Verify the PEI phase and every PEIM entry point complete within
+                 PcdTestPointPeiPhaseBudget and PcdTestPointPeimBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the PEIMs over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+  UINT8       *FeatureImplemented;
+
+  FeatureImplemented = GetFeatureImplemented ();
+
+  if ((FeatureImplemented[9] & TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfPeiBootPerformanceBudget - Enter\n"));
+  Result = TRUE;
+  Status = TestPointCheckBootPerformance (
+             PcdGet32 (PcdTestPointPeiPhaseBudget),
+             PcdGet32 (PcdTestPointPeimBudget)
+             );
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET_ERROR_CODE \
+        TEST_POINT_END_OF_PEI \
+        TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET_ERROR_STRING
+      );
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      9,
+      TEST_POINT_BYTE9_END_OF_PEI_BOOT_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfPeiBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize feature data.
 
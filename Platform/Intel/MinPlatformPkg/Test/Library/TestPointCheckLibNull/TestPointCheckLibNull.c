@@ -193,6 +193,27 @@ TestPointEndOfPeiPciBusMasterDisabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the PEI boot performance at the end of PEI.
+
+  Test subject: PEI boot performance.
+  Test overview: Verify the PEI phase and every PEIM entry point complete within
+                 PcdTestPointPeiPhaseBudget and PcdTestPointPeimBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the PEIMs over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies bus master enable (BME) is disabled after PCI enumeration.
 
@@ -595,6 +616,27 @@ TestPointReadyToBootTcgMorEnabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the DXE boot performance at Ready To Boot.
+
+  Test subject: DXE boot performance.
+  Test overview: Verify the DXE phase and every DXE driver entry point and driver binding
+                 Start() complete within PcdTestPointDxePhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the phase duration and the drivers over budget to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies SMI handler profiling.
 
@@ -710,6 +752,27 @@ TestPointExitBootServices (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the BDS boot performance after Exit Boot Services is invoked.
+
+  Test subject: BDS boot performance.
+  Test overview: Verify the BDS phase and every driver binding Start() in BDS complete
+                 within PcdTestPointBdsPhaseBudget and PcdTestPointDxeDriverBudget.
+  Reporting mechanism: Dumps the phase duration and the drivers over budget to the debug log.
+                       The TestPoint table cannot be updated after Exit Boot Services.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointExitBootServicesBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the system state within SMM after Exit Boot Services is invoked.
 
@@ -14,6 +14,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/TestPointLib.h>
 #include <Protocol/AdapterInformation.h>
+#include <Protocol/SmmCommunication.h>
+#include <Guid/PiSmmCommunicationRegionTable.h>
+#include <Guid/SmiLatencyProfile.h>
+
+//
+// Time used to calibrate the TSC against gBS->Stall(), in microseconds
+//
+#define TSC_CALIBRATION_TIME  10000
 
 VOID
 DumpTestPoint (
@@ -159,6 +167,218 @@ DumpTestPointDataDxe (
   FreePool (Handles);
 }
 
+/**
+  Get the SMI latency profile database from SMM.
+
+  @param[out] DatabaseSize  Size of the returned database
+
+  @return The database, or NULL if it is not available. The caller frees it.
+**/
+VOID *
+GetSmiLatencyProfileDatabase (
+  OUT UINTN                   *DatabaseSize
+  )
+{
+  EFI_STATUS                                        Status;
+  UINTN                                             CommSize;
+  UINT8                                             *CommBuffer;
+  EFI_SMM_COMMUNICATE_HEADER                        *CommHeader;
+  SMI_LATENCY_PROFILE_PARAMETER_GET_INFO            *CommGetInfo;
+  SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET  *CommGetData;
+  EFI_SMM_COMMUNICATION_PROTOCOL                    *SmmCommunication;
+  EDKII_PI_SMM_COMMUNICATION_REGION_TABLE           *PiSmmCommunicationRegionTable;
+  EFI_MEMORY_DESCRIPTOR                             *Entry;
+  UINT32                                            Index;
+  VOID                                              *Database;
+  UINTN                                             Size;
+  UINTN                                             Offset;
+
+  Status = gBS->LocateProtocol (&gEfiSmmCommunicationProtocolGuid, NULL, (VOID **)&SmmCommunication);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Status = EfiGetSystemConfigurationTable (
+             &gEdkiiPiSmmCommunicationRegionTableGuid,
+             (VOID **)&PiSmmCommunicationRegionTable
+             );
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+  Entry = (EFI_MEMORY_DESCRIPTOR *)(PiSmmCommunicationRegionTable + 1);
+  Size = 0;
+  for (Index = 0; Index < PiSmmCommunicationRegionTable->NumberOfEntries; Index++) {
+    if (Entry->Type == EfiConventionalMemory) {
+      Size = EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages);
+      if (Size >= EFI_PAGE_SIZE) {
+        break;
+      }
+    }
+    Entry = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)Entry + PiSmmCommunicationRegionTable->DescriptorSize);
+  }
+  if (Index == PiSmmCommunicationRegionTable->NumberOfEntries) {
+    return NULL;
+  }
+  CommBuffer = (UINT8 *)(UINTN)Entry->PhysicalStart;
+
+  //
+  // Get Size
+  //
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&CommBuffer[0];
+  CopyMem (&CommHeader->HeaderGuid, &gSmiLatencyProfileGuid, sizeof (gSmiLatencyProfileGuid));
+  CommHeader->MessageLength = sizeof (SMI_LATENCY_PROFILE_PARAMETER_GET_INFO);
+
+  CommGetInfo = (SMI_LATENCY_PROFILE_PARAMETER_GET_INFO *)&CommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  CommGetInfo->Header.Command      = SMI_LATENCY_PROFILE_COMMAND_GET_INFO;
+  CommGetInfo->Header.DataLength   = sizeof (*CommGetInfo);
+  CommGetInfo->Header.ReturnStatus = (UINT64)-1;
+  CommGetInfo->DataSize            = 0;
+
+  CommSize = OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data) + (UINTN)CommHeader->MessageLength;
+  Status = SmmCommunication->Communicate (SmmCommunication, CommBuffer, &CommSize);
+  if (EFI_ERROR (Status) || (CommGetInfo->Header.ReturnStatus != 0)) {
+    return NULL;
+  }
+
+  *DatabaseSize = (UINTN)CommGetInfo->DataSize;
+  Database = AllocateZeroPool (*DatabaseSize);
+  if (Database == NULL) {
+    return NULL;
+  }
+
+  //
+  // Get Data
+  //
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&CommBuffer[0];
+  CopyMem (&CommHeader->HeaderGuid, &gSmiLatencyProfileGuid, sizeof (gSmiLatencyProfileGuid));
+  CommHeader->MessageLength = sizeof (SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET);
+
+  CommGetData = (SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET *)&CommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  CommGetData->Header.Command      = SMI_LATENCY_PROFILE_COMMAND_GET_DATA_BY_OFFSET;
+  CommGetData->Header.DataLength   = sizeof (*CommGetData);
+  CommGetData->Header.ReturnStatus = (UINT64)-1;
+
+  CommSize = OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data) + (UINTN)CommHeader->MessageLength;
+  CommGetData->DataBuffer = (PHYSICAL_ADDRESS)(UINTN)((UINT8 *)CommHeader + CommSize);
+  Size -= CommSize;
+
+  CommGetData->DataOffset = 0;
+  while (CommGetData->DataOffset < *DatabaseSize) {
+    Offset = (UINTN)CommGetData->DataOffset;
+    CommGetData->DataSize = (UINT64)MIN (Size, *DatabaseSize - Offset);
+    Status = SmmCommunication->Communicate (SmmCommunication, CommBuffer, &CommSize);
+    if (EFI_ERROR (Status) || (CommGetData->Header.ReturnStatus != 0)) {
+      FreePool (Database);
+      return NULL;
+    }
+    CopyMem ((UINT8 *)Database + Offset, (VOID *)(UINTN)CommGetData->DataBuffer, (UINTN)CommGetData->DataSize);
+  }
+
+  return Database;
+}
+
+/**
+  Dump one set of SMI latency statistics.
+
+  @param[in] Statistics    Latency statistics
+  @param[in] TscPerUs      TSC cycles per microsecond
+**/
+VOID
+DumpSmiLatencyStatistics (
+  IN SMI_LATENCY_STATISTICS   *Statistics,
+  IN UINT64                   TscPerUs
+  )
+{
+  UINTN                       Index;
+
+  Print (L"    Count                     - %ld\n", Statistics->Count);
+  if (Statistics->Count == 0) {
+    return;
+  }
+  Print (
+    L"    Average                   - %ld cycles (%ld us)\n",
+    DivU64x64Remainder (Statistics->TotalCycles, Statistics->Count, NULL),
+    DivU64x64Remainder (Statistics->TotalCycles, MultU64x64 (Statistics->Count, TscPerUs), NULL)
+    );
+  Print (
+    L"    Max                       - %ld cycles (%ld us)\n",
+    Statistics->MaxCycles,
+    DivU64x64Remainder (Statistics->MaxCycles, TscPerUs, NULL)
+    );
+  for (Index = 0; Index < SMI_LATENCY_HISTOGRAM_BUCKETS; Index++) {
+    if (Statistics->Histogram[Index] == 0) {
+      continue;
+    }
+    if (Index == SMI_LATENCY_HISTOGRAM_BUCKETS - 1) {
+      Print (
+        L"    >= %9ld us               - %d\n",
+        DivU64x64Remainder (LShiftU64 (1, Index), TscPerUs, NULL),
+        Statistics->Histogram[Index]
+        );
+    } else {
+      Print (
+        L"    < %10ld us               - %d\n",
+        DivU64x64Remainder (LShiftU64 (1, Index + 1), TscPerUs, NULL),
+        Statistics->Histogram[Index]
+        );
+    }
+  }
+}
+
+/**
+  Dump the SMI latency profile collected by the SMI dispatcher.
+**/
+VOID
+DumpSmiLatencyProfile (
+  VOID
+  )
+{
+  SMI_LATENCY_PROFILE_DATABASE  *Database;
+  SMI_LATENCY_CHILD_RECORD      *Child;
+  UINTN                         DatabaseSize;
+  UINT64                        TscPerUs;
+  UINT64                        Tsc;
+  UINTN                         Index;
+
+  Database = GetSmiLatencyProfileDatabase (&DatabaseSize);
+  if (Database == NULL) {
+    return;
+  }
+  if ((DatabaseSize < sizeof (SMI_LATENCY_PROFILE_DATABASE)) ||
+      (Database->Signature != SMI_LATENCY_PROFILE_SIGNATURE) ||
+      (Database->ChildCount > (DatabaseSize - sizeof (SMI_LATENCY_PROFILE_DATABASE)) / sizeof (SMI_LATENCY_CHILD_RECORD))) {
+    FreePool (Database);
+    return;
+  }
+
+  //
+  // SMM and DXE run on the same TSC, so calibrate it here.
+  //
+  Tsc = AsmReadTsc ();
+  gBS->Stall (TSC_CALIBRATION_TIME);
+  TscPerUs = DivU64x32 (AsmReadTsc () - Tsc, TSC_CALIBRATION_TIME);
+  if (TscPerUs == 0) {
+    TscPerUs = 1;
+  }
+
+  Print (L"SmiLatencyProfile\n");
+  Print (L"  TscFrequency                - %ld MHz\n", TscPerUs);
+  Print (L"  Dispatcher\n");
+  DumpSmiLatencyStatistics (&Database->Dispatcher, TscPerUs);
+
+  Child = (SMI_LATENCY_CHILD_RECORD *)(Database + 1);
+  for (Index = 0; Index < Database->ChildCount; Index++, Child++) {
+    Print (L"  Child %d\n", Child->Index);
+    Print (L"    ImageGuid                 - %g\n", &Child->ImageGuid);
+    Print (L"    ProtocolGuid              - %g\n", &Child->ProtocolGuid);
+    Print (L"    ProtocolType              - 0x%08x\n", Child->ProtocolType);
+    Print (L"    SubType                   - 0x%08x\n", Child->SubType);
+    DumpSmiLatencyStatistics (&Child->Statistics, TscPerUs);
+  }
+
+  FreePool (Database);
+}
+
 EFI_STATUS
 EFIAPI
 TestPointDumpAppEntrypoint (
@@ -167,6 +387,7 @@ TestPointDumpAppEntrypoint (
   )
 {
   DumpTestPointDataDxe (0, NULL);
+  DumpSmiLatencyProfile ();
 
   return EFI_SUCCESS;
 }
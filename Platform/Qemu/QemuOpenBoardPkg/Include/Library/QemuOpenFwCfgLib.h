@@ -74,7 +74,10 @@ QemuFwCfgRead8 (
   );
 
 /**
-  Reads N bytes from the data register
+  Reads N bytes from the currently selected item
+
+  Uses the DMA interface when the device advertises it, and falls back to
+  the data register otherwise.
 
   @param Size
   @param Buffer
@@ -86,9 +89,27 @@ QemuFwCfgReadBytes (
   OUT VOID  *Buffer
   );
 
+/**
+  Checks whether the fw_cfg DMA interface is available
+
+  Only reports TRUE once the device has been probed by QemuFwCfgIsPresent or
+  QemuFwCfgFindFile in the current phase.
+
+  @return TRUE  - Reads are done through the DMA interface
+  @return FALSE - Reads are done through the data register
+ */
+BOOLEAN
+EFIAPI
+QemuFwCfgIsDmaAvailable (
+  VOID
+  );
+
 /**
   Finds a file in fw_cfg by its name
 
+  The file directory is read once per phase and cached in a HOB, later
+  lookups are resolved from that cache.
+
   @param[in]  String Pointer to an ASCII string to match in the database
   @param[out] FWConfigFile Buffer for the config file
 
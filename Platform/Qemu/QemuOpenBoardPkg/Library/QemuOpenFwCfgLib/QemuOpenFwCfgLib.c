@@ -11,8 +11,92 @@
 **/
 
 #include <Library/QemuOpenFwCfgLib.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <IndustryStandard/QemuFwCfg.h>
+#include "QemuOpenFwCfgLibInternal.h"
+
+/**
+  Returns the fw_cfg cache HOB of the current phase, if it was already built.
+
+  @retval NULL    The cache has not been built yet
+  @retval Others  Pointer to the cache
+**/
+STATIC
+FW_CFG_CACHE *
+QemuFwCfgGetCache (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  GuidHob = GetFirstGuidHob (&gQemuOpenFwCfgCacheHobGuid);
+  if (GuidHob == NULL) {
+    return NULL;
+  }
+
+  return (FW_CFG_CACHE *)GET_GUID_HOB_DATA (GuidHob);
+}
+
+/**
+  Transfers Size bytes from the currently selected item using the DMA interface.
+
+  @param Size     Number of bytes to transfer
+  @param Buffer   Destination buffer
+  @param Control  FW_CFG_DMA_CTL_* operation
+
+  @retval TRUE   The transfer completed
+  @retval FALSE  The device reported an error, Buffer may be partially written
+**/
+STATIC
+BOOLEAN
+QemuFwCfgDmaBytes (
+  IN UINT32  Size,
+  OUT VOID   *Buffer,
+  IN UINT32  Control
+  )
+{
+  volatile FW_CFG_DMA_ACCESS  Access;
+  UINT64                      AccessAddress;
+  UINT32                      Status;
+
+  if (Size == 0) {
+    return TRUE;
+  }
+
+  //
+  // All fields of the access structure are big endian
+  //
+  Access.Control = SwapBytes32 (Control);
+  Access.Length  = SwapBytes32 (Size);
+  Access.Address = SwapBytes64 ((UINT64)(UINTN)Buffer);
+
+  //
+  // Make sure the access structure is written before the device reads it
+  //
+  MemoryFence ();
+
+  //
+  // Writing the low half of the address starts the transfer
+  //
+  AccessAddress = (UINT64)(UINTN)&Access;
+  IoWrite32 (FW_CFG_PORT_DMA, SwapBytes32 ((UINT32)RShiftU64 (AccessAddress, 32)));
+  IoWrite32 (FW_CFG_PORT_DMA + 4, SwapBytes32 ((UINT32)AccessAddress));
+
+  //
+  // QEMU completes the transfer synchronously, the control field is cleared
+  // (or has only the error bit set) once the data is in the buffer
+  //
+  do {
+    Status = SwapBytes32 (Access.Control);
+  } while ((Status & ~(UINT32)FW_CFG_DMA_CTL_ERROR) != 0);
+
+  MemoryFence ();
+
+  return (BOOLEAN)((Status & FW_CFG_DMA_CTL_ERROR) == 0);
+}
 
 /**
   Reads 8 bits from the data register.
@@ -25,6 +109,13 @@ QemuFwCfgRead8 (
   VOID
   )
 {
+  FW_CFG_CACHE  *Cache;
+
+  Cache = QemuFwCfgGetCache ();
+  if (Cache != NULL) {
+    Cache->Offset++;
+  }
+
   return IoRead8 (FW_CFG_PORT_DATA);
 }
 
@@ -42,10 +133,17 @@ QemuFwCfgSelectItem (
   IN UINT16  Selector
   )
 {
-  UINT16  WritenSelector;
+  FW_CFG_CACHE  *Cache;
+  UINT16        WritenSelector;
 
   WritenSelector = IoWrite16 (FW_CFG_PORT_SEL, Selector);
 
+  Cache = QemuFwCfgGetCache ();
+  if (Cache != NULL) {
+    Cache->Selector = Selector;
+    Cache->Offset   = 0;
+  }
+
   if (WritenSelector != Selector) {
     return EFI_UNSUPPORTED;
   }
@@ -54,7 +152,32 @@ QemuFwCfgSelectItem (
 }
 
 /**
-  Reads N bytes from the data register
+  Checks whether the fw_cfg DMA interface is available
+
+  @retval TRUE  - Reads are done through the DMA interface
+  @retval FALSE - Reads are done through the data register
+**/
+BOOLEAN
+EFIAPI
+QemuFwCfgIsDmaAvailable (
+  VOID
+  )
+{
+  FW_CFG_CACHE  *Cache;
+
+  Cache = QemuFwCfgGetCache ();
+  if (Cache == NULL) {
+    return FALSE;
+  }
+
+  return (Cache->Features & FW_CFG_F_DMA) != 0;
+}
+
+/**
+  Reads N bytes from the currently selected item
+
+  If a DMA transfer fails, DMA is disabled for the rest of the phase and the
+  read is redone through the data register from the same item offset.
 
   @param Size
   @param Buffer
@@ -66,12 +189,157 @@ QemuFwCfgReadBytes (
   OUT VOID  *Buffer
   )
 {
+  FW_CFG_CACHE  *Cache;
+  UINT32        Skip;
+
+  Cache = QemuFwCfgGetCache ();
+  if (Cache == NULL) {
+    IoReadFifo8 (FW_CFG_PORT_DATA, Size, Buffer);
+    return;
+  }
+
+  if (((Cache->Features & FW_CFG_F_DMA) != 0) && (Size <= MAX_UINT32)) {
+    if (QemuFwCfgDmaBytes ((UINT32)Size, Buffer, FW_CFG_DMA_CTL_READ)) {
+      Cache->Offset += (UINT32)Size;
+      return;
+    }
+
+    DEBUG ((
+      DEBUG_ERROR,
+      "fw_cfg DMA read of item %x failed, falling back to the data register\n",
+      Cache->Selector
+      ));
+    Cache->Features &= ~(UINT32)FW_CFG_F_DMA;
+
+    //
+    // The item offset is unknown after a failed transfer, select the item
+    // again and skip what the caller already consumed
+    //
+    IoWrite16 (FW_CFG_PORT_SEL, Cache->Selector);
+    for (Skip = 0; Skip < Cache->Offset; Skip++) {
+      IoRead8 (FW_CFG_PORT_DATA);
+    }
+  }
+
   IoReadFifo8 (FW_CFG_PORT_DATA, Size, Buffer);
+  Cache->Offset += (UINT32)Size;
+}
+
+/**
+  Computes the FNV-1a hash of a file name, used to index the directory cache.
+
+  @param Name  Pointer to a NUL terminated ASCII string
+
+  @retval Hash of the string
+**/
+STATIC
+UINT32
+QemuFwCfgHashName (
+  IN CONST CHAR8  *Name
+  )
+{
+  UINT32  Hash;
+  UINTN   Idx;
+
+  Hash = 0x811C9DC5;
+  for (Idx = 0; Idx < sizeof (((QEMU_FW_CFG_FILE *)0)->Name) && Name[Idx] != '\0'; Idx++) {
+    Hash ^= (UINT8)Name[Idx];
+    Hash *= 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Builds the cache HOB holding the feature bitmap and the file directory.
+
+  The directory is read once and indexed by name hash. If it does not fit in a
+  HOB, only the feature bitmap is cached and lookups fall back to a linear scan.
+
+  @retval NULL    The HOB could not be created
+  @retval Others  Pointer to the cache
+**/
+STATIC
+FW_CFG_CACHE *
+QemuFwCfgBuildCache (
+  VOID
+  )
+{
+  FW_CFG_CACHE      *Cache;
+  QEMU_FW_CFG_FILE  *Files;
+  UINT16            *Next;
+  UINT32            Features;
+  UINT32            FilesCount;
+  UINTN             CacheSize;
+  UINT32            Bucket;
+  UINT32            Idx;
+
+  //
+  // The feature bitmap is little endian, unlike the rest of the interface
+  //
+  QemuFwCfgSelectItem (FW_CFG_ID);
+  IoReadFifo8 (FW_CFG_PORT_DATA, sizeof (Features), &Features);
+
+  QemuFwCfgSelectItem (FW_CFG_FILE_DIR);
+  IoReadFifo8 (FW_CFG_PORT_DATA, sizeof (FilesCount), &FilesCount);
+  FilesCount = SwapBytes32 (FilesCount);
+
+  CacheSize = sizeof (FW_CFG_CACHE) + (UINTN)FilesCount * (sizeof (QEMU_FW_CFG_FILE) + sizeof (UINT16));
+  if ((FilesCount >= FW_CFG_CACHE_END) || (CacheSize > FW_CFG_CACHE_MAX_SIZE)) {
+    DEBUG ((DEBUG_WARN, "fw_cfg directory too large to cache (%u files)\n", FilesCount));
+    FilesCount = 0;
+    CacheSize  = sizeof (FW_CFG_CACHE);
+  }
+
+  Cache = BuildGuidHob (&gQemuOpenFwCfgCacheHobGuid, CacheSize);
+  if (Cache == NULL) {
+    return NULL;
+  }
+
+  Cache->Features        = Features;
+  Cache->FileCount       = FilesCount;
+  Cache->Selector        = FW_CFG_FILE_DIR;
+  Cache->Offset          = sizeof (FilesCount);
+  Cache->DirectoryCached = (BOOLEAN)(CacheSize != sizeof (FW_CFG_CACHE));
+  SetMem16 (Cache->Buckets, sizeof (Cache->Buckets), FW_CFG_CACHE_END);
+
+  if (!Cache->DirectoryCached) {
+    return Cache;
+  }
+
+  //
+  // Read the whole directory in one go, right after the file count
+  //
+  Files = FW_CFG_CACHE_FILES (Cache);
+  Next  = FW_CFG_CACHE_NEXT (Cache);
+  QemuFwCfgReadBytes (FilesCount * sizeof (QEMU_FW_CFG_FILE), Files);
+
+  for (Idx = 0; Idx < FilesCount; Idx++) {
+    Files[Idx].Size   = SwapBytes32 (Files[Idx].Size);
+    Files[Idx].Select = SwapBytes16 (Files[Idx].Select);
+    Files[Idx].Name[sizeof (Files[Idx].Name) - 1] = '\0';
+
+    Bucket                 = QemuFwCfgHashName (Files[Idx].Name) % FW_CFG_CACHE_BUCKETS;
+    Next[Idx]              = Cache->Buckets[Bucket];
+    Cache->Buckets[Bucket] = (UINT16)Idx;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "fw_cfg features %x, %u files cached\n",
+    Features,
+    FilesCount
+    ));
+
+  return Cache;
 }
 
 /**
   Checks for Qemu fw_cfg device by reading "QEMU" using the signature selector
 
+  On success, the feature bitmap and file directory are cached for the
+  current phase.
+
   @retval EFI_SUCCESS - The fw_cfg device is present
   @retval EFI_UNSUPPORTED - The device is absent
 **/
@@ -83,6 +351,10 @@ QemuFwCfgIsPresent (
   EFI_STATUS  Status;
   UINT32      Control;
 
+  if (QemuFwCfgGetCache () != NULL) {
+    return EFI_SUCCESS;
+  }
+
   Status = QemuFwCfgSelectItem (FW_CFG_SIGNATURE);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -94,11 +366,12 @@ QemuFwCfgIsPresent (
     return EFI_UNSUPPORTED;
   }
 
+  QemuFwCfgBuildCache ();
   return EFI_SUCCESS;
 }
 
 /**
-  Finds a file in fw_cfg by its name
+  Finds a file by scanning the fw_cfg directory on the device
 
   @param String Pointer to an ASCII string to match in the database
   @param FWConfigFile Buffer for the config file
@@ -106,9 +379,9 @@ QemuFwCfgIsPresent (
   @retval EFI_STATUS Entry was found, FWConfigFile is populated
   @retval EFI_ERROR Entry was not found
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-QemuFwCfgFindFile (
+QemuFwCfgScanFile (
   IN  CHAR8             *String,
   OUT QEMU_FW_CFG_FILE  *FWConfigFile
   )
@@ -134,3 +407,49 @@ QemuFwCfgFindFile (
 
   return EFI_UNSUPPORTED;
 }
+
+/**
+  Finds a file in fw_cfg by its name
+
+  @param String Pointer to an ASCII string to match in the database
+  @param FWConfigFile Buffer for the config file
+
+  @retval EFI_STATUS Entry was found, FWConfigFile is populated
+  @retval EFI_ERROR Entry was not found
+**/
+EFI_STATUS
+EFIAPI
+QemuFwCfgFindFile (
+  IN  CHAR8             *String,
+  OUT QEMU_FW_CFG_FILE  *FWConfigFile
+  )
+{
+  FW_CFG_CACHE      *Cache;
+  QEMU_FW_CFG_FILE  *Files;
+  UINT16            *Next;
+  UINT16            Idx;
+
+  Cache = QemuFwCfgGetCache ();
+  if (Cache == NULL) {
+    Cache = QemuFwCfgBuildCache ();
+  }
+
+  if ((Cache == NULL) || !Cache->DirectoryCached) {
+    return QemuFwCfgScanFile (String, FWConfigFile);
+  }
+
+  Files = FW_CFG_CACHE_FILES (Cache);
+  Next  = FW_CFG_CACHE_NEXT (Cache);
+  Idx   = Cache->Buckets[QemuFwCfgHashName (String) % FW_CFG_CACHE_BUCKETS];
+
+  while (Idx != FW_CFG_CACHE_END) {
+    if (AsciiStrnCmp (Files[Idx].Name, String, sizeof (Files[Idx].Name)) == 0) {
+      CopyMem (FWConfigFile, &Files[Idx], sizeof (QEMU_FW_CFG_FILE));
+      return EFI_SUCCESS;
+    }
+
+    Idx = Next[Idx];
+  }
+
+  return EFI_UNSUPPORTED;
+}
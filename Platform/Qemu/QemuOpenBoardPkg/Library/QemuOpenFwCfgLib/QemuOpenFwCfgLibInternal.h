@@ -0,0 +1,53 @@
+/** @file QemuOpenFwCfgLibInternal.h
+  QemuOpenFwCfgLib internal definitions
+
+  Describes the HOB used to cache the fw_cfg feature bitmap and file
+  directory for the current boot phase.
+
+  Copyright (c) 2022 Theo Jehl All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef QEMU_OPEN_BOARD_PKG_QEMU_FW_CFG_LIB_INTERNAL_H_
+#define QEMU_OPEN_BOARD_PKG_QEMU_FW_CFG_LIB_INTERNAL_H_
+
+#include <Library/QemuOpenFwCfgLib.h>
+
+//
+// Number of hash buckets used to index the cached file directory
+//
+#define FW_CFG_CACHE_BUCKETS  64
+
+//
+// Terminates a bucket chain
+//
+#define FW_CFG_CACHE_END  MAX_UINT16
+
+//
+// Cache HOB layout:
+//   FW_CFG_CACHE header
+//   QEMU_FW_CFG_FILE Files[FileCount]   (Size and Select in CPU byte order)
+//   UINT16           Next[FileCount]    (bucket chain links)
+//
+// Selector and Offset track the position in the selected item, so a failed
+// DMA transfer can be redone through the data register.
+//
+typedef struct {
+  UINT32     Features;
+  UINT32     FileCount;
+  UINT32     Offset;
+  UINT16     Selector;
+  BOOLEAN    DirectoryCached;
+  UINT8      Reserved;
+  UINT16     Buckets[FW_CFG_CACHE_BUCKETS];
+} FW_CFG_CACHE;
+
+#define FW_CFG_CACHE_FILES(Cache)  ((QEMU_FW_CFG_FILE *)((Cache) + 1))
+#define FW_CFG_CACHE_NEXT(Cache)   ((UINT16 *)(FW_CFG_CACHE_FILES (Cache) + (Cache)->FileCount))
+
+//
+// A GUIDed HOB cannot be larger than 64KB, including its header
+//
+#define FW_CFG_CACHE_MAX_SIZE  (0xFFF8 - sizeof (EFI_HOB_GUID_TYPE))
+
+#endif // QEMU_OPEN_BOARD_PKG_QEMU_FW_CFG_LIB_INTERNAL_H_
@@ -13,6 +13,45 @@
 #include <IndustryStandard/E820.h>
 #include <Library/PcdLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+/**
+  Read the whole etc/e820 file in a single fw_cfg transfer.
+
+  @param[out] EntryCount  Number of E820 entries in the returned table.
+
+  @retval NULL    etc/e820 was not found or could not be read.
+  @retval Others  Pointer to the E820 table, to be freed with FreePool.
+**/
+STATIC
+EFI_E820_ENTRY64 *
+ReadE820Table (
+  OUT UINT32  *EntryCount
+  )
+{
+  EFI_STATUS        Status;
+  QEMU_FW_CFG_FILE  FwCfgFile;
+  EFI_E820_ENTRY64  *E820Table;
+
+  Status = QemuFwCfgFindFile ("etc/e820", &FwCfgFile);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  *EntryCount = FwCfgFile.Size / sizeof (EFI_E820_ENTRY64);
+  if (*EntryCount == 0) {
+    return NULL;
+  }
+
+  E820Table = AllocatePool (*EntryCount * sizeof (EFI_E820_ENTRY64));
+  if (E820Table == NULL) {
+    return NULL;
+  }
+
+  QemuFwCfgSelectItem (FwCfgFile.Select);
+  QemuFwCfgReadBytes (*EntryCount * sizeof (EFI_E820_ENTRY64), E820Table);
+  return E820Table;
+}
 
 /**
   Return the memory size below 4GB.
@@ -25,8 +64,8 @@ GetMemoryBelow4Gb (
   VOID
   )
 {
-  EFI_E820_ENTRY64  E820Entry;
-  QEMU_FW_CFG_FILE  FwCfgFile;
+  EFI_E820_ENTRY64  *E820Table;
+  UINT32            EntryCount;
   UINT32            Processed;
   UINT64            Size;
   EFI_STATUS        Status;
@@ -36,27 +75,26 @@ GetMemoryBelow4Gb (
     return Status;
   }
 
-  Status = QemuFwCfgFindFile ("etc/e820", &FwCfgFile);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  E820Table = ReadE820Table (&EntryCount);
+  if (E820Table == NULL) {
+    return EFI_UNSUPPORTED;
   }
 
   Size = 0;
-  QemuFwCfgSelectItem (FwCfgFile.Select);
-  for (Processed = 0; Processed < FwCfgFile.Size / sizeof (EFI_E820_ENTRY); Processed++) {
-    QemuFwCfgReadBytes (sizeof (EFI_E820_ENTRY), &E820Entry);
-    if (E820Entry.Type != EfiAcpiAddressRangeMemory) {
+  for (Processed = 0; Processed < EntryCount; Processed++) {
+    if (E820Table[Processed].Type != EfiAcpiAddressRangeMemory) {
       continue;
     }
 
-    if (E820Entry.BaseAddr + E820Entry.Length < SIZE_4GB) {
-      Size += E820Entry.Length;
+    if (E820Table[Processed].BaseAddr + E820Table[Processed].Length < SIZE_4GB) {
+      Size += E820Table[Processed].Length;
     } else {
-      ASSERT (Size == (UINT32)Size);
-      return (UINT32) Size;
+      break;
     }
   }
 
+  FreePool (E820Table);
+
   ASSERT (Size == (UINT32)Size);
   return (UINT32) Size;
 }
@@ -108,7 +146,8 @@ InstallMemory (
   CONST EFI_PEI_SERVICES       **PeiServicesTable;
   EFI_E820_ENTRY64             E820Entry;
   EFI_E820_ENTRY64             LargestE820Entry;
-  QEMU_FW_CFG_FILE             FwCfgFile;
+  EFI_E820_ENTRY64             *E820Table;
+  UINT32                       EntryCount;
   UINT32                       Processed;
   BOOLEAN                      ValidMemory;
   EFI_RESOURCE_TYPE            ResourceType;
@@ -124,8 +163,8 @@ InstallMemory (
     DEBUG ((DEBUG_INFO, "QEMU fw_cfg device is present\n"));
   }
 
-  Status = QemuFwCfgFindFile ("etc/e820", &FwCfgFile);
-  if (EFI_ERROR (Status)) {
+  E820Table = ReadE820Table (&EntryCount);
+  if (E820Table == NULL) {
     DEBUG ((DEBUG_ERROR, "etc/e820 was not found \n"));
     return EFI_UNSUPPORTED;
   }
@@ -133,9 +172,8 @@ InstallMemory (
   MemoryBelow4G = GetMemoryBelow4Gb ();
 
   LargestE820Entry.Length = 0;
-  QemuFwCfgSelectItem (FwCfgFile.Select);
-  for (Processed = 0; Processed < FwCfgFile.Size / sizeof (EFI_E820_ENTRY); Processed++) {
-    QemuFwCfgReadBytes (sizeof (EFI_E820_ENTRY), &E820Entry);
+  for (Processed = 0; Processed < EntryCount; Processed++) {
+    CopyMem (&E820Entry, &E820Table[Processed], sizeof (EFI_E820_ENTRY64));
 
     ValidMemory        = E820Entry.Type == EfiAcpiAddressRangeMemory;
     ResourceType       = EFI_RESOURCE_MEMORY_RESERVED;
@@ -224,6 +262,8 @@ InstallMemory (
       ));
   }
 
+  FreePool (E820Table);
+
   ASSERT (LargestE820Entry.Length != 0);
   DEBUG ((
     DEBUG_INFO,
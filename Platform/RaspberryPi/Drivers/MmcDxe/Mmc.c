@@ -9,6 +9,7 @@
  *
  **/
 
+#include <Guid/EventGroup.h>
 #include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
@@ -45,6 +46,12 @@ LIST_ENTRY  mMmcHostPool;
 
 EFI_EVENT gCheckCardsEvent;
 
+/**
+  Event signaled at ExitBootServices to write back cached blocks
+**/
+
+EFI_EVENT mExitBootServicesEvent;
+
 /**
   Initialize the MMC Host Pool to support multiple MMC devices
 **/
@@ -164,6 +171,10 @@ EFI_STATUS DestroyMmcHostInstance (
   ASSERT_EFI_ERROR (Status);
 
   // Free Memory allocated for the instance
+  if (MmcHostInstance->WriteCache) {
+    MmcFlushWriteCache (MmcHostInstance);
+    FreePool (MmcHostInstance->WriteCache);
+  }
   if (MmcHostInstance->BlockIo.Media) {
     FreePool (MmcHostInstance->BlockIo.Media);
   }
@@ -363,6 +374,8 @@ CheckCardsCallback (
     ASSERT (MmcHostInstance != NULL);
 
     if (MmcHostInstance->MmcHost->IsCardPresent (MmcHostInstance->MmcHost) == !MmcHostInstance->Initialized) {
+      // Cached writes belong to the card that went away
+      MmcHostInstance->WriteCacheBlocks = 0;
       MmcHostInstance->State = MmcHwInitializationState;
       MmcHostInstance->BlockIo.Media->MediaPresent = !MmcHostInstance->Initialized;
       MmcHostInstance->Initialized = !MmcHostInstance->Initialized;
@@ -391,6 +404,23 @@ CheckCardsCallback (
   }
 }
 
+VOID
+EFIAPI
+ExitBootServicesCallback (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  LIST_ENTRY          *CurrentLink;
+  MMC_HOST_INSTANCE   *MmcHostInstance;
+
+  CurrentLink = mMmcHostPool.ForwardLink;
+  while (CurrentLink != NULL && CurrentLink != &mMmcHostPool) {
+    MmcHostInstance = MMC_HOST_INSTANCE_FROM_LINK (CurrentLink);
+    MmcFlushWriteCache (MmcHostInstance);
+    CurrentLink = CurrentLink->ForwardLink;
+  }
+}
 
 EFI_DRIVER_BINDING_PROTOCOL gMmcDriverBinding = {
   MmcDriverBindingSupported,
@@ -455,5 +485,16 @@ MmcDxeInitialize (
                   (UINT64)(10 * 1000 * 200)); // 200 ms
   ASSERT_EFI_ERROR (Status);
 
+  // The OS does not know about the write-back cache, write it back before handoff
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  ExitBootServicesCallback,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &mExitBootServicesEvent
+                );
+  ASSERT_EFI_ERROR (Status);
+
   return Status;
 }
@@ -27,6 +27,12 @@
 #define MMC_IOBLOCKS_READ       0
 #define MMC_IOBLOCKS_WRITE      1
 
+// CMD23 carries the block count in bits [15:0]
+#define MMC_SET_BLOCK_COUNT_MAX 0xFFFF
+
+// Size of the write-back cache merging small adjacent writes
+#define MMC_WRITE_CACHE_SIZE    SIZE_32KB
+
 #define MMC_OCR_POWERUP             0x80000000
 
 #define MMC_OCR_ACCESS_MASK         0x3     /* bit[30-29] */
@@ -328,6 +334,7 @@ typedef struct {
   CID       CIDData;
   CSD       CSDData;
   ECSD      *ECSDData;                         // MMC V4 extended card specific
+  BOOLEAN   SetBlockCountSupported;            // CMD23 can bound multi-block transfers
 } CARD_INFO;
 
 typedef struct _MMC_HOST_INSTANCE {
@@ -342,6 +349,11 @@ typedef struct _MMC_HOST_INSTANCE {
   EFI_MMC_HOST_PROTOCOL     *MmcHost;
 
   BOOLEAN                   Initialized;
+
+  // Write-back cache holding WriteCacheBlocks blocks starting at WriteCacheLba
+  UINT8                     *WriteCache;
+  EFI_LBA                   WriteCacheLba;
+  UINTN                     WriteCacheBlocks;
 } MMC_HOST_INSTANCE;
 
 #define MMC_HOST_INSTANCE_SIGNATURE                 SIGNATURE_32('m', 'm', 'c', 'h')
@@ -487,6 +499,20 @@ MmcNotifyState (
   IN MMC_STATE               State
   );
 
+/**
+  Write the blocks held in the write-back cache to the card.
+
+  @param  MmcHostInstance        The MMC host instance.
+
+  @retval EFI_SUCCESS            The cache is empty or was written.
+  @retval Others                 The cached blocks could not be written and were dropped.
+
+**/
+EFI_STATUS
+MmcFlushWriteCache (
+  IN MMC_HOST_INSTANCE      *MmcHostInstance
+  );
+
 EFI_STATUS
 InitializeMmcDevice (
   IN  MMC_HOST_INSTANCE     *MmcHost
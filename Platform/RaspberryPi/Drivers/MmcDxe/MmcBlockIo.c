@@ -7,6 +7,7 @@
  **/
 
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
 
 #include "Mmc.h"
 
@@ -141,6 +142,19 @@ WaitUntilTran (
   return Status;
 }
 
+STATIC
+BOOLEAN
+MmcIsMultiBlock (
+  IN MMC_HOST_INSTANCE *MmcHostInstance
+  )
+{
+  EFI_MMC_HOST_PROTOCOL *MmcHost = MmcHostInstance->MmcHost;
+
+  return PcdGet32 (PcdMmcDisableMulti) == 0 &&
+         MMC_HOST_HAS_ISMULTIBLOCK (MmcHost) &&
+         MmcHost->IsMultiBlock (MmcHost);
+}
+
 EFI_STATUS
 MmcNotifyState (
   IN MMC_HOST_INSTANCE *MmcHostInstance,
@@ -167,6 +181,8 @@ MmcReset (
     return EFI_SUCCESS;
   }
 
+  MmcFlushWriteCache (MmcHostInstance);
+
   // If a card is not present then clear all media settings
   if (!MmcHostInstance->MmcHost->IsCardPresent (MmcHostInstance->MmcHost)) {
     MmcHostInstance->BlockIo.Media->MediaPresent = FALSE;
@@ -230,10 +246,26 @@ MmcTransferBlock (
   MMC_HOST_INSTANCE       *MmcHostInstance;
   EFI_MMC_HOST_PROTOCOL   *MmcHost;
   UINTN                   CmdArg;
+  BOOLEAN                 SetBlockCount;
 
   MmcHostInstance = MMC_HOST_INSTANCE_FROM_BLOCK_IO_THIS (This);
   MmcHost = MmcHostInstance->MmcHost;
 
+  //
+  // With CMD23 the card leaves the data state on its own after the
+  // last block, so the transfer does not need to be closed with CMD12.
+  //
+  SetBlockCount = (BufferSize > This->Media->BlockSize) &&
+                  MmcHostInstance->CardInfo.SetBlockCountSupported;
+  if (SetBlockCount) {
+    Status = MmcHost->SendCommand (MmcHost, MMC_CMD23,
+                        (UINT32)(BufferSize / This->Media->BlockSize));
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a(MMC_CMD23): Error %r\n", __func__, Status));
+      return Status;
+    }
+  }
+
   //Set command argument based on the card access mode (Byte mode or Block mode)
   if ((MmcHostInstance->CardInfo.OCRData.AccessMode & MMC_OCR_ACCESS_MASK) ==
       MMC_OCR_ACCESS_SECTOR) {
@@ -262,10 +294,10 @@ MmcTransferBlock (
   }
 
   if (EFI_ERROR (Status) ||
-      BufferSize > This->Media->BlockSize) {
+      (BufferSize > This->Media->BlockSize && !SetBlockCount)) {
     /*
-     * CMD12 needs to be set for multiblock (to transition from
-     * RECV to PROG) or for errors.
+     * CMD12 needs to be set for open-ended multiblock (to transition
+     * from RECV to PROG) or for errors.
      */
     EFI_STATUS Status2 = MmcStopTransmission (MmcHost);
     if (EFI_ERROR (Status2)) {
@@ -330,6 +362,7 @@ MmcIoBlocks (
   EFI_MMC_HOST_PROTOCOL   *MmcHost;
   UINTN                   BytesRemainingToBeTransfered;
   UINTN                   BlockCount;
+  UINTN                   ChunkBlocks;
   UINTN                   ConsumeSize;
 
   BlockCount = 1;
@@ -351,10 +384,11 @@ MmcIoBlocks (
     return EFI_NO_MEDIA;
   }
 
-  if (PcdGet32 (PcdMmcDisableMulti) == 0 &&
-      MMC_HOST_HAS_ISMULTIBLOCK (MmcHost) &&
-      MmcHost->IsMultiBlock (MmcHost)) {
+  if (MmcIsMultiBlock (MmcHostInstance)) {
     BlockCount = (BufferSize + This->Media->BlockSize - 1) / This->Media->BlockSize;
+    if (MmcHostInstance->CardInfo.SetBlockCountSupported) {
+      BlockCount = MIN (BlockCount, MMC_SET_BLOCK_COUNT_MAX);
+    }
   }
 
   // All blocks must be within the device
@@ -381,16 +415,34 @@ MmcIoBlocks (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Every MmcTransferBlock () returns with the card back in TRAN,
+  // so only the first transfer needs to wait for it.
+  //
+  Status = WaitUntilTran (MmcHostInstance);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "WaitUntilTran before IO failed"));
+    return Status;
+  }
+
   BytesRemainingToBeTransfered = BufferSize;
   while (BytesRemainingToBeTransfered > 0) {
-    Status = WaitUntilTran (MmcHostInstance);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "WaitUntilTran before IO failed"));
-      return Status;
+    ConsumeSize = BlockCount * This->Media->BlockSize;
+    if (BytesRemainingToBeTransfered < ConsumeSize) {
+      ConsumeSize = BytesRemainingToBeTransfered;
     }
 
+    //
+    // Pick the command from the size of this chunk: the last chunk of a
+    // request larger than MMC_SET_BLOCK_COUNT_MAX blocks may be a single
+    // block, which must not be sent as an open-ended multi-block transfer.
+    //
+    ChunkBlocks = ConsumeSize / This->Media->BlockSize;
+    DEBUG ((DEBUG_BLKIO, "%a(): %a LBA 0x%lx, %d blocks\n", __func__,
+      Transfer == MMC_IOBLOCKS_READ ? "Read" : "Write", Lba, ChunkBlocks));
+
     if (Transfer == MMC_IOBLOCKS_READ) {
-      if (BlockCount == 1) {
+      if (ChunkBlocks == 1) {
         // Read a single block
         Cmd = MMC_CMD17;
       } else {
@@ -398,7 +450,7 @@ MmcIoBlocks (
         Cmd = MMC_CMD18;
       }
     } else {
-      if (BlockCount == 1) {
+      if (ChunkBlocks == 1) {
         // Write a single block
         Cmd = MMC_CMD24;
       } else {
@@ -407,11 +459,6 @@ MmcIoBlocks (
       }
     }
 
-    ConsumeSize = BlockCount * This->Media->BlockSize;
-    if (BytesRemainingToBeTransfered < ConsumeSize) {
-      ConsumeSize = BytesRemainingToBeTransfered;
-    }
-
     Status = MmcTransferBlock (This, Cmd, Transfer, MediaId, Lba, ConsumeSize, Buffer, &ConsumeSize);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a(): Failed to transfer block and Status:%r\n", __func__, Status));
@@ -420,7 +467,7 @@ MmcIoBlocks (
 
     BytesRemainingToBeTransfered -= ConsumeSize;
     if (BytesRemainingToBeTransfered > 0) {
-      Lba += BlockCount;
+      Lba += ConsumeSize / This->Media->BlockSize;
       Buffer = (UINT8*)Buffer + ConsumeSize;
     }
   }
@@ -428,6 +475,72 @@ MmcIoBlocks (
   return EFI_SUCCESS;
 }
 
+EFI_STATUS
+MmcFlushWriteCache (
+  IN MMC_HOST_INSTANCE *MmcHostInstance
+  )
+{
+  EFI_STATUS             Status;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  UINTN                  CachedBlocks;
+
+  CachedBlocks = MmcHostInstance->WriteCacheBlocks;
+  if (CachedBlocks == 0) {
+    return EFI_SUCCESS;
+  }
+
+  BlockIo = &MmcHostInstance->BlockIo;
+  MmcHostInstance->WriteCacheBlocks = 0;
+
+  Status = MmcIoBlocks (BlockIo, MMC_IOBLOCKS_WRITE, BlockIo->Media->MediaId,
+             MmcHostInstance->WriteCacheLba,
+             CachedBlocks * BlockIo->Media->BlockSize,
+             MmcHostInstance->WriteCache);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a(): dropping %u blocks at LBA 0x%lx: %r\n",
+      __func__, CachedBlocks, MmcHostInstance->WriteCacheLba, Status));
+  }
+
+  return Status;
+}
+
+/*
+ * Small writes (FAT and directory updates) are merged in the write-back
+ * cache as long as they overwrite or extend the cached run of blocks.
+ * Anything the cache cannot hold, including requests MmcIoBlocks ()
+ * would reject, takes the direct path after the cache is flushed.
+ */
+STATIC
+BOOLEAN
+MmcWriteCacheAccepts (
+  IN MMC_HOST_INSTANCE        *MmcHostInstance,
+  IN UINT32                   MediaId,
+  IN EFI_LBA                  Lba,
+  IN UINTN                    BufferSize,
+  IN VOID                     *Buffer
+  )
+{
+  EFI_BLOCK_IO_MEDIA *Media = MmcHostInstance->BlockIo.Media;
+
+  if (!MmcHostInstance->Initialized ||
+      !Media->MediaPresent ||
+      Media->ReadOnly ||
+      Media->MediaId != MediaId ||
+      Buffer == NULL ||
+      BufferSize == 0 ||
+      BufferSize > MMC_WRITE_CACHE_SIZE / 2 ||
+      (BufferSize % Media->BlockSize) != 0 ||
+      (Lba + (BufferSize / Media->BlockSize)) > (Media->LastBlock + 1)) {
+    return FALSE;
+  }
+
+  if ((Media->IoAlign > 2) && (((UINTN)Buffer & (Media->IoAlign - 1)) != 0)) {
+    return FALSE;
+  }
+
+  return MmcIsMultiBlock (MmcHostInstance);
+}
+
 EFI_STATUS
 EFIAPI
 MmcReadBlocks (
@@ -438,6 +551,21 @@ MmcReadBlocks (
   OUT VOID                    *Buffer
   )
 {
+  EFI_STATUS              Status;
+  MMC_HOST_INSTANCE       *MmcHostInstance;
+
+  MmcHostInstance = MMC_HOST_INSTANCE_FROM_BLOCK_IO_THIS (This);
+
+  // Reads overlapping the write-back cache must see the cached data
+  if (MmcHostInstance->WriteCacheBlocks != 0 &&
+      Lba < MmcHostInstance->WriteCacheLba + MmcHostInstance->WriteCacheBlocks &&
+      Lba + (BufferSize / This->Media->BlockSize) > MmcHostInstance->WriteCacheLba) {
+    Status = MmcFlushWriteCache (MmcHostInstance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   return MmcIoBlocks (This, MMC_IOBLOCKS_READ, MediaId, Lba, BufferSize, Buffer);
 }
 
@@ -451,7 +579,58 @@ MmcWriteBlocks (
   IN VOID                     *Buffer
   )
 {
-  return MmcIoBlocks (This, MMC_IOBLOCKS_WRITE, MediaId, Lba, BufferSize, Buffer);
+  EFI_STATUS              Status;
+  MMC_HOST_INSTANCE       *MmcHostInstance;
+  UINTN                   BlockSize;
+  UINTN                   CacheCapacity;
+  EFI_LBA                 CacheEnd;
+
+  MmcHostInstance = MMC_HOST_INSTANCE_FROM_BLOCK_IO_THIS (This);
+  BlockSize = This->Media->BlockSize;
+  CacheCapacity = MMC_WRITE_CACHE_SIZE / BlockSize;
+
+  if (MmcHostInstance->WriteCache == NULL &&
+      MmcWriteCacheAccepts (MmcHostInstance, MediaId, Lba, BufferSize, Buffer)) {
+    MmcHostInstance->WriteCache = AllocatePool (MMC_WRITE_CACHE_SIZE);
+    This->Media->WriteCaching = (MmcHostInstance->WriteCache != NULL);
+  }
+
+  if (MmcHostInstance->WriteCache == NULL ||
+      !MmcWriteCacheAccepts (MmcHostInstance, MediaId, Lba, BufferSize, Buffer)) {
+    Status = MmcFlushWriteCache (MmcHostInstance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    return MmcIoBlocks (This, MMC_IOBLOCKS_WRITE, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  //
+  // The cache holds one run of blocks. A write that neither overwrites
+  // nor extends it, or that would overflow it, starts a new run.
+  //
+  CacheEnd = MmcHostInstance->WriteCacheLba + MmcHostInstance->WriteCacheBlocks;
+  if (MmcHostInstance->WriteCacheBlocks != 0 &&
+      (Lba < MmcHostInstance->WriteCacheLba ||
+       Lba > CacheEnd ||
+       Lba + BufferSize / BlockSize > MmcHostInstance->WriteCacheLba + CacheCapacity)) {
+    Status = MmcFlushWriteCache (MmcHostInstance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (MmcHostInstance->WriteCacheBlocks == 0) {
+    MmcHostInstance->WriteCacheLba = Lba;
+  }
+
+  CopyMem (MmcHostInstance->WriteCache +
+             (Lba - MmcHostInstance->WriteCacheLba) * BlockSize,
+           Buffer, BufferSize);
+  MmcHostInstance->WriteCacheBlocks = MAX (MmcHostInstance->WriteCacheBlocks,
+                                        (UINTN)(Lba - MmcHostInstance->WriteCacheLba) +
+                                        BufferSize / BlockSize);
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
@@ -460,5 +639,5 @@ MmcFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   )
 {
-  return EFI_SUCCESS;
+  return MmcFlushWriteCache (MMC_HOST_INSTANCE_FROM_BLOCK_IO_THIS (This));
 }
@@ -45,6 +45,8 @@ typedef union {
 
 #define SD_CCC_SWITCH           (1 << 10)
 
+#define SD_SCR_CMD23_SUPPORT    (1 << 1)
+
 #define DEVICE_STATE(x)         (((x) >> 9) & 0xf)
 typedef enum _EMMC_DEVICE_STATE {
   EMMC_IDLE_STATE = 0,
@@ -713,6 +715,11 @@ InitializeSdMmcDevice (
     }
   }
 
+  if (Scr.CMD_SUPPORT & SD_SCR_CMD23_SUPPORT) {
+    DEBUG ((DEBUG_INFO, "SD Card supports CMD23\n"));
+    MmcHostInstance->CardInfo.SetBlockCountSupported = TRUE;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -969,10 +976,13 @@ InitializeMmcDevice (
     return Status;
   }
 
+  MmcHostInstance->CardInfo.SetBlockCountSupported = FALSE;
   if (MmcHostInstance->CardInfo.CardType != EMMC_CARD) {
     Status = InitializeSdMmcDevice (MmcHostInstance);
   } else {
     Status = InitializeEmmcDevice (MmcHostInstance);
+    // CMD23 is mandatory for eMMC
+    MmcHostInstance->CardInfo.SetBlockCountSupported = TRUE;
   }
   if (EFI_ERROR (Status)) {
     return Status;
@@ -42,6 +42,19 @@
 
 #define IDENT_MODE_SD_CLOCK_FREQ_HZ         400000 // 400KHz
 
+// DMA Parameters
+#define SDHOST_DMA_CHANNEL                  4
+#define SDHOST_DMA_REG(X)                   (BCM2836_DMA0_BASE_ADDRESS + \
+                                             SDHOST_DMA_CHANNEL * BCM2836_DMA_CHANNEL_LENGTH + (X))
+#define SDHOST_DMA_SEGMENT_SIZE             SIZE_64KB
+#define SDHOST_DMA_CONTROL_BLOCKS           (EFI_PAGE_SIZE / sizeof (SDHOST_DMA_CONTROL_BLOCK))
+#define SDHOST_DMA_MAX_LENGTH               ((SDHOST_DMA_CONTROL_BLOCKS - 1) * SDHOST_DMA_SEGMENT_SIZE)
+#define SDHOST_DMA_MIN_TIMEOUT_US           100000 // 100ms
+#define SDHOST_FIFO_THRESHOLD               4
+// SdHost does not raise DREQ for the last words of a multi-block read,
+// so these are drained from the FIFO by PIO.
+#define SDHOST_DMA_READ_DRAIN_BYTES         ((SDHOST_FIFO_THRESHOLD - 1) * 4)
+
 // Macros adopted from MmcDxe internal header
 #define SDHOST_R0_READY_FOR_DATA            BIT8
 #define SDHOST_R0_CURRENTSTATE(Response)    ((Response >> 9) & 0xF)
@@ -50,8 +63,24 @@
 #define DEBUG_MMCHOST_SD_INFO  DEBUG_INFO
 #define DEBUG_MMCHOST_SD_ERROR DEBUG_ERROR
 
+// DMA control block, 32-byte aligned, holding bus addresses
+typedef struct {
+  UINT32 TransferInfo;
+  UINT32 SourceAddress;
+  UINT32 DestinationAddress;
+  UINT32 TransferLength;
+  UINT32 Stride;
+  UINT32 NextControlBlock;
+  UINT32 Reserved[2];
+} SDHOST_DMA_CONTROL_BLOCK;
+
 STATIC RASPBERRY_PI_FIRMWARE_PROTOCOL   *mFwProtocol;
 
+STATIC BOOLEAN                  mDmaEnabled = FALSE;
+STATIC SDHOST_DMA_CONTROL_BLOCK *mDmaControlBlocks;
+STATIC EFI_PHYSICAL_ADDRESS     mDmaControlBlocksBusAddress;
+STATIC VOID                     *mDmaControlBlocksMapping;
+
 // Per Physical Layer Simplified Specs
 #ifndef NDEBUG
 STATIC CONST CHAR8* mStrSdState[] = { "idle", "ready", "ident", "stby",
@@ -495,6 +524,193 @@ SdReceiveResponse (
   return EFI_SUCCESS;
 }
 
+STATIC EFI_STATUS
+SdPioReadWords (
+  OUT UINT32                  *Buffer,
+  IN  UINTN                   NumWords
+  )
+{
+  UINTN WordIdx;
+
+  for (WordIdx = 0; WordIdx < NumWords; ++WordIdx) {
+    UINT32 PollCount = 0;
+    while (PollCount < FIFO_MAX_POLL_COUNT) {
+      UINT32 Hsts = MmioRead32 (SDHOST_HSTS);
+      if ((Hsts & SDHOST_HSTS_DATA_FLAG) != 0) {
+        MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_DATA_FLAG);
+        Buffer[WordIdx] = MmioRead32 (SDHOST_DATA);
+        break;
+      }
+
+      ++PollCount;
+      gBS->Stall (CMD_STALL_AFTER_RETRY_US);
+    }
+
+    if (PollCount == FIFO_MAX_POLL_COUNT) {
+      DEBUG ((DEBUG_MMCHOST_SD_ERROR,
+          "SdHost: SdReadBlockData(): Block Word%d read poll timed-out\n", WordIdx));
+      SdHostDumpStatus ();
+      MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_CLEAR);
+      return EFI_TIMEOUT;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_STATUS
+SdPioWriteWords (
+  IN  UINT32                  *Buffer,
+  IN  UINTN                   NumWords
+  )
+{
+  UINTN WordIdx;
+
+  for (WordIdx = 0; WordIdx < NumWords; ++WordIdx) {
+    UINT32 PollCount = 0;
+    while (PollCount < FIFO_MAX_POLL_COUNT) {
+      if (MmioRead32 (SDHOST_HSTS) & SDHOST_HSTS_DATA_FLAG) {
+        MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_DATA_FLAG);
+        MmioWrite32 (SDHOST_DATA, Buffer[WordIdx]);
+        break;
+      }
+
+      ++PollCount;
+      gBS->Stall (CMD_STALL_AFTER_RETRY_US);
+    }
+
+    if (PollCount == FIFO_MAX_POLL_COUNT) {
+      DEBUG ((DEBUG_MMCHOST_SD_ERROR,
+        "SdHost: SdWriteBlockData(): Block Word%d write poll timed-out\n", WordIdx));
+      SdHostDumpStatus ();
+      MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_CLEAR);
+      return EFI_TIMEOUT;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Move data between memory and the SdHost FIFO with the DMA engine.
+
+  The buffer is mapped through DmaLib, which takes care of cache maintenance,
+  and described to the DMA channel as a chain of control blocks, none of which
+  crosses a SDHOST_DMA_SEGMENT_SIZE boundary.
+
+  @retval EFI_SUCCESS       All data was transferred.
+  @retval EFI_UNSUPPORTED   The buffer could not be mapped, nothing was transferred.
+  @retval EFI_DEVICE_ERROR  The DMA engine or the SdHost reported an error.
+  @retval EFI_TIMEOUT       The transfer did not complete in time.
+**/
+STATIC EFI_STATUS
+SdDmaTransfer (
+  IN  BOOLEAN                 IsRead,
+  IN  VOID                    *Buffer,
+  IN  UINTN                   Length
+  )
+{
+  EFI_STATUS                Status;
+  EFI_PHYSICAL_ADDRESS      BusAddress;
+  VOID                      *Mapping;
+  UINTN                     MappedLength;
+  UINTN                     Offset;
+  UINTN                     Segment;
+  UINTN                     Index;
+  UINTN                     Timeout;
+  UINT32                    Cs;
+  SDHOST_DMA_CONTROL_BLOCK  *Cb;
+
+  ASSERT (Length <= SDHOST_DMA_MAX_LENGTH);
+
+  MappedLength = Length;
+  Status = DmaMap (IsRead ? MapOperationBusMasterWrite : MapOperationBusMasterRead,
+             Buffer, &MappedLength, &BusAddress, &Mapping);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (MappedLength != Length) {
+    DmaUnmap (Mapping);
+    return EFI_UNSUPPORTED;
+  }
+
+  Offset = 0;
+  for (Index = 0; Offset < Length; Index++) {
+    Segment = SDHOST_DMA_SEGMENT_SIZE - ((BusAddress + Offset) & (SDHOST_DMA_SEGMENT_SIZE - 1));
+    Segment = MIN (Segment, Length - Offset);
+
+    Cb = &mDmaControlBlocks[Index];
+    if (IsRead) {
+      Cb->TransferInfo = BCM2836_DMA_TI_SRC_DREQ | BCM2836_DMA_TI_DEST_INC;
+      Cb->SourceAddress = SDHOST_DATA_BUS_ADDRESS;
+      Cb->DestinationAddress = (UINT32)(BusAddress + Offset);
+    } else {
+      Cb->TransferInfo = BCM2836_DMA_TI_DEST_DREQ | BCM2836_DMA_TI_SRC_INC;
+      Cb->SourceAddress = (UINT32)(BusAddress + Offset);
+      Cb->DestinationAddress = SDHOST_DATA_BUS_ADDRESS;
+    }
+    Cb->TransferInfo |= BCM2836_DMA_TI_WAIT_RESP |
+                        BCM2836_DMA_TI_PERMAP (BCM2836_DMA_DREQ_SDHOST);
+    Cb->TransferLength = (UINT32)Segment;
+    Cb->Stride = 0;
+    Cb->NextControlBlock = 0;
+    if (Index > 0) {
+      mDmaControlBlocks[Index - 1].NextControlBlock =
+        (UINT32)(mDmaControlBlocksBusAddress + Index * sizeof (SDHOST_DMA_CONTROL_BLOCK));
+    }
+
+    Offset += Segment;
+  }
+
+  MemoryFence ();
+
+  MmioWrite32 (SDHOST_DMA_REG (BCM2836_DMA_CONBLK_AD), (UINT32)mDmaControlBlocksBusAddress);
+  MmioWrite32 (SDHOST_DMA_REG (BCM2836_DMA_CS),
+    BCM2836_DMA_CS_ACTIVE | BCM2836_DMA_CS_END | BCM2836_DMA_CS_WAIT_FOR_OUTSTANDING_WRITES);
+
+  //
+  // Allow for 1MB/s at the very least on top of the command latency.
+  //
+  Status = EFI_SUCCESS;
+  Timeout = SDHOST_DMA_MIN_TIMEOUT_US + Length;
+  for (;;) {
+    Cs = MmioRead32 (SDHOST_DMA_REG (BCM2836_DMA_CS));
+    if ((Cs & BCM2836_DMA_CS_ERROR) != 0 ||
+        (MmioRead32 (SDHOST_HSTS) & SDHOST_HSTS_ERROR) != 0) {
+      Status = EFI_DEVICE_ERROR;
+      break;
+    }
+
+    if ((Cs & BCM2836_DMA_CS_ACTIVE) == 0) {
+      break;
+    }
+
+    if (Timeout == 0) {
+      Status = EFI_TIMEOUT;
+      break;
+    }
+
+    gBS->Stall (1);
+    Timeout--;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_MMCHOST_SD_ERROR,
+      "SdHost: SdDmaTransfer(): %a of 0x%x bytes failed: %r (CS: 0x%08x, DEBUG: 0x%08x)\n",
+      IsRead ? "read" : "write", Length, Status, Cs,
+      MmioRead32 (SDHOST_DMA_REG (BCM2836_DMA_DEBUG))));
+    MmioWrite32 (SDHOST_DMA_REG (BCM2836_DMA_CS), BCM2836_DMA_CS_RESET);
+    SdHostDumpStatus ();
+    MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_CLEAR);
+  } else {
+    MmioWrite32 (SDHOST_DMA_REG (BCM2836_DMA_CS), BCM2836_DMA_CS_END);
+  }
+
+  DmaUnmap (Mapping);
+  return Status;
+}
+
 STATIC EFI_STATUS
 SdReadBlockData (
   IN EFI_MMC_HOST_PROTOCOL    *This,
@@ -509,37 +725,33 @@ SdReadBlockData (
   ASSERT (Buffer != NULL);
   ASSERT (Length % 4 == 0);
 
-  EFI_STATUS Status = EFI_SUCCESS;
+  EFI_STATUS Status = EFI_UNSUPPORTED;
+  UINTN Offset = 0;
 
   mFwProtocol->SetLed (TRUE);
-  {
-    UINT32 NumWords = Length / 4;
-    UINT32 WordIdx;
-
-    for (WordIdx = 0; WordIdx < NumWords; ++WordIdx) {
-      UINT32 PollCount = 0;
-      while (PollCount < FIFO_MAX_POLL_COUNT) {
-        UINT32 Hsts = MmioRead32 (SDHOST_HSTS);
-        if ((Hsts & SDHOST_HSTS_DATA_FLAG) != 0) {
-          MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_DATA_FLAG);
-          Buffer[WordIdx] = MmioRead32 (SDHOST_DATA);
-          break;
-        }
-
-        ++PollCount;
-        gBS->Stall (CMD_STALL_AFTER_RETRY_US);
-      }
+  //
+  // Short reads (SCR, SD status, switch status) stay on PIO.
+  //
+  if (mDmaEnabled && (Length % SDHOST_BLOCK_BYTE_LENGTH) == 0) {
+    UINTN DmaLength = Length - SDHOST_DMA_READ_DRAIN_BYTES;
 
-      if (PollCount == FIFO_MAX_POLL_COUNT) {
-        DEBUG ((DEBUG_MMCHOST_SD_ERROR,
-            "SdHost: SdReadBlockData(): Block Word%d read poll timed-out\n", WordIdx));
-        SdHostDumpStatus ();
-        MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_CLEAR);
-        Status = EFI_TIMEOUT;
+    while (Offset < DmaLength) {
+      UINTN Chunk = MIN (DmaLength - Offset, SDHOST_DMA_MAX_LENGTH);
+
+      Status = SdDmaTransfer (TRUE, (UINT8 *)Buffer + Offset, Chunk);
+      if (EFI_ERROR (Status)) {
         break;
       }
+      Offset += Chunk;
     }
   }
+
+  //
+  // PIO does the drain words, or everything if DMA could not be used.
+  //
+  if (Status == EFI_UNSUPPORTED || !EFI_ERROR (Status)) {
+    Status = SdPioReadWords ((UINT32 *)((UINT8 *)Buffer + Offset), (Length - Offset) / 4);
+  }
   mFwProtocol->SetLed (FALSE);
 
   return Status;
@@ -560,36 +772,25 @@ SdWriteBlockData (
   ASSERT (Buffer != NULL);
   ASSERT (Length % SDHOST_BLOCK_BYTE_LENGTH == 0);
 
-  EFI_STATUS Status = EFI_SUCCESS;
+  EFI_STATUS Status = EFI_UNSUPPORTED;
+  UINTN Offset = 0;
 
   mFwProtocol->SetLed (TRUE);
-  {
-    UINT32 NumWords = Length / 4;
-    UINT32 WordIdx;
-
-    for (WordIdx = 0; WordIdx < NumWords; ++WordIdx) {
-      UINT32 PollCount = 0;
-      while (PollCount < FIFO_MAX_POLL_COUNT) {
-        if (MmioRead32 (SDHOST_HSTS) & SDHOST_HSTS_DATA_FLAG) {
-          MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_DATA_FLAG);
-          MmioWrite32 (SDHOST_DATA, Buffer[WordIdx]);
-          break;
-        }
-
-        ++PollCount;
-        gBS->Stall (CMD_STALL_AFTER_RETRY_US);
-      }
+  if (mDmaEnabled) {
+    while (Offset < Length) {
+      UINTN Chunk = MIN (Length - Offset, SDHOST_DMA_MAX_LENGTH);
 
-      if (PollCount == FIFO_MAX_POLL_COUNT) {
-        DEBUG ((DEBUG_MMCHOST_SD_ERROR,
-          "SdHost: SdWriteBlockData(): Block Word%d write poll timed-out\n", WordIdx));
-        SdHostDumpStatus ();
-        MmioWrite32 (SDHOST_HSTS, SDHOST_HSTS_CLEAR);
-        Status = EFI_TIMEOUT;
+      Status = SdDmaTransfer (FALSE, (UINT8 *)Buffer + Offset, Chunk);
+      if (EFI_ERROR (Status)) {
         break;
       }
+      Offset += Chunk;
     }
   }
+
+  if (Status == EFI_UNSUPPORTED) {
+    Status = SdPioWriteWords ((UINT32 *)((UINT8 *)Buffer + Offset), (Length - Offset) / 4);
+  }
   mFwProtocol->SetLed (FALSE);
 
   return Status;
@@ -672,6 +873,15 @@ SdNotifyState (
     Hcfg |= SDHOST_HCFG_SLOW_CARD; // Use all bits of CDIV in DataMode
     MmioWrite32 (SDHOST_HCFG, Hcfg);
 
+    // FIFO levels at which DREQ is raised for the DMA engine
+    if (mDmaEnabled) {
+      MmioAndThenOr32 (SDHOST_EDM,
+        ~((SDHOST_EDM_THRESHOLD_MASK << SDHOST_EDM_READ_THRESHOLD_SHIFT) |
+          (SDHOST_EDM_THRESHOLD_MASK << SDHOST_EDM_WRITE_THRESHOLD_SHIFT)),
+        SDHOST_EDM_READ_THRESHOLD (SDHOST_FIFO_THRESHOLD) |
+        SDHOST_EDM_WRITE_THRESHOLD (SDHOST_FIFO_THRESHOLD));
+    }
+
     // Set default clock frequency
     EFI_STATUS Status = SdHostSetClockFrequency (IDENT_MODE_SD_CLOCK_FREQ_HZ);
     if (EFI_ERROR (Status)) {
@@ -802,6 +1012,34 @@ EFI_MMC_HOST_PROTOCOL gMmcHost =
     SdIsMultiBlock
   };
 
+STATIC EFI_STATUS
+SdHostDmaInitialize (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+  UINTN      BufferSize;
+
+  Status = DmaAllocateBuffer (EfiBootServicesData, 1, (VOID **)&mDmaControlBlocks);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  BufferSize = EFI_PAGE_SIZE;
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, mDmaControlBlocks, &BufferSize,
+             &mDmaControlBlocksBusAddress, &mDmaControlBlocksMapping);
+  if (EFI_ERROR (Status)) {
+    DmaFreeBuffer (1, mDmaControlBlocks);
+    return Status;
+  }
+
+  // Enable and reset the channel
+  MmioOr32 (BCM2836_DMA_CTRL_BASE_ADDRESS + BCM2836_DMA_ENABLE_OFFSET, 1 << SDHOST_DMA_CHANNEL);
+  MmioWrite32 (SDHOST_DMA_REG (BCM2836_DMA_CS), BCM2836_DMA_CS_RESET);
+
+  return EFI_SUCCESS;
+}
+
 EFI_STATUS
 SdHostInitialize (
   IN EFI_HANDLE          ImageHandle,
@@ -822,6 +1060,15 @@ SdHostInitialize (
     return Status;
   }
 
+  if (PcdGet32 (PcdSdHostEnableDma)) {
+    Status = SdHostDmaInitialize ();
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "SdHost: DMA unavailable, using PIO: %r\n", Status));
+    } else {
+      mDmaEnabled = TRUE;
+    }
+  }
+
   DEBUG ((DEBUG_MMCHOST_SD, "SdHost: Initialize\n"));
   DEBUG ((DEBUG_MMCHOST_SD, "Config:\n"));
   DEBUG ((DEBUG_MMCHOST_SD, " - FIFO_MAX_POLL_COUNT=%d\n", FIFO_MAX_POLL_COUNT));
@@ -830,6 +1077,7 @@ SdHostInitialize (
   DEBUG ((DEBUG_MMCHOST_SD, " - CMD_MAX_POLL_COUNT=%d\n", CMD_MAX_POLL_COUNT));
   DEBUG ((DEBUG_MMCHOST_SD, " - CMD_MAX_RETRY_COUNT=%d\n", CMD_MAX_RETRY_COUNT));
   DEBUG ((DEBUG_MMCHOST_SD, " - CMD_STALL_AFTER_RETRY_US=%dus\n", CMD_STALL_AFTER_RETRY_US));
+  DEBUG ((DEBUG_MMCHOST_SD, " - DMA=%a (channel %d)\n", mDmaEnabled ? "on" : "off", SDHOST_DMA_CHANNEL));
 
   Status = gBS->InstallMultipleProtocolInterfaces (
     &Handle,
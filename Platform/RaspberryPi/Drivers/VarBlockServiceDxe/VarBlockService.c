@@ -86,6 +86,50 @@ EFI_FW_VOL_BLOCK_DEVICE mFvbDeviceTemplate = {
 };
 
 
+STATIC
+VOID
+VarStoreMarkDirty (
+  IN UINTN Address,
+  IN UINTN Length
+  )
+{
+  UINTN Lba;
+  UINTN LastLba;
+
+  if (Length == 0) {
+    return;
+  }
+
+  Lba = (Address - mFvInstance->FvBase) / mFvInstance->BlockSize;
+  LastLba = (Address - mFvInstance->FvBase + Length - 1) / mFvInstance->BlockSize;
+  for (; Lba <= LastLba; Lba++) {
+    mFvInstance->DirtyBlocks[Lba / 8] |= (UINT8)(1 << (Lba % 8));
+  }
+
+  mFvInstance->Dirty = TRUE;
+}
+
+
+BOOLEAN
+VarStoreIsBlockDirty (
+  IN UINTN Lba
+  )
+{
+  return (mFvInstance->DirtyBlocks[Lba / 8] & (1 << (Lba % 8))) != 0;
+}
+
+
+VOID
+VarStoreClearDirty (
+  VOID
+  )
+{
+  ZeroMem (mFvInstance->DirtyBlocks,
+    (mFvInstance->FvLength / mFvInstance->BlockSize + 7) / 8);
+  mFvInstance->Dirty = FALSE;
+}
+
+
 EFI_STATUS
 VarStoreWrite (
   IN     UINTN Address,
@@ -94,7 +138,7 @@ VarStoreWrite (
   )
 {
   CopyMem ((VOID*)Address, Buffer, *NumBytes);
-  mFvInstance->Dirty = TRUE;
+  VarStoreMarkDirty (Address, *NumBytes);
 
   return EFI_SUCCESS;
 }
@@ -107,7 +151,7 @@ VarStoreErase (
   )
 {
   SetMem ((VOID*)Address, LbaLength, 0xff);
-  mFvInstance->Dirty = TRUE;
+  VarStoreMarkDirty (Address, LbaLength);
 
   return EFI_SUCCESS;
 }
@@ -843,6 +887,13 @@ FvbInitialize (
   mFvInstance->FvBase = (UINTN)BaseAddress;
   mFvInstance->FvLength = (UINTN)Length;
   mFvInstance->Offset = StartOffset;
+  mFvInstance->BlockSize = PcdGet32 (PcdFirmwareBlockSize);
+  mFvInstance->DirtyBlocks = AllocateRuntimeZeroPool (
+                               (Length / mFvInstance->BlockSize + 7) / 8);
+  if (mFvInstance->DirtyBlocks == NULL) {
+    FreePool (mFvInstance);
+    return EFI_OUT_OF_RESOURCES;
+  }
   /*
    * Should I parse config.txt instead and find the real name?
    */
@@ -30,9 +30,14 @@ typedef struct {
   UINTN                      FvLength;
   UINTN                      Offset;
   UINTN                      NumOfBlocks;
+  UINTN                      BlockSize;
   EFI_DEVICE_PATH_PROTOCOL   *Device;
   CHAR16                     *MappedFile;
   BOOLEAN                    Dirty;
+  //
+  // One bit per LBA, set when the block differs from the mapped file.
+  //
+  UINT8                      *DirtyBlocks;
 } EFI_FW_VOL_INSTANCE;
 
 extern EFI_FW_VOL_INSTANCE *mFvInstance;
@@ -88,6 +93,16 @@ FvbClassAddressChangeEvent (
   IN VOID             *Context
   );
 
+BOOLEAN
+VarStoreIsBlockDirty (
+  IN UINTN Lba
+  );
+
+VOID
+VarStoreClearDirty (
+  VOID
+  );
+
 EFI_STATUS
 FvbGetLbaAddress (
   IN  EFI_LBA Lba,
@@ -110,6 +110,7 @@ FvbVirtualAddressChangeEvent (
 {
   EfiConvertPointer (0x0, (VOID**)&mFvInstance->FvBase);
   EfiConvertPointer (0x0, (VOID**)&mFvInstance->VolumeHeader);
+  EfiConvertPointer (0x0, (VOID**)&mFvInstance->DirtyBlocks);
   EfiConvertPointer (0x0, (VOID**)&mFvInstance);
 }
 
@@ -134,14 +135,22 @@ InstallVirtualAddressChangeHandler (
 }
 
 
+//
+// Write the variable store to the mapped file. With DirtyOnly set, only
+// runs of blocks modified since the last dump are written, at their
+// matching file offsets.
+//
 STATIC
 EFI_STATUS
 DoDump (
-  IN EFI_DEVICE_PATH_PROTOCOL *Device
+  IN EFI_DEVICE_PATH_PROTOCOL *Device,
+  IN BOOLEAN DirtyOnly
   )
 {
   EFI_STATUS Status;
   EFI_FILE_PROTOCOL *File;
+  UINTN Lba;
+  UINTN RunStart;
 
   Status = FileOpen (Device,
              mFvInstance->MappedFile,
@@ -152,11 +161,37 @@ DoDump (
     return Status;
   }
 
-  Status = FileWrite (File,
-             mFvInstance->Offset,
-             mFvInstance->FvBase,
-             mFvInstance->FvLength);
+  if (!DirtyOnly) {
+    Status = FileWrite (File,
+               mFvInstance->Offset,
+               mFvInstance->FvBase,
+               mFvInstance->FvLength);
+  } else {
+    Lba = 0;
+    while (!EFI_ERROR (Status) && Lba < mFvInstance->NumOfBlocks) {
+      if (!VarStoreIsBlockDirty (Lba)) {
+        Lba++;
+        continue;
+      }
+
+      RunStart = Lba;
+      while (Lba < mFvInstance->NumOfBlocks && VarStoreIsBlockDirty (Lba)) {
+        Lba++;
+      }
+
+      DEBUG ((DEBUG_INFO, "Dumping blocks %Lu-%Lu\n", (UINT64)RunStart,
+        (UINT64)(Lba - 1)));
+      Status = FileWrite (File,
+                 mFvInstance->Offset + RunStart * mFvInstance->BlockSize,
+                 mFvInstance->FvBase + RunStart * mFvInstance->BlockSize,
+                 (Lba - RunStart) * mFvInstance->BlockSize);
+    }
+  }
   FileClose (File);
+
+  if (!EFI_ERROR (Status)) {
+    VarStoreClearDirty ();
+  }
   return Status;
 }
 
@@ -180,7 +215,7 @@ DumpVars (
     return;
   }
 
-  Status = DoDump (mFvInstance->Device);
+  Status = DoDump (mFvInstance->Device, TRUE);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Couldn't dump '%s'\n", mFvInstance->MappedFile));
     ASSERT_EFI_ERROR (Status);
@@ -198,8 +233,6 @@ DumpVars (
     PcdStatus = PcdSet32S (PcdPlatformResetDelay, PLATFORM_RESET_DELAY);
     ASSERT_RETURN_ERROR (PcdStatus);
   }
-
-  mFvInstance->Dirty = FALSE;
 }
 
 STATIC
@@ -334,7 +367,7 @@ OnSimpleFileSystemInstall (
       continue;
     }
 
-    Status = DoDump (Device);
+    Status = DoDump (Device, FALSE);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "Couldn't update '%s'\n", mFvInstance->MappedFile));
       ASSERT_EFI_ERROR (Status);
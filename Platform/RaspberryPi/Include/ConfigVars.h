@@ -147,4 +147,12 @@ typedef struct {
   UINT32 EnableDma;
 } MMC_EMMC_DMA_VARSTORE_DATA;
 
+typedef struct {
+  /*
+   * 0 - SdHost PIO mode
+   * 1 - SdHost DMA mode
+   */
+  UINT32 EnableDma;
+} MMC_SDHOST_DMA_VARSTORE_DATA;
+
 #endif /* CONFIG_VARS_H */
@@ -181,28 +181,27 @@ PcieInitEntry (
   )
 {
   AC01_ROOT_COMPLEX  *RootComplex;
-  EFI_STATUS         Status;
   UINT8              Index;
 
   BuildRootComplexData ();
 
   //
-  // Initialize Root Complex and underneath controllers
+  // Initialize Root Complex and underneath controllers. The link training
+  // of all Root Complexes runs in parallel.
   //
+  Ac01PcieCoreSetupAllRC (mRootComplexList);
+
   for (Index = 0; Index < AC01_PCIE_MAX_ROOT_COMPLEX; Index++) {
     RootComplex = &mRootComplexList[Index];
-    if (!RootComplex->Active) {
-      continue;
-    }
-
-    DEBUG ((DEBUG_INIT, "Initializing S%d-RC%d...", RootComplex->Socket, RootComplex->ID));
-    Status = Ac01PcieCoreSetupRC (RootComplex, FALSE, 0);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "Failed\n"));
-      RootComplex->Active = FALSE;
-      continue;
-    } else {
-      DEBUG ((DEBUG_INIT, "Done + DevMapLow/High: %d/%d\n", RootComplex->DevMapLow, RootComplex->DevMapHigh));
+    if (RootComplex->Active) {
+      DEBUG ((
+        DEBUG_INIT,
+        "S%d-RC%d initialized, DevMapLow/High: %d/%d\n",
+        RootComplex->Socket,
+        RootComplex->ID,
+        RootComplex->DevMapLow,
+        RootComplex->DevMapHigh
+        ));
     }
   }
 
@@ -30,6 +30,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PerformanceLib.h>
 #include <Library/PrintLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/TimerLib.h>
 #include <Library/Tpm2CommandLib.h>
 #include <Library/Tpm2DeviceLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -112,6 +113,30 @@ VARIABLE_TYPE  mVariableType[] = {
 
 EFI_HANDLE  mImageHandle;
 
+typedef enum {
+  Tcg2TpmOpExtend,
+  Tcg2TpmOpPeImage,
+  Tcg2TpmOpSubmit,
+  Tcg2TpmOpMax
+} TCG2_TPM_OP;
+
+typedef struct {
+  UINT32    Count;
+  UINT64    TotalNs;
+  UINT64    MaxNs;
+} TCG2_TPM_OP_STATS;
+
+//
+// Number and latency of the operations that go to the TPM, reported at
+// ReadyToBoot and ExitBootServices
+//
+TCG2_TPM_OP_STATS  mTpmOpStats[Tcg2TpmOpMax];
+CHAR8              *mTpmOpNames[Tcg2TpmOpMax] = {
+  "HashAndExtend",
+  "PeImageExtend",
+  "SubmitCommand"
+};
+
 /**
   Measure PE image into TPM log based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A.
@@ -271,6 +296,61 @@ InternalDumpHex (
   }
 }
 
+/**
+  Account for one operation that went to the TPM.
+
+  @param[in]  Op          The operation.
+  @param[in]  StartTicks  Performance counter value taken before the operation.
+
+**/
+VOID
+RecordTpmOp (
+  IN TCG2_TPM_OP  Op,
+  IN UINT64       StartTicks
+  )
+{
+  UINT64  ElapsedNs;
+
+  ElapsedNs = GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks);
+
+  mTpmOpStats[Op].Count++;
+  mTpmOpStats[Op].TotalNs += ElapsedNs;
+  if (ElapsedNs > mTpmOpStats[Op].MaxNs) {
+    mTpmOpStats[Op].MaxNs = ElapsedNs;
+  }
+}
+
+/**
+  Report the number and latency of the operations that went to the TPM.
+
+  @param[in]  Phase  The boot phase the report is made at.
+
+**/
+VOID
+DumpTpmOpStats (
+  IN CONST CHAR8  *Phase
+  )
+{
+  UINTN  Index;
+
+  DEBUG ((DEBUG_INFO, "Tcg2Dxe: TPM operations at %a\n", Phase));
+  for (Index = 0; Index < Tcg2TpmOpMax; Index++) {
+    if (mTpmOpStats[Index].Count == 0) {
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  %-14a - %4d, total %6ld us, avg %5ld us, max %5ld us\n",
+      mTpmOpNames[Index],
+      mTpmOpStats[Index].Count,
+      DivU64x32 (mTpmOpStats[Index].TotalNs, 1000),
+      DivU64x32 (DivU64x32 (mTpmOpStats[Index].TotalNs, mTpmOpStats[Index].Count), 1000),
+      DivU64x32 (mTpmOpStats[Index].MaxNs, 1000)
+      ));
+  }
+}
+
 /**
   The EFI_TCG2_PROTOCOL GetCapability function call provides protocol
   capability information and state information.
@@ -920,8 +1000,8 @@ TcgDxeLogEvent (
       // Increase the NumberOfEvents in FinalEventsTable
       //
       (mTcgDxeData.FinalEventsTable[Index])->NumberOfEvents++;
-      DEBUG ((DEBUG_INFO, "FinalEventsTable->NumberOfEvents - 0x%x\n", (mTcgDxeData.FinalEventsTable[Index])->NumberOfEvents));
-      DEBUG ((DEBUG_INFO, "  Size - 0x%x\n", (UINTN)EventLogAreaStruct->EventLogSize));
+      DEBUG ((DEBUG_VERBOSE, "FinalEventsTable->NumberOfEvents - 0x%x\n", (mTcgDxeData.FinalEventsTable[Index])->NumberOfEvents));
+      DEBUG ((DEBUG_VERBOSE, "  Size - 0x%x\n", (UINTN)EventLogAreaStruct->EventLogSize));
     }
   }
 
@@ -1045,12 +1125,12 @@ TcgDxeLogHashEvent (
   UINT8           *DigestBuffer;
   UINT32          *EventSizePtr;
 
-  DEBUG ((DEBUG_INFO, "SupportedEventLogs - 0x%08x\n", mTcgDxeData.BsCap.SupportedEventLogs));
+  DEBUG ((DEBUG_VERBOSE, "SupportedEventLogs - 0x%08x\n", mTcgDxeData.BsCap.SupportedEventLogs));
 
   RetStatus = EFI_SUCCESS;
   for (Index = 0; Index < sizeof (mTcg2EventInfo)/sizeof (mTcg2EventInfo[0]); Index++) {
     if ((mTcgDxeData.BsCap.SupportedEventLogs & mTcg2EventInfo[Index].LogFormat) != 0) {
-      DEBUG ((DEBUG_INFO, "  LogFormat - 0x%08x\n", mTcg2EventInfo[Index].LogFormat));
+      DEBUG ((DEBUG_VERBOSE, "  LogFormat - 0x%08x\n", mTcg2EventInfo[Index].LogFormat));
       switch (mTcg2EventInfo[Index].LogFormat) {
         case EFI_TCG2_EVENT_LOG_FORMAT_TCG_1_2:
           Status = GetDigestFromDigestList (TPM_ALG_SHA1, DigestList, &NewEventHdr->Digest);
@@ -1141,6 +1221,7 @@ TcgDxeHashLogExtendEvent (
   EFI_STATUS          Status;
   TPML_DIGEST_VALUES  DigestList;
   TCG_PCR_EVENT2_HDR  NoActionEvent = { 0 };
+  UINT64              StartTicks;
 
   if (!mTcgDxeData.BsCap.TPMPresentFlag) {
     return EFI_DEVICE_ERROR;
@@ -1159,12 +1240,14 @@ TcgDxeHashLogExtendEvent (
     return Status;
   }
 
-  Status = HashAndExtend (
-             NewEventHdr->PCRIndex,
-             HashData,
-             (UINTN)HashDataLen,
-             &DigestList
-             );
+  StartTicks = GetPerformanceCounter ();
+  Status     = HashAndExtend (
+                 NewEventHdr->PCRIndex,
+                 HashData,
+                 (UINTN)HashDataLen,
+                 &DigestList
+                 );
+  RecordTpmOp (Tcg2TpmOpExtend, StartTicks);
   if (!EFI_ERROR (Status)) {
     if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
       Status = TcgDxeLogHashEvent (&DigestList, NewEventHdr, NewEventData);
@@ -1215,6 +1298,7 @@ Tcg2HashLogExtendEvent (
   EFI_STATUS          Status;
   TCG_PCR_EVENT_HDR   NewEventHdr;
   TPML_DIGEST_VALUES  DigestList;
+  UINT64              StartTicks;
 
   DEBUG ((DEBUG_VERBOSE, "Tcg2HashLogExtendEvent ...\n"));
 
@@ -1245,12 +1329,14 @@ Tcg2HashLogExtendEvent (
   NewEventHdr.EventType = Event->Header.EventType;
   NewEventHdr.EventSize = Event->Size - sizeof (UINT32) - Event->Header.HeaderSize;
   if ((Flags & PE_COFF_IMAGE) != 0) {
-    Status = MeasurePeImageAndExtend (
-               NewEventHdr.PCRIndex,
-               DataToHash,
-               (UINTN)DataToHashLen,
-               &DigestList
-               );
+    StartTicks = GetPerformanceCounter ();
+    Status     = MeasurePeImageAndExtend (
+                   NewEventHdr.PCRIndex,
+                   DataToHash,
+                   (UINTN)DataToHashLen,
+                   &DigestList
+                   );
+    RecordTpmOp (Tcg2TpmOpPeImage, StartTicks);
     if (!EFI_ERROR (Status)) {
       if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
         Status = TcgDxeLogHashEvent (&DigestList, &NewEventHdr, Event->Event);
@@ -1304,8 +1390,9 @@ Tcg2SubmitCommand (
   )
 {
   EFI_STATUS  Status;
+  UINT64      StartTicks;
 
-  DEBUG ((DEBUG_INFO, "Tcg2SubmitCommand ...\n"));
+  DEBUG ((DEBUG_VERBOSE, "Tcg2SubmitCommand ...\n"));
 
   if ((This == NULL) ||
       (InputParameterBlockSize == 0) || (InputParameterBlock == NULL) ||
@@ -1326,13 +1413,15 @@ Tcg2SubmitCommand (
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = Tpm2SubmitCommand (
-             InputParameterBlockSize,
-             InputParameterBlock,
-             &OutputParameterBlockSize,
-             OutputParameterBlock
-             );
-  DEBUG ((DEBUG_INFO, "Tcg2SubmitCommand - %r\n", Status));
+  StartTicks = GetPerformanceCounter ();
+  Status     = Tpm2SubmitCommand (
+                 InputParameterBlockSize,
+                 InputParameterBlock,
+                 &OutputParameterBlockSize,
+                 OutputParameterBlock
+                 );
+  RecordTpmOp (Tcg2TpmOpSubmit, StartTicks);
+  DEBUG ((DEBUG_VERBOSE, "Tcg2SubmitCommand - %r\n", Status));
   return Status;
 }
 
@@ -1780,7 +1869,7 @@ MeasureSeparatorEvent (
   TCG_PCR_EVENT_HDR  TcgEvent;
   UINT32             EventData;
 
-  DEBUG ((DEBUG_INFO, "MeasureSeparatorEvent Pcr - %x\n", PCRIndex));
+  DEBUG ((DEBUG_VERBOSE, "MeasureSeparatorEvent Pcr - %x\n", PCRIndex));
 
   EventData          = 0;
   TcgEvent.PCRIndex  = PCRIndex;
@@ -1825,8 +1914,8 @@ MeasureVariable (
   UINTN               VarNameLength;
   UEFI_VARIABLE_DATA  *VarLog;
 
-  DEBUG ((DEBUG_INFO, "Tcg2Dxe: MeasureVariable (Pcr - %x, EventType - %x, ", (UINTN)PCRIndex, (UINTN)EventType));
-  DEBUG ((DEBUG_INFO, "VariableName - %s, VendorGuid - %g)\n", VarName, VendorGuid));
+  DEBUG ((DEBUG_VERBOSE, "Tcg2Dxe: MeasureVariable (Pcr - %x, EventType - %x, ", (UINTN)PCRIndex, (UINTN)EventType));
+  DEBUG ((DEBUG_VERBOSE, "VariableName - %s, VendorGuid - %g)\n", VarName, VendorGuid));
 
   VarNameLength      = StrLen (VarName);
   TcgEvent.PCRIndex  = PCRIndex;
@@ -2286,6 +2375,7 @@ OnReadyToBoot (
   // Increase boot attempt counter.
   //
   mBootAttempts++;
+  DumpTpmOpStats ("ReadyToBoot");
   PERF_END_EX (mImageHandle, "EventRec", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE + 1);
 }
 
@@ -2328,6 +2418,8 @@ OnExitBootServices (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_SUCCEEDED));
   }
+
+  DumpTpmOpStats ("ExitBootServices");
 }
 
 /**
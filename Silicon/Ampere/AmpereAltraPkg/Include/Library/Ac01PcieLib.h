@@ -26,6 +26,23 @@ Ac01PcieCoreSetupRC (
   IN UINT8              ReInitPcieIndex
   );
 
+/**
+  Setup and initialize all active Root Complexes and start link training.
+
+  Each initialization stage is run on every Root Complex before moving to the
+  next one, so that the mandatory delays between the stages are spent once
+  for the whole list instead of once per Root Complex. The links train in
+  parallel; Ac01PcieCorePostSetupRC () collects them.
+
+  A Root Complex that fails to initialize is marked inactive.
+
+  @param RootComplexList       Pointer to the Root Complex list
+**/
+VOID
+Ac01PcieCoreSetupAllRC (
+  IN AC01_ROOT_COMPLEX  *RootComplexList
+  );
+
 /**
   Verify the link status and retry to initialize the Root Complex if there's any issue.
 
@@ -937,111 +937,198 @@ Ac01PcieCorrectBifurcation (
 }
 
 /**
-  Setup and initialize the AC01 PCIe Root Complex and underneath PCIe controllers
+  Put a PCIe controller into reset.
 
   @param RootComplex           Pointer to Root Complex structure
-  @param ReInit                Re-init status
-  @param ReInitPcieIndex       PCIe controller index
+  @param PcieIndex             PCIe controller index
 
-  @retval RETURN_SUCCESS       The Root Complex has been initialized successfully.
-  @retval RETURN_DEVICE_ERROR  PHY, Memory or PIPE is not ready.
+  @retval TRUE                 The reset has just been asserted, the caller
+                               must give the controller 50ms to settle.
+  @retval FALSE                The controller was already in reset.
 **/
-RETURN_STATUS
-Ac01PcieCoreSetupRC (
+STATIC
+BOOLEAN
+AssertControllerReset (
   IN AC01_ROOT_COMPLEX  *RootComplex,
-  IN BOOLEAN            ReInit,
-  IN UINT8              ReInitPcieIndex
+  IN UINT8              PcieIndex
+  )
+{
+  PHYSICAL_ADDRESS  TargetAddress;
+  UINT32            Val;
+
+  TargetAddress = RootComplex->Pcie[PcieIndex].CsrBase + AC01_PCIE_CORE_RESET_REG;
+  Val           = MmioRead32 (TargetAddress);
+  if ((Val & RESET_MASK) != 0) {
+    return FALSE;
+  }
+
+  Val = DWC_PCIE_SET (Val, ASSERT_RESET);
+  MmioWrite32 (TargetAddress, Val);
+
+  return TRUE;
+}
+
+/**
+  Switch a Root Complex configured for auto bifurcation to the lowest
+  bifurcation mode, so that every possible link can be trained.
+
+  @param RootComplex           Pointer to Root Complex structure
+
+  @retval TRUE                 Auto bifurcation is in progress.
+  @retval FALSE                The Root Complex has a fixed bifurcation.
+**/
+STATIC
+BOOLEAN
+Ac01PcieStartAutoBifurcation (
+  IN AC01_ROOT_COMPLEX  *RootComplex
+  )
+{
+  if (RootComplex->DevMapLow != DevMapModeAuto) {
+    return FALSE;
+  }
+
+  // Set lowest bifurcation mode
+  RootComplex->DevMapLow = DevMapMode4;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "RootComplex->ID:%d Auto Bifurcation enabled\n",
+    RootComplex->ID
+    ));
+
+  return TRUE;
+}
+
+/**
+  Pick the bifurcation mode of a Root Complex from the links trained in the
+  lowest bifurcation mode.
+
+  As per 2.7.2. AC Specifications of PCIe card specification, the caller must
+  have waited TPVPERL (100ms) since the link training was started.
+
+  @param RootComplex           Pointer to Root Complex structure
+
+  @retval TRUE                 The bifurcation mode has changed and the Root
+                               Complex must be initialized again.
+  @retval FALSE                The Root Complex is already initialized in the
+                               selected mode.
+**/
+STATIC
+BOOLEAN
+Ac01PcieFinishAutoBifurcation (
+  IN AC01_ROOT_COMPLEX  *RootComplex
   )
 {
-  PHYSICAL_ADDRESS              CfgBase;
-  PHYSICAL_ADDRESS              CsrBase;
   PHYSICAL_ADDRESS              TargetAddress;
   RETURN_STATUS                 Status;
-  UINT32                        Val;
   UINT8                         PcieIndex;
-  BOOLEAN                       AutoLaneBifurcationEnabled = FALSE;
   PCI_REG_PCIE_LINK_CAPABILITY  LinkCap[MaxPcieController];
   AC01_PCIE_CONTROLLER          *Pcie;
   DEV_MAP_MODE                  DevMapMode;
 
-  DEBUG ((DEBUG_INFO, "Initializing Socket%d RootComplex%d\n", RootComplex->Socket, RootComplex->ID));
+  SetMem ((VOID *)LinkCap, sizeof (LinkCap), 0);
+  for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
+    Pcie = &RootComplex->Pcie[PcieIndex];
+    if (!Pcie->Active || !PcieLinkUpCheck (Pcie)) {
+      continue;
+    }
 
-AutoLaneBifurcationRetry:
-  if (!ReInit) {
-    if (AutoLaneBifurcationEnabled) {
-      //
-      // We are here after the first round
-      //
-      // As per 2.7.2. AC Specifications of PCIe card specification this TPVPERL time and
-      // should be minimum 100ms. So this is minimum time we need add and found during test.
-      //
-      MicroSecondDelay (100000);
-      SetMem ((VOID *)LinkCap, sizeof (LinkCap), 0);
-      for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
-        Pcie = &RootComplex->Pcie[PcieIndex];
-        if (!Pcie->Active || !PcieLinkUpCheck (Pcie)) {
-          continue;
-        }
+    DEBUG ((DEBUG_INFO, "RootComplex->ID:%d Port:%d link up\n", RootComplex->ID, PcieIndex));
+    TargetAddress = GetCapabilityBase (RootComplex, PcieIndex, FALSE, EFI_PCI_CAPABILITY_ID_PCIEXP);
+    if (TargetAddress == 0) {
+      continue;
+    }
 
-        DEBUG ((DEBUG_INFO, "RootComplex->ID:%d Port:%d link up\n", RootComplex->ID, PcieIndex));
-        TargetAddress = GetCapabilityBase (RootComplex, PcieIndex, FALSE, EFI_PCI_CAPABILITY_ID_PCIEXP);
-        if (TargetAddress == 0) {
-          continue;
-        }
+    LinkCap[PcieIndex].Uint32 = MmioRead32 (TargetAddress + LINK_CAPABILITIES_REG);
+  }
 
-        LinkCap[PcieIndex].Uint32 = MmioRead32 (TargetAddress + LINK_CAPABILITIES_REG);
-      }
+  Status = Ac01PcieCorrectBifurcation (RootComplex, LinkCap, MaxPcieControllerOfRootComplexA, &DevMapMode);
+  if (!EFI_ERROR (Status)) {
+    RootComplex->DevMapLow = DevMapMode;
+    DEBUG ((
+      DEBUG_INFO,
+      "RootComplex->ID:%d Auto Bifurcation done, DevMapMode:%d\n",
+      RootComplex->ID,
+      RootComplex->DevMapLow
+      ));
+  } else {
+    RootComplex->DevMapLow = DevMapMode1;
+    DEBUG ((
+      DEBUG_INFO,
+      "RootComplex->ID:%d Auto Bifurcation failed, revert to DevMapMode1\n",
+      RootComplex->ID
+      ));
+  }
 
-      Status = Ac01PcieCorrectBifurcation (RootComplex, LinkCap, MaxPcieControllerOfRootComplexA, &DevMapMode);
-      if (!EFI_ERROR (Status)) {
-        RootComplex->DevMapLow = DevMapMode;
-        DEBUG ((
-          DEBUG_INFO,
-          "RootComplex->ID:%d Auto Bifurcation done, DevMapMode:%d\n",
-          RootComplex->ID,
-          RootComplex->DevMapLow
-          ));
-      } else {
-        RootComplex->DevMapLow = DevMapMode1;
-        DEBUG ((
-          DEBUG_INFO,
-          "RootComplex->ID:%d Auto Bifurcation failed, revert to DevMapMode1\n",
-          RootComplex->ID
-          ));
-      }
+  if (RootComplex->DevMapLow == DevMapMode4) {
+    // The RootComplex already initialized in this mode
+    return FALSE;
+  }
+
+  //
+  // Update the RootComplex data with new DevMapMode
+  //
+  Ac01PcieUpdateActive (RootComplex);
+  Ac01PcieUpdateMaxWidth (RootComplex);
 
-      AutoLaneBifurcationEnabled = FALSE;
+  return TRUE;
+}
 
-      if (DevMapMode == DevMapMode4) {
-        // Return directly as the RootComplex already initialized in this mode
-        return EFI_SUCCESS;
-      }
+/**
+  First stage of the Root Complex initialization: program the bifurcation and
+  put the active controllers into reset.
 
-      //
-      // Update the RootComplex data with new DevMapMode
-      //
-      Ac01PcieUpdateActive (RootComplex);
-      Ac01PcieUpdateMaxWidth (RootComplex);
-    } else {
-      if (RootComplex->DevMapLow == DevMapModeAuto) {
-        // Set lowest bifurcation mode
-        RootComplex->DevMapLow = DevMapMode4;
+  The caller must wait 100ms before starting the Root Complex. This covers
+  both the settle time of the bifurcation register before the PHY
+  initialization and the reset time of the controllers.
 
-        AutoLaneBifurcationEnabled = TRUE;
-        DEBUG ((
-          DEBUG_INFO,
-          "RootComplex->ID:%d Auto Bifurcation enabled\n",
-          RootComplex->ID
-          ));
-      }
+  @param RootComplex           Pointer to Root Complex structure
+**/
+STATIC
+VOID
+Ac01PcieCorePrepareRC (
+  IN AC01_ROOT_COMPLEX  *RootComplex
+  )
+{
+  UINT8  PcieIndex;
+
+  ProgramHostBridgeInfo (RootComplex);
+
+  for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
+    if (RootComplex->Pcie[PcieIndex].Active) {
+      AssertControllerReset (RootComplex, PcieIndex);
     }
+  }
+}
 
-    ProgramHostBridgeInfo (RootComplex);
+/**
+  Second stage of the Root Complex initialization: initialize the PHY, setup
+  the controllers and start the link training. This does not wait for the
+  links to come up.
 
-    // Fix for UEFI hang due to timing change with bifurcation
-    // register moved very close to PHY initialization.
-    MicroSecondDelay (100000);
+  @param RootComplex           Pointer to Root Complex structure
+  @param ReInit                Re-init status
+  @param ReInitPcieIndex       PCIe controller index
+
+  @retval RETURN_SUCCESS       The link training has been started.
+  @retval RETURN_DEVICE_ERROR  PHY, Memory or PIPE is not ready.
+**/
+STATIC
+RETURN_STATUS
+Ac01PcieCoreStartRC (
+  IN AC01_ROOT_COMPLEX  *RootComplex,
+  IN BOOLEAN            ReInit,
+  IN UINT8              ReInitPcieIndex
+  )
+{
+  PHYSICAL_ADDRESS  CfgBase;
+  PHYSICAL_ADDRESS  CsrBase;
+  PHYSICAL_ADDRESS  TargetAddress;
+  RETURN_STATUS     Status;
+  UINT32            Val;
+  UINT8             PcieIndex;
 
+  if (!ReInit) {
     Status = PciePhyInit (RootComplex->SerdesBase);
     if (RETURN_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a: Failed to initialize the PCIe PHY\n", __func__));
@@ -1065,12 +1152,7 @@ AutoLaneBifurcationRetry:
     CfgBase = RootComplex->MmcfgBase + (RootComplex->Pcie[PcieIndex].DevNum << DEV_SHIFT);
 
     // Put Controller into reset if not in reset already
-    TargetAddress = CsrBase + AC01_PCIE_CORE_RESET_REG;
-    Val           = MmioRead32 (TargetAddress);
-    if (!(Val & RESET_MASK)) {
-      Val = DWC_PCIE_SET (Val, ASSERT_RESET);
-      MmioWrite32 (TargetAddress, Val);
-
+    if (AssertControllerReset (RootComplex, PcieIndex)) {
       // Delay 50ms to ensure controller finish its reset
       MicroSecondDelay (50000);
     }
@@ -1212,11 +1294,148 @@ AutoLaneBifurcationRetry:
     }
   }
 
-  if (AutoLaneBifurcationEnabled) {
-    goto AutoLaneBifurcationRetry;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Setup and initialize the AC01 PCIe Root Complex and underneath PCIe controllers
+
+  @param RootComplex           Pointer to Root Complex structure
+  @param ReInit                Re-init status
+  @param ReInitPcieIndex       PCIe controller index
+
+  @retval RETURN_SUCCESS       The Root Complex has been initialized successfully.
+  @retval RETURN_DEVICE_ERROR  PHY, Memory or PIPE is not ready.
+**/
+RETURN_STATUS
+Ac01PcieCoreSetupRC (
+  IN AC01_ROOT_COMPLEX  *RootComplex,
+  IN BOOLEAN            ReInit,
+  IN UINT8              ReInitPcieIndex
+  )
+{
+  RETURN_STATUS  Status;
+  BOOLEAN        AutoLaneBifurcationEnabled;
+
+  DEBUG ((DEBUG_INFO, "Initializing Socket%d RootComplex%d\n", RootComplex->Socket, RootComplex->ID));
+
+  if (ReInit) {
+    return Ac01PcieCoreStartRC (RootComplex, TRUE, ReInitPcieIndex);
   }
 
-  return RETURN_SUCCESS;
+  AutoLaneBifurcationEnabled = Ac01PcieStartAutoBifurcation (RootComplex);
+
+  Ac01PcieCorePrepareRC (RootComplex);
+
+  // Fix for UEFI hang due to timing change with bifurcation
+  // register moved very close to PHY initialization.
+  MicroSecondDelay (100000);
+
+  Status = Ac01PcieCoreStartRC (RootComplex, FALSE, 0);
+  if (RETURN_ERROR (Status) || !AutoLaneBifurcationEnabled) {
+    return Status;
+  }
+
+  // TPVPERL, see Ac01PcieFinishAutoBifurcation ()
+  MicroSecondDelay (100000);
+
+  if (!Ac01PcieFinishAutoBifurcation (RootComplex)) {
+    return RETURN_SUCCESS;
+  }
+
+  Ac01PcieCorePrepareRC (RootComplex);
+  MicroSecondDelay (100000);
+
+  return Ac01PcieCoreStartRC (RootComplex, FALSE, 0);
+}
+
+/**
+  Setup and initialize all active Root Complexes and start link training.
+
+  Each initialization stage is run on every Root Complex before moving to the
+  next one, so that the mandatory delays between the stages are spent once
+  for the whole list instead of once per Root Complex. The links train in
+  parallel; Ac01PcieCorePostSetupRC () collects them.
+
+  A Root Complex that fails to initialize is marked inactive.
+
+  @param RootComplexList       Pointer to the Root Complex list
+**/
+VOID
+Ac01PcieCoreSetupAllRC (
+  IN AC01_ROOT_COMPLEX  *RootComplexList
+  )
+{
+  AC01_ROOT_COMPLEX  *RootComplex;
+  RETURN_STATUS      Status;
+  BOOLEAN            AutoBifurcation[AC01_PCIE_MAX_ROOT_COMPLEX];
+  BOOLEAN            StartNeeded[AC01_PCIE_MAX_ROOT_COMPLEX];
+  BOOLEAN            Pending;
+  UINT8              RCIndex;
+
+  for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
+    RootComplex              = &RootComplexList[RCIndex];
+    AutoBifurcation[RCIndex] = FALSE;
+    StartNeeded[RCIndex]     = RootComplex->Active;
+    if (!RootComplex->Active) {
+      continue;
+    }
+
+    DEBUG ((DEBUG_INFO, "Initializing Socket%d RootComplex%d\n", RootComplex->Socket, RootComplex->ID));
+    AutoBifurcation[RCIndex] = Ac01PcieStartAutoBifurcation (RootComplex);
+    Ac01PcieCorePrepareRC (RootComplex);
+  }
+
+  //
+  // Two rounds at most: the second one re-initializes the Root Complexes
+  // whose bifurcation mode was changed by the auto bifurcation.
+  //
+  do {
+    // Fix for UEFI hang due to timing change with bifurcation
+    // register moved very close to PHY initialization.
+    MicroSecondDelay (100000);
+
+    Pending = FALSE;
+    for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
+      RootComplex = &RootComplexList[RCIndex];
+      if (!StartNeeded[RCIndex]) {
+        continue;
+      }
+
+      StartNeeded[RCIndex] = FALSE;
+      Status               = Ac01PcieCoreStartRC (RootComplex, FALSE, 0);
+      if (RETURN_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "S%d-RC%d: Failed to initialize\n", RootComplex->Socket, RootComplex->ID));
+        RootComplex->Active      = FALSE;
+        AutoBifurcation[RCIndex] = FALSE;
+        continue;
+      }
+
+      Pending |= AutoBifurcation[RCIndex];
+    }
+
+    if (!Pending) {
+      break;
+    }
+
+    // TPVPERL, see Ac01PcieFinishAutoBifurcation ()
+    MicroSecondDelay (100000);
+
+    Pending = FALSE;
+    for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
+      RootComplex = &RootComplexList[RCIndex];
+      if (!AutoBifurcation[RCIndex]) {
+        continue;
+      }
+
+      AutoBifurcation[RCIndex] = FALSE;
+      if (Ac01PcieFinishAutoBifurcation (RootComplex)) {
+        Ac01PcieCorePrepareRC (RootComplex);
+        StartNeeded[RCIndex] = TRUE;
+        Pending              = TRUE;
+      }
+    }
+  } while (Pending);
 }
 
 BOOLEAN
@@ -1750,6 +1969,109 @@ Ac01PcieCoreCheckCardPresent (
   return FALSE;
 }
 
+/**
+  Finish the initialization of a controller whose link has come up.
+
+  @param RootComplex          Pointer to AC01_ROOT_COMPLEX structure
+  @param PcieIndex            PCIe controller index
+**/
+STATIC
+VOID
+Ac01PcieCoreLinkUpDone (
+  IN AC01_ROOT_COMPLEX  *RootComplex,
+  IN UINT8              PcieIndex
+  )
+{
+  RootComplex->Pcie[PcieIndex].LinkUp = TRUE;
+
+  // Doing link checking and recovery if needed
+  Ac01PcieCoreQoSLinkCheckRecovery (RootComplex, PcieIndex);
+
+  // Un-mask Completion Timeout
+  DisableCompletionTimeOut (RootComplex, PcieIndex, FALSE);
+}
+
+/**
+  Check whether the link of a controller has trained to the maximum speed
+  and width of the Root Port.
+
+  Only the Root Port side is read. A link limited by its endpoint never
+  reports TRUE here and is left to the link check after the training window.
+
+  @param RootComplex          Pointer to AC01_ROOT_COMPLEX structure
+  @param PcieIndex            PCIe controller index
+
+  @retval TRUE                The link is up at the Root Port maximum speed and width.
+  @retval FALSE               The link is down or still training.
+**/
+STATIC
+BOOLEAN
+Ac01PcieCoreLinkTrained (
+  IN AC01_ROOT_COMPLEX  *RootComplex,
+  IN UINT8              PcieIndex
+  )
+{
+  PHYSICAL_ADDRESS  CfgBase;
+  UINT32            LinkCap;
+  UINT32            LinkStatus;
+
+  if (!PcieLinkUpCheck (&RootComplex->Pcie[PcieIndex])) {
+    return FALSE;
+  }
+
+  CfgBase    = RootComplex->MmcfgBase + (RootComplex->Pcie[PcieIndex].DevNum << DEV_SHIFT);
+  LinkCap    = MmioRead32 (CfgBase + PCIE_CAPABILITY_BASE + LINK_CAPABILITIES_REG);
+  LinkStatus = MmioRead32 (CfgBase + PCIE_CAPABILITY_BASE + LINK_CONTROL_LINK_STATUS_REG);
+
+  return (BOOLEAN)((CAP_MAX_LINK_WIDTH_GET (LinkCap) != 0) &&
+                   (CAP_NEGO_LINK_WIDTH_GET (LinkStatus) == CAP_MAX_LINK_WIDTH_GET (LinkCap)) &&
+                   (CAP_LINK_SPEED_GET (LinkStatus) == CAP_MAX_LINK_SPEED_GET (LinkCap)));
+}
+
+/**
+  Check whether every active controller which is not up yet has trained.
+
+  The link state is only read. Marking the links up and the link check and
+  recovery are left to Ac01PcieCoreUpdateLink () once the wait is over, so
+  that no soft reset is triggered while other links are still training.
+
+  @param RootComplexList      Pointer to the Root Complex list
+
+  @retval TRUE                All active controllers have trained.
+  @retval FALSE               Some controllers are still training.
+**/
+STATIC
+BOOLEAN
+Ac01PcieCoreAllLinksTrained (
+  IN AC01_ROOT_COMPLEX  *RootComplexList
+  )
+{
+  AC01_ROOT_COMPLEX     *RootComplex;
+  AC01_PCIE_CONTROLLER  *Pcie;
+  UINT8                 RCIndex;
+  UINT8                 PcieIndex;
+
+  for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
+    RootComplex = &RootComplexList[RCIndex];
+    if (!RootComplex->Active) {
+      continue;
+    }
+
+    for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
+      Pcie = &RootComplex->Pcie[PcieIndex];
+      if (!Pcie->Active || Pcie->LinkUp) {
+        continue;
+      }
+
+      if (!Ac01PcieCoreLinkTrained (RootComplex, PcieIndex)) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
 VOID
 Ac01PcieCoreUpdateLink (
   IN  AC01_ROOT_COMPLEX  *RootComplex,
@@ -1778,13 +2100,7 @@ Ac01PcieCoreUpdateLink (
 
     if (Pcie->Active && !Pcie->LinkUp) {
       if (PcieLinkUpCheck (Pcie)) {
-        Pcie->LinkUp = TRUE;
-
-        // Doing link checking and recovery if needed
-        Ac01PcieCoreQoSLinkCheckRecovery (RootComplex, PcieIndex);
-
-        // Un-mask Completion Timeout
-        DisableCompletionTimeOut (RootComplex, PcieIndex, FALSE);
+        Ac01PcieCoreLinkUpDone (RootComplex, PcieIndex);
       } else {
         FailedPciePtr[*FailedPcieCount] = PcieIndex;
         *FailedPcieCount               += 1;
@@ -1824,11 +2140,21 @@ _link_polling:
   // It is not guaranteed the timer service is ready prior to PCI Dxe.
   // Calculate system ticks for link training.
   //
+  // The links of all Root Complexes train in parallel. The wait ends early
+  // once every active controller has trained to the maximum speed and width
+  // of its Root Port, the link check and recovery run after the wait.
+  //
   TimerTicks64 = ArmGenericTimerGetTimerFreq (); /* 1 Second */
   PrevTick     = ArmGenericTimerGetSystemCount ();
   ElapsedCycle = 0;
 
   do {
+    if (Ac01PcieCoreAllLinksTrained (RootComplexList)) {
+      break;
+    }
+
+    MicroSecondDelay (LINK_WAIT_INTERVAL_US);
+
     CurrTick = ArmGenericTimerGetSystemCount ();
     if (CurrTick < PrevTick) {
       ElapsedCycle += MAX_UINT64 - PrevTick;
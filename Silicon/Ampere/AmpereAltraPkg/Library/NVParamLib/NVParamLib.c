@@ -14,6 +14,27 @@
 
 #include "NVParamLibCommon.h"
 
+//
+// Each module linking this library keeps its own cache, so the cached
+// values never outlive the boot phase of the module reading them. Only
+// the read-only board settings are cached, see NVPARAM_CACHEABLE.
+//
+STATIC NVPARAM_CACHE  mNVParamCache;
+
+/**
+  Return the read-through cache of the current module.
+
+  @retval NULL                    Caching is not available in this phase.
+  @retval Others                  Pointer to the cache.
+**/
+NVPARAM_CACHE *
+NVParamGetCache (
+  VOID
+  )
+{
+  return &mNVParamCache;
+}
+
 /**
   Provides an interface to access the NVParam services via MM interface.
 
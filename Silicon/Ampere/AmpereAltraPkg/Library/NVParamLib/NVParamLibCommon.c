@@ -12,9 +12,110 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/NVParamLib.h>
+#include <NVParamDef.h>
 
 #include "NVParamLibCommon.h"
 
+/**
+  Look up a parameter in the read-through cache.
+
+  @param[in]  Param               Parameter ID to retrieve
+  @param[in]  ACLRd               Permission for read operation.
+
+  @retval NULL                    The parameter is not cached.
+  @retval Others                  Pointer to the cache entry.
+**/
+STATIC
+NVPARAM_CACHE_ENTRY *
+NVParamCacheLookup (
+  IN UINT32  Param,
+  IN UINT16  ACLRd
+  )
+{
+  NVPARAM_CACHE        *Cache;
+  NVPARAM_CACHE_ENTRY  *Entry;
+
+  if (!NVPARAM_CACHEABLE (Param)) {
+    return NULL;
+  }
+
+  Cache = NVParamGetCache ();
+  if (Cache == NULL) {
+    return NULL;
+  }
+
+  Entry = &Cache->Entries[(Param / NVPARAM_SIZE) % NVPARAM_CACHE_ENTRIES];
+  if (!Entry->Valid || (Entry->Param != Param) || (Entry->ACLRd != ACLRd)) {
+    return NULL;
+  }
+
+  return Entry;
+}
+
+/**
+  Record the result of a successful read in the read-through cache.
+
+  Parameters outside of the read-only board settings are not recorded.
+
+  @param[in] Param                Parameter ID
+  @param[in] ACLRd                Permission used for the read operation.
+  @param[in] NotSet               TRUE if the parameter is not set.
+  @param[in] Value                Value of the parameter.
+**/
+STATIC
+VOID
+NVParamCacheFill (
+  IN UINT32   Param,
+  IN UINT16   ACLRd,
+  IN BOOLEAN  NotSet,
+  IN UINT32   Value
+  )
+{
+  NVPARAM_CACHE        *Cache;
+  NVPARAM_CACHE_ENTRY  *Entry;
+
+  if (!NVPARAM_CACHEABLE (Param)) {
+    return;
+  }
+
+  Cache = NVParamGetCache ();
+  if (Cache == NULL) {
+    return;
+  }
+
+  Entry         = &Cache->Entries[(Param / NVPARAM_SIZE) % NVPARAM_CACHE_ENTRIES];
+  Entry->Param  = Param;
+  Entry->ACLRd  = ACLRd;
+  Entry->NotSet = NotSet;
+  Entry->Value  = Value;
+  Entry->Valid  = TRUE;
+}
+
+/**
+  Drop a parameter from the read-through cache.
+
+  @param[in] Param                Parameter ID
+**/
+STATIC
+VOID
+NVParamCacheInvalidate (
+  IN UINT32  Param
+  )
+{
+  NVPARAM_CACHE        *Cache;
+  NVPARAM_CACHE_ENTRY  *Entry;
+
+  Cache = NVParamGetCache ();
+  if (Cache == NULL) {
+    return;
+  }
+
+  Entry = &Cache->Entries[(Param / NVPARAM_SIZE) % NVPARAM_CACHE_ENTRIES];
+  if (Entry->Param == Param) {
+    Entry->Valid = FALSE;
+  }
+}
+
 /**
   Retrieve a non-volatile parameter.
 
@@ -40,12 +141,23 @@ NVParamGet (
 {
   EFI_MM_COMMUNICATE_NVPARAM_RESPONSE  MmNVParamRes;
   EFI_STATUS                           Status;
+  NVPARAM_CACHE_ENTRY                  *Entry;
   UINT64                               MmData[5];
 
   if (Val == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
+  Entry = NVParamCacheLookup (Param, ACLRd);
+  if (Entry != NULL) {
+    if (Entry->NotSet) {
+      return EFI_NOT_FOUND;
+    }
+
+    *Val = Entry->Value;
+    return EFI_SUCCESS;
+  }
+
   MmData[0] = MM_NVPARAM_FUNC_READ;
   MmData[1] = Param;
   MmData[2] = (UINT64)ACLRd;
@@ -63,9 +175,11 @@ NVParamGet (
   switch (MmNVParamRes.Status) {
     case MM_NVPARAM_RES_SUCCESS:
       *Val = (UINT32)MmNVParamRes.Value;
+      NVParamCacheFill (Param, ACLRd, FALSE, *Val);
       return EFI_SUCCESS;
 
     case MM_NVPARAM_RES_NOT_SET:
+      NVParamCacheFill (Param, ACLRd, TRUE, 0);
       return EFI_NOT_FOUND;
 
     case MM_NVPARAM_RES_NO_PERM:
@@ -109,6 +223,8 @@ NVParamSet (
   EFI_STATUS                           Status;
   UINT64                               MmData[5];
 
+  NVParamCacheInvalidate (Param);
+
   MmData[0] = MM_NVPARAM_FUNC_WRITE;
   MmData[1] = Param;
   MmData[2] = (UINT64)ACLRd;
@@ -164,6 +280,8 @@ NVParamClr (
   EFI_STATUS                           Status;
   UINT64                               MmData[5];
 
+  NVParamCacheInvalidate (Param);
+
   MmData[0] = MM_NVPARAM_FUNC_CLEAR;
   MmData[1] = Param;
   MmData[2] = 0;
@@ -208,8 +326,14 @@ NVParamClrAll (
 {
   EFI_MM_COMMUNICATE_NVPARAM_RESPONSE  MmNVParamRes;
   EFI_STATUS                           Status;
+  NVPARAM_CACHE                        *Cache;
   UINT64                               MmData[5];
 
+  Cache = NVParamGetCache ();
+  if (Cache != NULL) {
+    ZeroMem (Cache, sizeof (*Cache));
+  }
+
   MmData[0] = MM_NVPARAM_FUNC_CLEAR_ALL;
 
   Status = NVParamMmCommunicate (
@@ -47,6 +47,43 @@ typedef struct {
 
 #pragma pack ()
 
+//
+// Number of entries of the read-through cache. The cache is direct-mapped
+// on the parameter index (Param / NVPARAM_SIZE).
+//
+#define NVPARAM_CACHE_ENTRIES  64
+
+//
+// Only the board settings are cached. They are read-only, so a copy cached
+// by one module cannot go stale when another module sets or clears a
+// parameter.
+//
+#define NVPARAM_CACHEABLE(Param) \
+  (((Param) >= NV_BOARD_PARAM_START) && ((Param) <= NV_BOARD_PARAM_MAX))
+
+typedef struct {
+  UINT32     Param;
+  UINT32     Value;
+  UINT16     ACLRd;
+  BOOLEAN    Valid;
+  BOOLEAN    NotSet;
+} NVPARAM_CACHE_ENTRY;
+
+typedef struct {
+  NVPARAM_CACHE_ENTRY    Entries[NVPARAM_CACHE_ENTRIES];
+} NVPARAM_CACHE;
+
+/**
+  Return the read-through cache of the current module.
+
+  @retval NULL                    Caching is not available in this phase.
+  @retval Others                  Pointer to the cache.
+**/
+NVPARAM_CACHE *
+NVParamGetCache (
+  VOID
+  );
+
 /**
   Provides an interface to access the NVParam services via MM interface.
 
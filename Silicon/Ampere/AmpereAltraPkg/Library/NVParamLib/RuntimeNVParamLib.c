@@ -19,6 +19,48 @@
 
 STATIC EFI_MM_COMMUNICATION2_PROTOCOL  *mMmCommunicationProtocol = NULL;
 
+//
+// The cache is only used during boot time. At runtime, the parameters may be
+// changed behind our back through the BMC or manufactory interface.
+//
+STATIC NVPARAM_CACHE  mNVParamCache;
+STATIC BOOLEAN        mNVParamAtRuntime = FALSE;
+
+/**
+  Return the read-through cache of the current module.
+
+  @retval NULL                    Caching is not available in this phase.
+  @retval Others                  Pointer to the cache.
+**/
+NVPARAM_CACHE *
+NVParamGetCache (
+  VOID
+  )
+{
+  if (mNVParamAtRuntime) {
+    return NULL;
+  }
+
+  return &mNVParamCache;
+}
+
+/**
+  This is a notification function registered on EVT_SIGNAL_EXIT_BOOT_SERVICES
+  event. It stops using the cache.
+
+  @param  Event        Event whose notification function is being invoked.
+  @param  Context      Pointer to the notification function's context
+**/
+VOID
+EFIAPI
+NVParamLibExitBootServicesEvent (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mNVParamAtRuntime = TRUE;
+}
+
 /**
   This is a notification function registered on EVT_SIGNAL_VIRTUAL_ADDRESS_CHANGE
   event. It converts a pointer to a new virtual address.
@@ -53,6 +95,7 @@ NVParamLibConstructor (
   )
 {
   EFI_EVENT   VirtualAddressChangeEvent = NULL;
+  EFI_EVENT   ExitBootServicesEvent     = NULL;
   EFI_STATUS  Status;
 
   Status = gBS->LocateProtocol (
@@ -71,6 +114,15 @@ NVParamLibConstructor (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  Status = gBS->CreateEvent (
+                  EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                  TPL_NOTIFY,
+                  NVParamLibExitBootServicesEvent,
+                  NULL,
+                  &ExitBootServicesEvent
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   return Status;
 }
 
@@ -241,6 +241,9 @@ Tpm2SubmitCommand (
   UINT32                      TpmOutSize;
   UINT16                      Data16;
   UINT32                      Data32;
+  UINT64                      StartTicks;
+
+  StartTicks = GetPerformanceCounter ();
 
   DEBUG_CODE (
     UINTN DebugSize;
@@ -364,6 +367,14 @@ GoIdle_Exit:
   //
   MmioWrite32 ((UINTN)&Tpm2ControlArea->CrbControlRequest, CRB_CONTROL_AREA_REQUEST_GO_IDLE);
 
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "ArmCrbTpmCommand 0x%x - %r, %ld us\n",
+    SwapBytes32 (ReadUnaligned32 ((UINT32 *)(InputParameterBlock + sizeof (TPMI_ST_COMMAND_TAG) + sizeof (UINT32)))),
+    Status,
+    DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks), 1000)
+    ));
+
   return Status;
 }
 
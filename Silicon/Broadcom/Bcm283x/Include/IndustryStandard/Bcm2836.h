@@ -22,6 +22,11 @@
  */
 #define BCM2836_DMA_DEVICE_OFFSET                           0xc0000000
 
+/*
+ * Peripherals as seen by the DMA engine.
+ */
+#define BCM2836_PERIPHERAL_BUS_ADDRESS                      0x7e000000
+
 /* watchdog constants */
 #define BCM2836_WDOG_OFFSET                                 0x00100000
 #define BCM2836_WDOG_BASE_ADDRESS                           (BCM2836_SOC_REGISTERS + BCM2836_WDOG_OFFSET)
@@ -121,4 +126,30 @@
 
 #define BCM2836_DMA_CHANNEL_LENGTH                          0x00000100
 
+#define BCM2836_DMA_ENABLE_OFFSET                           0x00000010
+
+/* per-channel registers */
+#define BCM2836_DMA_CS                                      0x00000000
+#define BCM2836_DMA_CONBLK_AD                               0x00000004
+#define BCM2836_DMA_DEBUG                                   0x00000020
+
+#define BCM2836_DMA_CS_ACTIVE                               BIT0
+#define BCM2836_DMA_CS_END                                  BIT1
+#define BCM2836_DMA_CS_INT                                  BIT2
+#define BCM2836_DMA_CS_ERROR                                BIT8
+#define BCM2836_DMA_CS_WAIT_FOR_OUTSTANDING_WRITES          BIT28
+#define BCM2836_DMA_CS_ABORT                                BIT30
+#define BCM2836_DMA_CS_RESET                                BIT31
+
+/* control block transfer information */
+#define BCM2836_DMA_TI_WAIT_RESP                            BIT3
+#define BCM2836_DMA_TI_DEST_INC                             BIT4
+#define BCM2836_DMA_TI_DEST_DREQ                            BIT6
+#define BCM2836_DMA_TI_SRC_INC                              BIT8
+#define BCM2836_DMA_TI_SRC_DREQ                             BIT10
+#define BCM2836_DMA_TI_PERMAP(Dreq)                         ((Dreq) << 16)
+
+/* peripheral DREQ lines */
+#define BCM2836_DMA_DREQ_SDHOST                             13
+
 #endif /*__BCM2836_H__ */
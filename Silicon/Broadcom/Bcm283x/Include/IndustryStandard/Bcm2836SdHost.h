@@ -32,6 +32,8 @@
 #define SDHOST_DATA                 SDHOST_REG(0x40)
 #define SDHOST_HBLC                 SDHOST_REG(0x50)
 
+#define SDHOST_DATA_BUS_ADDRESS     (BCM2836_PERIPHERAL_BUS_ADDRESS + SDHOST_OFFSET + 0x40)
+
 //
 // CMD
 //
@@ -413,6 +413,7 @@ VOID
 struct _DATABASE_RECORD {
   UINT32                        Signature;
   LIST_ENTRY                    Link;
+  LIST_ENTRY                    SmiStsLink;
   BOOLEAN                       Processed;
   ///
   /// Status and Enable bit description
@@ -457,6 +458,7 @@ struct _DATABASE_RECORD {
 };
 
 #define DATABASE_RECORD_FROM_LINK(_record)  CR (_record, DATABASE_RECORD, Link, DATABASE_RECORD_SIGNATURE)
+#define DATABASE_RECORD_FROM_SMI_STS_LINK(_record)  CR (_record, DATABASE_RECORD, SmiStsLink, DATABASE_RECORD_SIGNATURE)
 #define DATABASE_RECORD_FROM_CHILDCONTEXT(_record)  CR (_record, DATABASE_RECORD, ChildContext, DATABASE_RECORD_SIGNATURE)
 
 ///
@@ -581,6 +583,11 @@ typedef struct {
   PROTOCOL_SIGNATURE \
   )
 
+///
+/// Number of SMI_STS bits used to index the callback database
+///
+#define PCH_SMI_STS_BUCKET_MAX  32
+
 ///
 /// Create private data for the protocols that we'll publish
 ///
@@ -589,6 +596,14 @@ typedef struct {
   EFI_HANDLE                  SmiHandle;
   EFI_HANDLE                  InstallMultProtHandle;
   PCH_SMM_QUALIFIED_PROTOCOL  Protocols[PCH_SMM_PROTOCOL_TYPE_MAX];
+  ///
+  /// Records indexed by their top level SMI_STS bit, so the dispatcher only
+  /// scans the children whose status bit is set. Records whose top level
+  /// status is not reported in SMI_STS are kept in OtherSources.
+  ///
+  LIST_ENTRY                  SmiStsBucket[PCH_SMI_STS_BUCKET_MAX];
+  LIST_ENTRY                  OtherSources;
+  UINT32                      SmiStsBucketMask;
 } PRIVATE_DATA;
 
 extern PRIVATE_DATA           mPrivateData;
@@ -611,6 +626,27 @@ SmmCoreInsertRecord (
   OUT EFI_HANDLE                        *DispatchHandle
   );
 
+/**
+  Add a database record to the SMI_STS bucket it is dispatched from.
+  The record must already be in the callback database.
+
+  @param[in] Record                     Record to index.
+**/
+VOID
+SmmCoreIndexRecord (
+  IN  DATABASE_RECORD                   *Record
+  );
+
+/**
+  Remove a database record from its SMI_STS bucket.
+
+  @param[in] Record                     Record to remove from the index.
+**/
+VOID
+SmmCoreUnindexRecord (
+  IN  DATABASE_RECORD                   *Record
+  );
+
 /**
   Get the Sleep type
 
@@ -0,0 +1,111 @@
+/** @file
+  The definition of the SMI latency profile communicate interface.
+
+  An SMI dispatcher that keeps TSC cycle counts and log2 latency histograms
+  for the SMIs it handles and for each registered child exports them through
+  an MM communicate buffer with this GUID. The layout of the commands follows
+  the SMI handler profile: the caller first gets the database size, then reads
+  the database in chunks by offset.
+
+  The interface is only available when PcdSmiLatencyProfileEnable is TRUE.
+  It stays available at runtime, so the profile is meant for debug builds.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _SMI_LATENCY_PROFILE_H_
+#define _SMI_LATENCY_PROFILE_H_
+
+#define SMI_LATENCY_PROFILE_GUID \
+  { \
+    0x0034b495, 0x1f70, 0x4dcb, { 0xbf, 0x4c, 0xaf, 0x36, 0x8c, 0x07, 0x92, 0x01 } \
+  }
+
+extern EFI_GUID gSmiLatencyProfileGuid;
+
+#define SMI_LATENCY_PROFILE_COMMAND_GET_INFO            0x1
+#define SMI_LATENCY_PROFILE_COMMAND_GET_DATA_BY_OFFSET  0x2
+#define SMI_LATENCY_PROFILE_COMMAND_RESET               0x3
+
+typedef struct {
+  UINT32                            Command;
+  UINT32                            DataLength;
+  UINT64                            ReturnStatus;
+} SMI_LATENCY_PROFILE_PARAMETER_HEADER;
+
+typedef struct {
+  SMI_LATENCY_PROFILE_PARAMETER_HEADER  Header;
+  UINT64                                DataSize;
+} SMI_LATENCY_PROFILE_PARAMETER_GET_INFO;
+
+typedef struct {
+  SMI_LATENCY_PROFILE_PARAMETER_HEADER  Header;
+  //
+  // On input, data buffer size.
+  // On output, actual data buffer size copied.
+  //
+  UINT64                                DataSize;
+  PHYSICAL_ADDRESS                      DataBuffer;
+  //
+  // On input, data buffer offset to copy.
+  // On output, next time data buffer offset to copy.
+  //
+  UINT64                                DataOffset;
+} SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET;
+
+///
+/// Histogram[Index] counts the samples that took [2^Index, 2^(Index+1)) TSC
+/// cycles. The first bucket also counts samples of 0 cycles and the last one
+/// counts every longer sample.
+///
+#define SMI_LATENCY_HISTOGRAM_BUCKETS  32
+
+typedef struct {
+  UINT64                            Count;
+  UINT64                            TotalCycles;
+  UINT64                            MaxCycles;
+  UINT32                            Histogram[SMI_LATENCY_HISTOGRAM_BUCKETS];
+} SMI_LATENCY_STATISTICS;
+
+typedef struct {
+  //
+  // Dispatch protocol the child registered with, or zero when the child
+  // registered through a dispatcher specific interface.
+  //
+  EFI_GUID                          ProtocolGuid;
+  //
+  // Dispatcher specific type of the child.
+  //
+  UINT32                            ProtocolType;
+  UINT32                            SubType;
+  //
+  // File GUID of the driver containing the child handler, or zero if it is
+  // not known.
+  //
+  EFI_GUID                          ImageGuid;
+  //
+  // Position of the child in the dispatcher database.
+  //
+  UINT32                            Index;
+  UINT32                            Reserved;
+  SMI_LATENCY_STATISTICS            Statistics;
+} SMI_LATENCY_CHILD_RECORD;
+
+#define SMI_LATENCY_PROFILE_SIGNATURE  SIGNATURE_32 ('S', 'L', 'P', 'F')
+
+typedef struct {
+  UINT32                            Signature;
+  UINT32                            Length;
+  UINT32                            ChildCount;
+  UINT32                            Reserved;
+  //
+  // Every SMI seen by the dispatcher, from entry to exit.
+  //
+  SMI_LATENCY_STATISTICS            Dispatcher;
+  //
+  // SMI_LATENCY_CHILD_RECORD       Children[ChildCount];
+  //
+} SMI_LATENCY_PROFILE_DATABASE;
+
+#endif
@@ -68,6 +68,7 @@ PchSmiRecordInsert (
   // After ensuring the source of event is not null, we will insert the record into the database
   //
   InsertTailList (&mPrivateData.CallbackDataBase, &Record->Link);
+  SmmCoreIndexRecord (Record);
 
   //
   // Child's handle will be the address linked list link in the record
@@ -108,323 +108,417 @@ GpioDwRegValueFromGpioConfig (
   }
 }
 
+//
+// Maximum number of pads in one group
+//
+#define GPIO_GROUP_MAX_PADS  (GPIO_GROUP_DW_NUMBER * 32)
+
+//
+// Number of PADCFG DW registers programmed by GpioConfigurePch
+//
+#define GPIO_PADCFG_DW_PROGRAMMED  3
+
+//
+// GPIO_GROUP_PLAN is the result of compiling all GPIO_INIT_CONFIG entries
+// which belong to one group. Every register of the group is reduced to one
+// AND mask and OR value before any register is accessed, so each register is
+// accessed at most once no matter how the board table is ordered.
+//
+typedef struct {
+  UINT32             PadMask[GPIO_GROUP_DW_NUMBER];
+  UINT32             PadCfgDwReg[GPIO_GROUP_MAX_PADS][GPIO_PADCFG_DW_REG_NUMBER];
+  UINT32             PadCfgDwRegMask[GPIO_GROUP_MAX_PADS][GPIO_PADCFG_DW_REG_NUMBER];
+  GPIO_GROUP_DW_DATA GroupDwData[GPIO_GROUP_DW_NUMBER];
+} GPIO_GROUP_PLAN;
+
 /**
-  This internal procedure will scan GPIO initialization table and unlock
-  all pads present in it
+  This internal procedure will collect all entries of GPIO initialization table
+  which belong to one group and reduce them to a GPIO_GROUP_PLAN.
+  No GPIO register is accessed.
 
-  @param[in] NumberOfItem               Number of GPIO pad records in table
-  @param[in] GpioInitTableAddress       GPIO initialization table
-  @param[in] Index                      Index of GPIO Initialization table record
+  @param[in]  NumberOfItems             Number of GPIO pad records in table
+  @param[in]  GpioInitTableAddress      GPIO initialization table
+  @param[in]  GroupIndex                Index of the group to compile
+  @param[out] Plan                      Register values for the group
 
   @retval EFI_SUCCESS                   The function completed successfully
+  @retval EFI_NOT_FOUND                 No pad of the group is in the table
   @retval EFI_INVALID_PARAMETER         Invalid group or pad number
 **/
 STATIC
 EFI_STATUS
-GpioUnlockPadsForAGroup (
-  IN UINT32                    NumberOfItems,
-  IN GPIO_INIT_CONFIG          *GpioInitTableAddress,
-  IN UINT32                    Index
+GpioCompileGroupPlan (
+  IN  UINT32                    NumberOfItems,
+  IN  GPIO_INIT_CONFIG          *GpioInitTableAddress,
+  IN  UINT32                    GroupIndex,
+  OUT GPIO_GROUP_PLAN           *Plan
   )
 {
-  UINT32                 PadsToUnlock[GPIO_GROUP_DW_NUMBER];
-  UINT32                 DwNum;
-  UINT32                 PadBitPosition;
+  UINT32                 Index;
+  UINT32                 DwIndex;
+  UINT32                 PadCfgDwReg[GPIO_PADCFG_DW_REG_NUMBER];
+  UINT32                 PadCfgDwRegMask[GPIO_PADCFG_DW_REG_NUMBER];
   CONST GPIO_GROUP_INFO  *GpioGroupInfo;
   UINT32                 GpioGroupInfoLength;
   CONST GPIO_INIT_CONFIG *GpioData;
-  GPIO_GROUP             Group;
-  UINT32                 GroupIndex;
   UINT32                 PadNumber;
+  BOOLEAN                PadFound;
 
   GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
 
-  GpioData   = &GpioInitTableAddress[Index];
-  Group      = GpioGetGroupFromGpioPad (GpioData->GpioPad);
-  GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
+  ZeroMem (Plan, sizeof (GPIO_GROUP_PLAN));
+  PadFound = FALSE;
 
-  ZeroMem (PadsToUnlock, sizeof (PadsToUnlock));
-  //
-  // Loop through pads for one group. If pad belongs to a different group then
-  // break and move to register programming.
-  //
-  while (Index < NumberOfItems) {
-
-    GpioData   = &GpioInitTableAddress[Index];
-    if (GroupIndex != GpioGetGroupIndexFromGpioPad (GpioData->GpioPad)) {
-      //if next pad is from different group then break loop
-      break;
+  for (Index = 0; Index < NumberOfItems; Index++) {
+    GpioData = &GpioInitTableAddress[Index];
+    if (GpioGetGroupIndexFromGpioPad (GpioData->GpioPad) != GroupIndex) {
+      continue;
     }
 
-    PadNumber  = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
+    PadNumber = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
     //
     // Check if legal pin number
     //
-    if (PadNumber >= GpioGroupInfo[GroupIndex].PadPerGroup) {
+    if ((PadNumber >= GpioGroupInfo[GroupIndex].PadPerGroup) || (PadNumber >= GPIO_GROUP_MAX_PADS)) {
       DEBUG ((DEBUG_ERROR, "GPIO ERROR: Pin number (%d) exceeds possible range for group %d\n", PadNumber, GroupIndex));
       return EFI_INVALID_PARAMETER;
     }
 
-    PadBitPosition = GPIO_GET_PAD_POSITION (PadNumber);
-    DwNum = GPIO_GET_DW_NUM (PadNumber);
-
-    if (DwNum >= GPIO_GROUP_DW_NUMBER) {
+    DEBUG_CODE_BEGIN ();
+    //
+    // Check if Pad enabled for SCI is to be in unlocked state
+    //
+    if (((GpioData->GpioConfig.InterruptConfig & GpioIntSci) == GpioIntSci) &&
+        ((GpioData->GpioConfig.LockConfig & B_GPIO_LOCK_CONFIG_PAD_CONF_LOCK_MASK) != GpioPadConfigUnlock)){
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: %a used for SCI is not unlocked!\n", GpioName (GpioData->GpioPad)));
       ASSERT (FALSE);
-      return EFI_UNSUPPORTED;
+      return EFI_INVALID_PARAMETER;
     }
+    DEBUG_CODE_END ();
+
+    ZeroMem (PadCfgDwReg, sizeof (PadCfgDwReg));
+    ZeroMem (PadCfgDwRegMask, sizeof (PadCfgDwRegMask));
     //
-    // Update pads which need to be unlocked
+    // Get GPIO PADCFG register value from GPIO config data
     //
-    PadsToUnlock[DwNum] |= 0x1 << PadBitPosition;
-
-    //Move to next item
-    Index++;
-  }
+    GpioPadCfgRegValueFromGpioConfig (
+      GpioData->GpioPad,
+      &GpioData->GpioConfig,
+      PadCfgDwReg,
+      PadCfgDwRegMask
+      );
 
-  for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
     //
-    // Unlock pads
+    // Later entries for the same pad override the fields they set
     //
-    if (PadsToUnlock[DwNum] != 0) {
-      GpioUnlockPadCfgForGroupDw (Group, DwNum, PadsToUnlock[DwNum]);
-      GpioUnlockPadCfgTxForGroupDw (Group, DwNum, PadsToUnlock[DwNum]);
+    for (DwIndex = 0; DwIndex < GPIO_PADCFG_DW_PROGRAMMED; DwIndex++) {
+      Plan->PadCfgDwReg[PadNumber][DwIndex] &= ~PadCfgDwRegMask[DwIndex];
+      Plan->PadCfgDwReg[PadNumber][DwIndex] |= PadCfgDwReg[DwIndex];
+      Plan->PadCfgDwRegMask[PadNumber][DwIndex] |= PadCfgDwRegMask[DwIndex];
     }
+
+    //
+    // Get GPIO DW register values from GPIO config data
+    //
+    GpioDwRegValueFromGpioConfig (
+      PadNumber,
+      &GpioData->GpioConfig,
+      Plan->GroupDwData
+      );
+
+    Plan->PadMask[GPIO_GET_DW_NUM (PadNumber)] |= 0x1 << GPIO_GET_PAD_POSITION (PadNumber);
+    PadFound = TRUE;
   }
 
-  return EFI_SUCCESS;
+  return PadFound ? EFI_SUCCESS : EFI_NOT_FOUND;
 }
 
 /**
-  This procedure will initialize multiple PCH GPIO pins
+  This internal procedure will write one register of a GPIO community.
+  Nothing is done if no bit is to be changed and the register is not read
+  if all bits are to be changed.
+
+  @param[in] GpioCom                    GPIO community
+  @param[in] RegOffset                  Register offset
+  @param[in] RegMask                    Bits to be changed
+  @param[in] RegValue                   Value of bits to be changed
+**/
+STATIC
+VOID
+GpioPlanWrite (
+  IN PCH_SBI_PID               GpioCom,
+  IN UINT32                    RegOffset,
+  IN UINT32                    RegMask,
+  IN UINT32                    RegValue
+  )
+{
+  if (RegMask == 0) {
+    return;
+  }
 
-  @param[in] NumberofItem               Number of GPIO pads to be updated
-  @param[in] GpioInitTableAddress       GPIO initialization table
+  if (RegMask == MAX_UINT32) {
+    MmioWrite32 (PCH_PCR_ADDRESS (GpioCom, RegOffset), RegValue);
+  } else {
+    MmioAndThenOr32 (PCH_PCR_ADDRESS (GpioCom, RegOffset), ~RegMask, RegValue);
+  }
+}
 
-  @retval EFI_SUCCESS                   The function completed successfully
-  @retval EFI_INVALID_PARAMETER         Invalid group or pad number
+/**
+  This internal procedure will program GPIO registers of one group
+  from a GPIO_GROUP_PLAN.
+
+  @param[in]     Group                  GPIO group
+  @param[in]     GroupIndex             Index of the group
+  @param[in out] Plan                   Register values for the group
 **/
 STATIC
-EFI_STATUS
-GpioConfigurePch (
-  IN UINT32                    NumberOfItems,
-  IN GPIO_INIT_CONFIG          *GpioInitTableAddress
+VOID
+GpioApplyGroupPlan (
+  IN     GPIO_GROUP            Group,
+  IN     UINT32                GroupIndex,
+  IN OUT GPIO_GROUP_PLAN       *Plan
   )
 {
-  UINT32                 Index;
-  UINT32                 PadCfgDwReg[GPIO_PADCFG_DW_REG_NUMBER];
-  UINT32                 PadCfgDwRegMask[GPIO_PADCFG_DW_REG_NUMBER];
-  UINT32                 PadCfgReg;
-  GPIO_GROUP_DW_DATA     GroupDwData[GPIO_GROUP_DW_NUMBER];
-  UINT32                 DwNum;
   CONST GPIO_GROUP_INFO  *GpioGroupInfo;
   UINT32                 GpioGroupInfoLength;
-  GPIO_PAD_OWN           PadOwnVal;
-  CONST GPIO_INIT_CONFIG *GpioData;
-  UINT32                 GroupIndex;
-  UINT32                 PadNumber;
   PCH_SBI_PID            GpioCom;
-
-  PadOwnVal = GpioPadOwnHost;
+  GPIO_GROUP_DW_DATA     *GroupDwData;
+  UINT32                 DwNum;
+  UINT32                 DwIndex;
+  UINT32                 PadMask;
+  UINT32                 PadBitPosition;
+  UINT32                 PadNumber;
+  UINT32                 PadCfgReg;
+  UINT32                 LockedPads;
 
   GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
+  GpioCom       = GpioGroupInfo[GroupIndex].Community;
 
-  Index = 0;
-  while (Index < NumberOfItems) {
+  for (DwNum = 0; (DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup)) && (DwNum < GPIO_GROUP_DW_NUMBER); DwNum++) {
+    PadMask = Plan->PadMask[DwNum];
+    if (PadMask == 0) {
+      continue;
+    }
+    GroupDwData = &Plan->GroupDwData[DwNum];
 
-    GpioData   = &GpioInitTableAddress[Index];
-    GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
-    GpioCom    = GpioGroupInfo[GroupIndex].Community;
+    DEBUG_CODE_BEGIN ();
+    UINT32                 PadOwnRegValue;
 
-    DEBUG_CODE_BEGIN();
-    if (!GpioIsCorrectPadForThisChipset (GpioData->GpioPad)) {
-      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Incorrect GpioPad (0x%08x) used on this chipset!\n", GpioData->GpioPad));
-      ASSERT (FALSE);
-      return EFI_UNSUPPORTED;
+    //
+    // Check if selected GPIO Pads are not owned by CSME/ISH.
+    // One PAD_OWN register contains information for 8 pads.
+    //
+    PadOwnRegValue = 0;
+    for (PadBitPosition = 0; PadBitPosition < 32; PadBitPosition++) {
+      if ((PadBitPosition % 8) == 0) {
+        if (((PadMask >> PadBitPosition) & 0xFF) == 0) {
+          PadBitPosition += 7;
+          continue;
+        }
+        PadOwnRegValue = MmioRead32 (
+                           PCH_PCR_ADDRESS (
+                             GpioCom,
+                             GpioGroupInfo[GroupIndex].PadOwnOffset + ((DwNum * 32 + PadBitPosition) >> 3) * 0x4
+                             )
+                           );
+      }
+      if ((PadMask & (0x1 << PadBitPosition)) == 0) {
+        continue;
+      }
+      if (((PadOwnRegValue >> ((PadBitPosition % 8) * 4)) & (BIT1 | BIT0)) != GpioPadOwnHost) {
+        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Accessing pad not owned by host (Group=%d, Pad=%d)!\n", GroupIndex, DwNum * 32 + PadBitPosition));
+        DEBUG ((DEBUG_ERROR, "** Please make sure the GPIO usage in sync between CSME and BIOS configuration. \n"));
+        DEBUG ((DEBUG_ERROR, "** All the GPIO occupied by CSME should not do any configuration by BIOS.\n"));
+        PadMask &= ~(0x1 << PadBitPosition);
+      }
     }
+    //
+    // Pads which are skipped must not be touched in group registers either
+    //
+    GroupDwData->HostSoftOwnReg     &= PadMask;
+    GroupDwData->HostSoftOwnRegMask &= PadMask;
+    GroupDwData->GpiGpeEnReg        &= PadMask;
+    GroupDwData->GpiGpeEnRegMask    &= PadMask;
+    GroupDwData->GpiNmiEnReg        &= PadMask;
+    GroupDwData->GpiNmiEnRegMask    &= PadMask;
+    GroupDwData->GpiSmiEnReg        &= PadMask;
+    GroupDwData->GpiSmiEnRegMask    &= PadMask;
+    GroupDwData->ConfigUnlockMask   &= PadMask;
+    GroupDwData->OutputUnlockMask   &= PadMask;
     DEBUG_CODE_END ();
 
+    if (PadMask == 0) {
+      continue;
+    }
+
     //
-    // Unlock pads for a given group which are going to be reconfigured
-    //
+    // Unlock pads which are going to be reconfigured.
     //
     // Because PADCFGLOCK/LOCKTX register reset domain is Powergood, lock settings
     // will get back to default only after G3 or DeepSx transition. On the other hand GpioPads
     // configuration is controlled by a configurable type of reset - PadRstCfg. This means that if
     // PadRstCfg != Powergood GpioPad will have its configuration locked despite it being not the
-    // one desired by BIOS. Before reconfiguring all pads they will get unlocked.
+    // one desired by BIOS. Lock state is read once for the whole DW and only pads which are
+    // really locked are unlocked over sideband.
     //
-    GpioUnlockPadsForAGroup (NumberOfItems, GpioInitTableAddress, Index);
+    if (EFI_ERROR (GpioGetPadCfgLockForGroupDw (Group, DwNum, &LockedPads))) {
+      LockedPads = PadMask;
+    }
+    if ((LockedPads & PadMask) != 0) {
+      GpioUnlockPadCfgForGroupDw (Group, DwNum, LockedPads & PadMask);
+    }
+    if (EFI_ERROR (GpioGetPadCfgLockTxForGroupDw (Group, DwNum, &LockedPads))) {
+      LockedPads = PadMask;
+    }
+    if ((LockedPads & PadMask) != 0) {
+      GpioUnlockPadCfgTxForGroupDw (Group, DwNum, LockedPads & PadMask);
+    }
 
-    ZeroMem (GroupDwData, sizeof (GroupDwData));
     //
-    // Loop through pads for one group. If pad belongs to a different group then
-    // break and move to register programming.
+    // Write PADCFG DW registers
     //
-    while (Index < NumberOfItems) {
-
-      GpioData   = &GpioInitTableAddress[Index];
-      if (GroupIndex != GpioGetGroupIndexFromGpioPad (GpioData->GpioPad)) {
-        //if next pad is from different group then break loop
-        break;
-      }
-
-      PadNumber  = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
-
-      DEBUG_CODE_BEGIN ();
-      //
-      // Check if legal pin number
-      //
-      if (PadNumber >= GpioGroupInfo[GroupIndex].PadPerGroup) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Pin number (%d) exceeds possible range for group %d\n", PadNumber, GroupIndex));
-        return EFI_INVALID_PARAMETER;
-      }
-
-      //
-      // Check if selected GPIO Pad is not owned by CSME/ISH
-      //
-      GpioGetPadOwnership (GpioData->GpioPad, &PadOwnVal);
-
-      if (PadOwnVal != GpioPadOwnHost) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Accessing pad not owned by host (Group=%d, Pad=%d)!\n", GroupIndex, PadNumber));
-        DEBUG ((DEBUG_ERROR, "** Please make sure the GPIO usage in sync between CSME and BIOS configuration. \n"));
-        DEBUG ((DEBUG_ERROR, "** All the GPIO occupied by CSME should not do any configuration by BIOS.\n"));
-        //Move to next item
-        Index++;
+    for (PadBitPosition = 0; PadBitPosition < 32; PadBitPosition++) {
+      if ((PadMask & (0x1 << PadBitPosition)) == 0) {
         continue;
       }
-
-      //
-      // Check if Pad enabled for SCI is to be in unlocked state
-      //
-      if (((GpioData->GpioConfig.InterruptConfig & GpioIntSci) == GpioIntSci) &&
-          ((GpioData->GpioConfig.LockConfig & B_GPIO_LOCK_CONFIG_PAD_CONF_LOCK_MASK) != GpioPadConfigUnlock)){
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: %a used for SCI is not unlocked!\n", GpioName (GpioData->GpioPad)));
-        ASSERT (FALSE);
-        return EFI_INVALID_PARAMETER;
-      }
-      DEBUG_CODE_END ();
-
-      ZeroMem (PadCfgDwReg, sizeof (PadCfgDwReg));
-      ZeroMem (PadCfgDwRegMask, sizeof (PadCfgDwRegMask));
-      //
-      // Get GPIO PADCFG register value from GPIO config data
-      //
-      GpioPadCfgRegValueFromGpioConfig (
-        GpioData->GpioPad,
-        &GpioData->GpioConfig,
-        PadCfgDwReg,
-        PadCfgDwRegMask
-        );
-
+      PadNumber = DwNum * 32 + PadBitPosition;
       //
       // Create PADCFG register offset using group and pad number
       //
       PadCfgReg = S_GPIO_PCR_PADCFG * PadNumber + GpioGroupInfo[GroupIndex].PadCfgOffset;
+      for (DwIndex = 0; DwIndex < GPIO_PADCFG_DW_PROGRAMMED; DwIndex++) {
+        GpioPlanWrite (
+          GpioCom,
+          PadCfgReg + DwIndex * 0x4,
+          Plan->PadCfgDwRegMask[PadNumber][DwIndex],
+          Plan->PadCfgDwReg[PadNumber][DwIndex]
+          );
+      }
+    }
 
-      //
-      // Write PADCFG DW0 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg),
-        ~PadCfgDwRegMask[0],
-        PadCfgDwReg[0]
+    //
+    // Write HOSTSW_OWN registers
+    //
+    if (GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) {
+      GpioPlanWrite (
+        GpioCom,
+        GpioGroupInfo[GroupIndex].HostOwnOffset + DwNum * 0x4,
+        GroupDwData->HostSoftOwnRegMask,
+        GroupDwData->HostSoftOwnReg
         );
-      //
-      // Write PADCFG DW1 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x4),
-        ~PadCfgDwRegMask[1],
-        PadCfgDwReg[1]
+    }
+
+    //
+    // Write GPI_GPE_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      GpioPlanWrite (
+        GpioCom,
+        GpioGroupInfo[GroupIndex].GpiGpeEnOffset + DwNum * 0x4,
+        GroupDwData->GpiGpeEnRegMask,
+        GroupDwData->GpiGpeEnReg
         );
+    }
 
-      //
-      // Write PADCFG DW2 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x8),
-        ~PadCfgDwRegMask[2],
-        PadCfgDwReg[2]
+    //
+    // Write GPI_NMI_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].NmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      GpioPlanWrite (
+        GpioCom,
+        GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4,
+        GroupDwData->GpiNmiEnRegMask,
+        GroupDwData->GpiNmiEnReg
         );
+    } else if (GroupDwData->GpiNmiEnReg != 0x0) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting NMI\n", GroupIndex));
+      ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
+    }
 
-      //
-      // Get GPIO DW register values from GPIO config data
-      //
-      GpioDwRegValueFromGpioConfig (
-        PadNumber,
-        &GpioData->GpioConfig,
-        GroupDwData
+    //
+    // Write GPI_SMI_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].SmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      GpioPlanWrite (
+        GpioCom,
+        GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4,
+        GroupDwData->GpiSmiEnRegMask,
+        GroupDwData->GpiSmiEnReg
         );
+    } else if (GroupDwData->GpiSmiEnReg != 0x0) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting SMI\n", GroupIndex));
+      ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
+    }
 
-      //Move to next item
-      Index++;
+    //
+    // Update Pad Configuration unlock data
+    //
+    if (GroupDwData->ConfigUnlockMask) {
+      GpioStoreGroupDwUnlockPadConfigData (GroupIndex, DwNum, GroupDwData->ConfigUnlockMask);
     }
 
-    for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
-      //
-      // Write HOSTSW_OWN registers
-      //
-      if (GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].HostOwnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].HostSoftOwnRegMask,
-          GroupDwData[DwNum].HostSoftOwnReg
-          );
-      }
+    //
+    // Update Pad Output unlock data
+    //
+    if (GroupDwData->OutputUnlockMask) {
+      GpioStoreGroupDwUnlockOutputData (GroupIndex, DwNum, GroupDwData->OutputUnlockMask);
+    }
+  }
+}
 
-      //
-      // Write GPI_GPE_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].GpiGpeEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiGpeEnRegMask,
-          GroupDwData[DwNum].GpiGpeEnReg
-          );
-      }
+/**
+  This procedure will initialize multiple PCH GPIO pins
 
-      //
-      // Write GPI_NMI_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].NmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiNmiEnRegMask,
-          GroupDwData[DwNum].GpiNmiEnReg
-          );
-      } else if (GroupDwData[DwNum].GpiNmiEnReg != 0x0) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting NMI\n", GroupIndex));
-        ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
-      }
+  The table is compiled group by group into a GPIO_GROUP_PLAN, so all pads
+  of a group are programmed together regardless of their order in the table.
 
-      //
-      // Write GPI_SMI_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].SmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiSmiEnRegMask,
-          GroupDwData[DwNum].GpiSmiEnReg
-          );
-      } else if (GroupDwData[DwNum].GpiSmiEnReg != 0x0) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting SMI\n", GroupIndex));
-        ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
-      }
+  @param[in] NumberofItem               Number of GPIO pads to be updated
+  @param[in] GpioInitTableAddress       GPIO initialization table
 
-      //
-      // Update Pad Configuration unlock data
-      //
-      if (GroupDwData[DwNum].ConfigUnlockMask) {
-        GpioStoreGroupDwUnlockPadConfigData (GroupIndex, DwNum, GroupDwData[DwNum].ConfigUnlockMask);
-      }
+  @retval EFI_SUCCESS                   The function completed successfully
+  @retval EFI_INVALID_PARAMETER         Invalid group or pad number
+**/
+STATIC
+EFI_STATUS
+GpioConfigurePch (
+  IN UINT32                    NumberOfItems,
+  IN GPIO_INIT_CONFIG          *GpioInitTableAddress
+  )
+{
+  EFI_STATUS             Status;
+  GPIO_GROUP_PLAN        Plan;
+  GPIO_GROUP             Group;
+  GPIO_GROUP             GpioGroupLowest;
+  GPIO_GROUP             GpioGroupHighest;
+  UINT32                 GroupIndex;
 
-      //
-      // Update Pad Output unlock data
-      //
-      if (GroupDwData[DwNum].OutputUnlockMask) {
-        GpioStoreGroupDwUnlockOutputData (GroupIndex, DwNum, GroupDwData[DwNum].OutputUnlockMask);
-      }
+  DEBUG_CODE_BEGIN ();
+  UINT32                 Index;
+
+  for (Index = 0; Index < NumberOfItems; Index++) {
+    if (!GpioIsCorrectPadForThisChipset (GpioInitTableAddress[Index].GpioPad)) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Incorrect GpioPad (0x%08x) used on this chipset!\n", GpioInitTableAddress[Index].GpioPad));
+      ASSERT (FALSE);
+      return EFI_UNSUPPORTED;
+    }
+  }
+  DEBUG_CODE_END ();
+
+  GpioGroupLowest  = GpioGetLowestGroup ();
+  GpioGroupHighest = GpioGetHighestGroup ();
+
+  for (Group = GpioGroupLowest; Group <= GpioGroupHighest; Group++) {
+    GroupIndex = GpioGetGroupIndexFromGroup (Group);
+
+    Status = GpioCompileGroupPlan (NumberOfItems, GpioInitTableAddress, GroupIndex, &Plan);
+    if (Status == EFI_NOT_FOUND) {
+      continue;
+    }
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
+
+    GpioApplyGroupPlan (Group, GroupIndex, &Plan);
   }
 
   return EFI_SUCCESS;
@@ -529,8 +623,8 @@ GpioClearAllGpioInterrupts (
   Pad not configured using GPIO_INIT_CONFIG will be left with hardware default values.
   Separate fields could be set to hardware default if it does not matter, except
   GpioPad and PadMode.
-  Function will work in most efficient way if pads which belong to the same group are
-  placed in adjacent records of the table.
+  Pads are programmed group by group, so records in the table do not need to be
+  sorted by group.
   Although function can enable pads for Native mode, such programming is done
   by reference code when enabling related silicon feature.
 
@@ -28,6 +28,7 @@
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/PerformanceLib.h>
 #include <Protocol/SmmReadyToLock.h>
+#include <Guid/SmiLatencyProfile.h>
 #include <IndustryStandard/Pci30.h>
 #include <Library/PchCycleDecodingLib.h>
 #include <Library/PchPcieRpLib.h>
@@ -424,6 +425,7 @@ VOID
 struct _DATABASE_RECORD {
   UINT32                        Signature;
   LIST_ENTRY                    Link;
+  LIST_ENTRY                    SmiStsLink;
   BOOLEAN                       Processed;
   ///
   /// Status and Enable bit description
@@ -465,9 +467,14 @@ struct _DATABASE_RECORD {
   /// Indicate the PCH SMI types.
   ///
   PCH_SMI_TYPES                 PchSmiType;
+  ///
+  /// Time spent in the callback of this child
+  ///
+  SMI_LATENCY_STATISTICS        Latency;
 };
 
 #define DATABASE_RECORD_FROM_LINK(_record)  CR (_record, DATABASE_RECORD, Link, DATABASE_RECORD_SIGNATURE)
+#define DATABASE_RECORD_FROM_SMI_STS_LINK(_record)  CR (_record, DATABASE_RECORD, SmiStsLink, DATABASE_RECORD_SIGNATURE)
 #define DATABASE_RECORD_FROM_CHILDCONTEXT(_record)  CR (_record, DATABASE_RECORD, ChildContext, DATABASE_RECORD_SIGNATURE)
 
 ///
@@ -593,6 +600,11 @@ typedef struct {
   PROTOCOL_SIGNATURE \
   )
 
+///
+/// Number of SMI_STS bits used to index the callback database
+///
+#define PCH_SMI_STS_BUCKET_MAX  32
+
 ///
 /// Create private data for the protocols that we'll publish
 ///
@@ -601,6 +613,14 @@ typedef struct {
   EFI_HANDLE                  SmiHandle;
   EFI_HANDLE                  InstallMultProtHandle;
   PCH_SMM_QUALIFIED_PROTOCOL  Protocols[PCH_SMM_PROTOCOL_TYPE_MAX];
+  ///
+  /// Records indexed by their top level SMI_STS bit, so the dispatcher only
+  /// scans the children whose status bit is set. Records whose top level
+  /// status is not reported in SMI_STS are kept in OtherSources.
+  ///
+  LIST_ENTRY                  SmiStsBucket[PCH_SMI_STS_BUCKET_MAX];
+  LIST_ENTRY                  OtherSources;
+  UINT32                      SmiStsBucketMask;
 } PRIVATE_DATA;
 
 extern PRIVATE_DATA           mPrivateData;
@@ -623,6 +643,27 @@ SmmCoreInsertRecord (
   OUT EFI_HANDLE                        *DispatchHandle
   );
 
+/**
+  Add a database record to the SMI_STS bucket it is dispatched from.
+  The record must already be in the callback database.
+
+  @param[in] Record                     Record to index.
+**/
+VOID
+SmmCoreIndexRecord (
+  IN  DATABASE_RECORD                   *Record
+  );
+
+/**
+  Remove a database record from its SMI_STS bucket.
+
+  @param[in] Record                     Record to remove from the index.
+**/
+VOID
+SmmCoreUnindexRecord (
+  IN  DATABASE_RECORD                   *Record
+  );
+
 /**
   Get the Sleep type
 
@@ -831,6 +872,71 @@ InstallPchSmmPeriodicTimerControlProtocol (
   IN EFI_HANDLE                         Handle
   );
 
+extern SMI_LATENCY_STATISTICS  mDispatcherLatency;
+
+/**
+  Account one latency sample.
+
+  @param[in, out] Statistics            Statistics to update
+  @param[in]      Cycles                Duration of the sample in TSC cycles
+**/
+VOID
+PchSmmLatencyRecord (
+  IN OUT SMI_LATENCY_STATISTICS         *Statistics,
+  IN     UINT64                         Cycles
+  );
+
+/**
+  Start timing a child callback.
+
+  @param[in] Record                     Database record of the child
+
+  @return The TSC value at the start of the callback
+**/
+UINT64
+PchSmmLatencyChildStart (
+  IN DATABASE_RECORD                    *Record
+  );
+
+/**
+  Account one latency sample of a child callback.
+
+  @param[in] Record                     Database record of the child, possibly freed
+  @param[in] Cycles                     Duration of the callback in TSC cycles
+**/
+VOID
+PchSmmLatencyRecordChild (
+  IN DATABASE_RECORD                    *Record,
+  IN UINT64                             Cycles
+  );
+
+/**
+  Stop timing a child whose record is being freed.
+
+  @param[in] Record                     Database record being unregistered
+**/
+VOID
+PchSmmLatencyForgetChild (
+  IN DATABASE_RECORD                    *Record
+  );
+
+/**
+  Register the MM communicate handler exporting the SMI latency statistics.
+**/
+VOID
+InstallSmiLatencyProfile (
+  VOID
+  );
+
+/**
+  Log the statistics collected during boot. The MM communicate handler stays
+  registered so that the statistics of runtime SMIs can still be read.
+**/
+VOID
+DumpSmiLatencyProfile (
+  VOID
+  );
+
 /**
   When we get an SMI that indicates that we are transitioning to a sleep state,
   we need to actually transition to that state.  We do this by disabling the
@@ -165,6 +165,7 @@ SmmReadyToLockCallback (
   )
 {
   mReadyToLock = TRUE;
+  DumpSmiLatencyProfile ();
 
   return EFI_SUCCESS;
 }
@@ -219,6 +220,7 @@ InitializePchSmmDispatcher (
 {
   EFI_STATUS           Status;
   VOID                 *SmmReadyToLockRegistration;
+  UINTN                Index;
 
   mS3SusStart = FALSE;
   //
@@ -244,6 +246,11 @@ InitializePchSmmDispatcher (
   // Initialize Callback DataBase
   //
   InitializeListHead (&mPrivateData.CallbackDataBase);
+  for (Index = 0; Index < PCH_SMI_STS_BUCKET_MAX; Index++) {
+    InitializeListHead (&mPrivateData.SmiStsBucket[Index]);
+  }
+  InitializeListHead (&mPrivateData.OtherSources);
+  mPrivateData.SmiStsBucketMask = 0;
 
   //
   // Enable SMIs on the PCH now that we have a callback
@@ -259,6 +266,7 @@ InitializePchSmmDispatcher (
   InstallIoTrap (ImageHandle);
   InstallEspiSmi (ImageHandle);
   InstallPchSmmPeriodicTimerControlProtocol (mPrivateData.InstallMultProtHandle);
+  InstallSmiLatencyProfile ();
 
   //
   // Register EFI_SMM_READY_TO_LOCK_PROTOCOL_GUID notify function.
@@ -273,6 +281,68 @@ InitializePchSmmDispatcher (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the SMI_STS bucket a database record is dispatched from.
+
+  @param[in] Record                     Database record
+
+  @retval                               List head of the bucket
+**/
+STATIC
+LIST_ENTRY *
+SmmCoreGetBucket (
+  IN  DATABASE_RECORD                   *Record
+  )
+{
+  if (!IS_BIT_DESC_NULL (Record->SrcDesc.PmcSmiSts) &&
+      (Record->SrcDesc.PmcSmiSts.Reg.Type == ACPI_ADDR_TYPE) &&
+      (Record->SrcDesc.PmcSmiSts.Reg.Data.acpi == R_ACPI_IO_SMI_STS) &&
+      (Record->SrcDesc.PmcSmiSts.Bit < PCH_SMI_STS_BUCKET_MAX))
+  {
+    return &mPrivateData.SmiStsBucket[Record->SrcDesc.PmcSmiSts.Bit];
+  }
+  return &mPrivateData.OtherSources;
+}
+
+/**
+  Add a database record to the SMI_STS bucket it is dispatched from.
+  The record must already be in the callback database.
+
+  @param[in] Record                     Record to index.
+**/
+VOID
+SmmCoreIndexRecord (
+  IN  DATABASE_RECORD                   *Record
+  )
+{
+  LIST_ENTRY                            *Bucket;
+
+  Bucket = SmmCoreGetBucket (Record);
+  InsertTailList (Bucket, &Record->SmiStsLink);
+  if (Bucket != &mPrivateData.OtherSources) {
+    mPrivateData.SmiStsBucketMask |= (1u << Record->SrcDesc.PmcSmiSts.Bit);
+  }
+}
+
+/**
+  Remove a database record from its SMI_STS bucket.
+
+  @param[in] Record                     Record to remove from the index.
+**/
+VOID
+SmmCoreUnindexRecord (
+  IN  DATABASE_RECORD                   *Record
+  )
+{
+  LIST_ENTRY                            *Bucket;
+
+  Bucket = SmmCoreGetBucket (Record);
+  RemoveEntryList (&Record->SmiStsLink);
+  if ((Bucket != &mPrivateData.OtherSources) && IsListEmpty (Bucket)) {
+    mPrivateData.SmiStsBucketMask &= ~(1u << Record->SrcDesc.PmcSmiSts.Bit);
+  }
+}
+
 /**
   The internal function used to create and insert a database record
 
@@ -310,6 +380,7 @@ SmmCoreInsertRecord (
   // After ensuring the source of event is not null, we will insert the record into the database
   //
   InsertTailList (&mPrivateData.CallbackDataBase, &Record->Link);
+  SmmCoreIndexRecord (Record);
 
   //
   // Child's handle will be the address linked list link in the record
@@ -583,6 +654,8 @@ PchSmmCoreUnRegister (
   }
 
   RemoveEntryList (&RecordToDelete->Link);
+  SmmCoreUnindexRecord (RecordToDelete);
+  PchSmmLatencyForgetChild (RecordToDelete);
 
   //
   // Loop through all the souces in record linked list to see if any source enable is equal.
@@ -659,6 +732,176 @@ ClearPendingSmiStatus (
   }
 }
 
+/**
+  Dispatch the first active source found in one bucket of the SMI_STS index,
+  then clear that source.
+
+  Sources sharing an SMI_STS bit are registered in the same bucket, so every
+  child registered for the active source description is found in it.
+
+  @param[in]      Bucket                List head of the bucket to scan
+  @param[in]      SciEn                 Cached SCI enable state
+  @param[in]      SmiEnValue            Cached value of SMI_EN
+  @param[in]      SmiStsValue           Cached value of SMI_STS
+  @param[in, out] SxChildWasDispatched  Set to TRUE if a sleep source was dispatched
+**/
+STATIC
+VOID
+PchSmmDispatchBucket (
+  IN     LIST_ENTRY           *Bucket,
+  IN     BOOLEAN              SciEn,
+  IN     UINT32               SmiEnValue,
+  IN     UINT32               SmiStsValue,
+  IN OUT BOOLEAN              *SxChildWasDispatched
+  )
+{
+  BOOLEAN             ContextsMatch;
+
+  DATABASE_RECORD     *RecordInDb;
+  LIST_ENTRY          *LinkInDb;
+  DATABASE_RECORD     *RecordToExhaust;
+  LIST_ENTRY          *LinkToExhaust;
+
+  PCH_SMM_CONTEXT     Context;
+  VOID                *CommBuffer;
+  UINTN               CommBufferSize;
+  UINT64              CallbackStart;
+
+  PCH_SMM_SOURCE_DESC ActiveSource;
+
+  ContextsMatch = FALSE;
+
+  LinkInDb = GetFirstNode (Bucket);
+  while (!IsNull (Bucket, LinkInDb)) {
+    RecordInDb = DATABASE_RECORD_FROM_SMI_STS_LINK (LinkInDb);
+
+    //
+    // look for the first active source
+    //
+    if (SourceIsActive (&RecordInDb->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+      break;
+    }
+    LinkInDb = GetNextNode (Bucket, &RecordInDb->SmiStsLink);
+  }
+
+  if (IsNull (Bucket, LinkInDb)) {
+    return;
+  }
+
+  //
+  // We found a source. If this is a sleep type, we have to go to
+  // appropriate sleep state anyway.No matter there is sleep child or not
+  //
+  if (RecordInDb->ProtocolType == SxType) {
+    *SxChildWasDispatched = TRUE;
+  }
+  //
+  // "cache" the source description and don't query I/O anymore
+  //
+  CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
+  LinkToExhaust = LinkInDb;
+
+  //
+  // exhaust the rest of the bucket looking for the same source
+  //
+  while (!IsNull (Bucket, LinkToExhaust)) {
+    RecordToExhaust = DATABASE_RECORD_FROM_SMI_STS_LINK (LinkToExhaust);
+    //
+    // RecordToExhaust->Link might be removed (unregistered) by Callback function, and then the
+    // system will hang in ASSERT() while calling GetNextNode().
+    // To prevent the issue, we need to get next record in DB here (before Callback function).
+    //
+    LinkToExhaust = GetNextNode (Bucket, &RecordToExhaust->SmiStsLink);
+
+    if (CompareSources (&RecordToExhaust->SrcDesc, &ActiveSource)) {
+      //
+      // These source descriptions are equal, so this callback should be
+      // dispatched.
+      //
+      if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
+        //
+        // This child requires that we get a calling context from
+        // hardware and compare that context to the one supplied
+        // by the child.
+        //
+        ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
+
+        //
+        // Make sure contexts match before dispatching event to child
+        //
+        RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
+        ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
+
+      } else {
+        //
+        // This child doesn't require any more calling context beyond what
+        // it supplied in registration.  Simply pass back what it gave us.
+        //
+        Context       = RecordToExhaust->ChildContext;
+        ContextsMatch = TRUE;
+      }
+
+      if (ContextsMatch) {
+        if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
+          //
+          // For PCH SMI dispatch protocols
+          //
+          CallbackStart = PchSmmLatencyChildStart (RecordToExhaust);
+          PchSmiTypeCallbackDispatcher (RecordToExhaust);
+          PchSmmLatencyRecordChild (RecordToExhaust, AsmReadTsc () - CallbackStart);
+        } else {
+          if ((RecordToExhaust->ProtocolType == SxType) && (Context.Sx.Type == SxS3) && (Context.Sx.Phase == SxEntry) && !mS3SusStart) {
+            REPORT_STATUS_CODE (EFI_PROGRESS_CODE, PROGRESS_CODE_S3_SUSPEND_START);
+            mS3SusStart = TRUE;
+          }
+          //
+          // For EFI standard SMI dispatch protocols
+          //
+          if (RecordToExhaust->Callback != NULL) {
+            if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
+              //
+              // This callback function needs CommBuffer and CommBufferSize.
+              // Get those from child and then pass to callback function.
+              //
+              RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
+            } else {
+              //
+              // Child doesn't support the CommBuffer and CommBufferSize.
+              // Just pass NULL value to callback function.
+              //
+              CommBuffer     = NULL;
+              CommBufferSize = 0;
+            }
+
+            PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+            CallbackStart = PchSmmLatencyChildStart (RecordToExhaust);
+            RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
+            PchSmmLatencyRecordChild (RecordToExhaust, AsmReadTsc () - CallbackStart);
+            PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+            if (RecordToExhaust->ProtocolType == SxType) {
+              *SxChildWasDispatched = TRUE;
+            }
+          } else {
+            ASSERT (FALSE);
+          }
+        }
+      }
+    }
+  }
+
+  if (RecordInDb->ClearSource == NULL) {
+    //
+    // Clear the SMI associated w/ the source using the default function
+    //
+    PchSmmClearSource (&ActiveSource);
+  } else {
+    //
+    // This source requires special handling to clear
+    //
+    RecordInDb->ClearSource (&ActiveSource);
+  }
+}
+
 /**
   The callback function to handle subsequent SMIs.  This callback will be called by SmmCoreDispatcher.
 
@@ -683,35 +926,21 @@ PchSmmCoreDispatcher (
   //
   UINTN               EscapeCount;
 
-  BOOLEAN             ContextsMatch;
   BOOLEAN             EosSet;
   BOOLEAN             SxChildWasDispatched;
 
-  DATABASE_RECORD     *RecordInDb;
-  LIST_ENTRY          *LinkInDb;
-  DATABASE_RECORD     *RecordToExhaust;
-  LIST_ENTRY          *LinkToExhaust;
-
-  PCH_SMM_CONTEXT     Context;
-  VOID                *CommBuffer;
-  UINTN               CommBufferSize;
-
   EFI_STATUS          Status;
   BOOLEAN             SciEn;
   UINT32              SmiEnValue;
   UINT32              SmiStsValue;
+  UINT32              PendingBuckets;
+  UINTN               BucketIndex;
   UINT8               Port74Save;
   UINT8               Port76Save;
+  UINT64              DispatchStart;
 
-  PCH_SMM_SOURCE_DESC ActiveSource;
-
-  //
-  // Initialize ActiveSource
-  //
-  NullInitSourceDesc (&ActiveSource);
-
+  DispatchStart         = AsmReadTsc ();
   EscapeCount           = 3;
-  ContextsMatch         = FALSE;
   EosSet                = FALSE;
   SxChildWasDispatched  = FALSE;
   Status                = EFI_SUCCESS;
@@ -732,8 +961,6 @@ PchSmmCoreDispatcher (
     while ((!EosSet) && (EscapeCount > 0)) {
       EscapeCount--;
 
-      LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
-
       //
       // Cache SciEn, SmiEnValue and SmiStsValue to determine if source is active
       //
@@ -741,151 +968,26 @@ PchSmmCoreDispatcher (
       SmiEnValue  = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_EN));
       SmiStsValue = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_STS));
 
-      while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
-        RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
-
-        //
-        // look for the first active source
-        //
-        if (!SourceIsActive (&RecordInDb->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
-          //
-          // Didn't find the source yet, keep looking
-          //
-          LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, &RecordInDb->Link);
-
-          //
-          // if it's the last one, try to clear EOS
-          //
-          if (IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
-            //
-            // Clear pending SMI status before EOS
-            //
-            ClearPendingSmiStatus (SmiStsValue, SciEn);
-            EosSet = PchSmmSetAndCheckEos ();
-          }
-        } else {
-          //
-          // We found a source. If this is a sleep type, we have to go to
-          // appropriate sleep state anyway.No matter there is sleep child or not
-          //
-          if (RecordInDb->ProtocolType == SxType) {
-            SxChildWasDispatched = TRUE;
-          }
-          //
-          // "cache" the source description and don't query I/O anymore
-          //
-          CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
-          LinkToExhaust = LinkInDb;
-
-          //
-          // exhaust the rest of the queue looking for the same source
-          //
-          while (!IsNull (&mPrivateData.CallbackDataBase, LinkToExhaust)) {
-            RecordToExhaust = DATABASE_RECORD_FROM_LINK (LinkToExhaust);
-            //
-            // RecordToExhaust->Link might be removed (unregistered) by Callback function, and then the
-            // system will hang in ASSERT() while calling GetNextNode().
-            // To prevent the issue, we need to get next record in DB here (before Callback function).
-            //
-            LinkToExhaust = GetNextNode (&mPrivateData.CallbackDataBase, &RecordToExhaust->Link);
-
-            if (CompareSources (&RecordToExhaust->SrcDesc, &ActiveSource)) {
-              //
-              // These source descriptions are equal, so this callback should be
-              // dispatched.
-              //
-              if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
-                //
-                // This child requires that we get a calling context from
-                // hardware and compare that context to the one supplied
-                // by the child.
-                //
-                ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
-
-                //
-                // Make sure contexts match before dispatching event to child
-                //
-                RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
-                ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
-
-              } else {
-                //
-                // This child doesn't require any more calling context beyond what
-                // it supplied in registration.  Simply pass back what it gave us.
-                //
-                Context       = RecordToExhaust->ChildContext;
-                ContextsMatch = TRUE;
-              }
-
-              if (ContextsMatch) {
-                if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
-                  //
-                  // For PCH SMI dispatch protocols
-                  //
-                  PchSmiTypeCallbackDispatcher (RecordToExhaust);
-                } else {
-                  if ((RecordToExhaust->ProtocolType == SxType) && (Context.Sx.Type == SxS3) && (Context.Sx.Phase == SxEntry) && !mS3SusStart) {
-                    REPORT_STATUS_CODE (EFI_PROGRESS_CODE, PROGRESS_CODE_S3_SUSPEND_START);
-                    mS3SusStart = TRUE;
-                  }
-                  //
-                  // For EFI standard SMI dispatch protocols
-                  //
-                  if (RecordToExhaust->Callback != NULL) {
-                    if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
-                      //
-                      // This callback function needs CommBuffer and CommBufferSize.
-                      // Get those from child and then pass to callback function.
-                      //
-                      RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
-                    } else {
-                      //
-                      // Child doesn't support the CommBuffer and CommBufferSize.
-                      // Just pass NULL value to callback function.
-                      //
-                      CommBuffer     = NULL;
-                      CommBufferSize = 0;
-                    }
-
-                    PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
-                    PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    if (RecordToExhaust->ProtocolType == SxType) {
-                      SxChildWasDispatched = TRUE;
-                    }
-                  } else {
-                    ASSERT (FALSE);
-                  }
-                }
-              }
-            }
-          }
-
-          if (RecordInDb->ClearSource == NULL) {
-            //
-            // Clear the SMI associated w/ the source using the default function
-            //
-            PchSmmClearSource (&ActiveSource);
-          } else {
-            //
-            // This source requires special handling to clear
-            //
-            RecordInDb->ClearSource (&ActiveSource);
-          }
-          //
-          // Clear pending SMI status before EOS
-          //
-          ClearPendingSmiStatus (SmiStsValue, SciEn);
-          //
-          // Also, try to clear EOS
-          //
-          EosSet = PchSmmSetAndCheckEos ();
-          //
-          // Queue is empty, reset the search
-          //
-          break;
-        }
+      //
+      // Only scan the buckets whose SMI_STS bit is set, then the sources
+      // whose top level status is not reported in SMI_STS.
+      //
+      PendingBuckets = SmiStsValue & mPrivateData.SmiStsBucketMask;
+      while (PendingBuckets != 0) {
+        BucketIndex     = (UINTN) LowBitSet32 (PendingBuckets);
+        PendingBuckets &= ~(1u << BucketIndex);
+        PchSmmDispatchBucket (&mPrivateData.SmiStsBucket[BucketIndex], SciEn, SmiEnValue, SmiStsValue, &SxChildWasDispatched);
       }
+      PchSmmDispatchBucket (&mPrivateData.OtherSources, SciEn, SmiEnValue, SmiStsValue, &SxChildWasDispatched);
+
+      //
+      // Clear pending SMI status before EOS
+      //
+      ClearPendingSmiStatus (SmiStsValue, SciEn);
+      //
+      // Also, try to clear EOS
+      //
+      EosSet = PchSmmSetAndCheckEos ();
     }
   }
   //
@@ -922,5 +1024,7 @@ PchSmmCoreDispatcher (
   IoWrite8 (R_RTC_IO_EXT_INDEX_ALT, Port76Save);
   IoWrite8 (R_RTC_IO_INDEX_ALT, Port74Save);
 
+  PchSmmLatencyRecord (&mDispatcherLatency, AsmReadTsc () - DispatchStart);
+
   return Status;
 }
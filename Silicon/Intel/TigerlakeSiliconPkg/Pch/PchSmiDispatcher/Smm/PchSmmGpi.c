@@ -246,6 +246,7 @@ PchGpiSmiUnRegister (
 
 
   RemoveEntryList (&RecordToDelete->Link);
+  SmmCoreUnindexRecord (RecordToDelete);
   ZeroMem (RecordToDelete, sizeof (DATABASE_RECORD));
   Status = gSmst->SmmFreePool (RecordToDelete);
 
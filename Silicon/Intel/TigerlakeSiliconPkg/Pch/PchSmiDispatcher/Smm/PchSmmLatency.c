@@ -0,0 +1,493 @@
+/** @file
+  SMI latency instrumentation for the PCH SMM dispatcher.
+
+  The dispatcher times every SMI it handles and every child callback it
+  dispatches with the TSC. The cycle counts are accumulated in SMRAM as
+  log2 histograms and exported through an MM communicate buffer with
+  gSmiLatencyProfileGuid.
+
+  Everything is disabled unless PcdSmiLatencyProfileEnable is TRUE. The
+  communicate handler stays registered after SmmReadyToLock so that runtime
+  SMIs can be profiled from the shell; it validates every buffer it is given
+  and children are identified by the file GUID of their driver rather than
+  SMRAM addresses.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include "PchSmm.h"
+#include <Library/PcdLib.h>
+#include <Library/SmmMemLib.h>
+
+GLOBAL_REMOVE_IF_UNREFERENCED SMI_LATENCY_STATISTICS  mDispatcherLatency;
+GLOBAL_REMOVE_IF_UNREFERENCED EFI_HANDLE              mLatencyProfileHandle;
+
+//
+// Record of the child callback being timed, cleared if the callback
+// unregisters its own child and frees the record.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED DATABASE_RECORD         *mLatencyChild;
+
+//
+// Snapshot of the latency database taken by the GET_INFO command, so that
+// the chunks read by GET_DATA_BY_OFFSET are consistent with each other.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8                   *mLatencySnapshot;
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN                   mLatencySnapshotSize;
+
+/**
+  Account one latency sample.
+
+  @param[in, out] Statistics            Statistics to update
+  @param[in]      Cycles                Duration of the sample in TSC cycles
+**/
+VOID
+PchSmmLatencyRecord (
+  IN OUT SMI_LATENCY_STATISTICS         *Statistics,
+  IN     UINT64                         Cycles
+  )
+{
+  UINTN                                 Bucket;
+
+  if (!FeaturePcdGet (PcdSmiLatencyProfileEnable)) {
+    return;
+  }
+
+  Bucket = 0;
+  if (Cycles != 0) {
+    Bucket = (UINTN) HighBitSet64 (Cycles);
+    if (Bucket >= SMI_LATENCY_HISTOGRAM_BUCKETS) {
+      Bucket = SMI_LATENCY_HISTOGRAM_BUCKETS - 1;
+    }
+  }
+
+  Statistics->Count++;
+  Statistics->TotalCycles += Cycles;
+  if (Cycles > Statistics->MaxCycles) {
+    Statistics->MaxCycles = Cycles;
+  }
+  Statistics->Histogram[Bucket]++;
+}
+
+/**
+  Start timing a child callback.
+
+  @param[in] Record                     Database record of the child
+
+  @return The TSC value at the start of the callback
+**/
+UINT64
+PchSmmLatencyChildStart (
+  IN DATABASE_RECORD                    *Record
+  )
+{
+  if (FeaturePcdGet (PcdSmiLatencyProfileEnable)) {
+    mLatencyChild = Record;
+  }
+  return AsmReadTsc ();
+}
+
+/**
+  Account one latency sample of a child callback.
+
+  The callback may have unregistered its own child, which frees the record.
+  PchSmmLatencyForgetChild () then cleared mLatencyChild and the sample is
+  dropped.
+
+  @param[in] Record                     Database record of the child, possibly freed
+  @param[in] Cycles                     Duration of the callback in TSC cycles
+**/
+VOID
+PchSmmLatencyRecordChild (
+  IN DATABASE_RECORD                    *Record,
+  IN UINT64                             Cycles
+  )
+{
+  if (!FeaturePcdGet (PcdSmiLatencyProfileEnable)) {
+    return;
+  }
+
+  if (mLatencyChild == Record) {
+    PchSmmLatencyRecord (&Record->Latency, Cycles);
+  }
+  mLatencyChild = NULL;
+}
+
+/**
+  Stop timing a child whose record is being freed.
+
+  @param[in] Record                     Database record being unregistered
+**/
+VOID
+PchSmmLatencyForgetChild (
+  IN DATABASE_RECORD                    *Record
+  )
+{
+  if (mLatencyChild == Record) {
+    mLatencyChild = NULL;
+  }
+}
+
+/**
+  Find the file GUID of the SMM driver containing an address.
+
+  @param[in]  Address                   Address in the driver image
+  @param[in]  Handles                   Handles with the loaded image protocol in SMM
+  @param[in]  HandleCount               Number of entries in Handles
+  @param[out] ImageGuid                 File GUID of the driver, zero if not found
+**/
+STATIC
+VOID
+SmiLatencyGetImageGuid (
+  IN  UINTN                             Address,
+  IN  EFI_HANDLE                        *Handles,
+  IN  UINTN                             HandleCount,
+  OUT EFI_GUID                          *ImageGuid
+  )
+{
+  EFI_STATUS                            Status;
+  EFI_LOADED_IMAGE_PROTOCOL             *LoadedImage;
+  UINTN                                 Index;
+
+  ZeroMem (ImageGuid, sizeof (EFI_GUID));
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gSmst->SmmHandleProtocol (Handles[Index], &gEfiLoadedImageProtocolGuid, (VOID **) &LoadedImage);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+    if ((Address < (UINTN) LoadedImage->ImageBase) ||
+        (Address - (UINTN) LoadedImage->ImageBase >= LoadedImage->ImageSize)) {
+      continue;
+    }
+    if ((LoadedImage->FilePath != NULL) &&
+        (DevicePathType (LoadedImage->FilePath) == MEDIA_DEVICE_PATH) &&
+        (DevicePathSubType (LoadedImage->FilePath) == MEDIA_PIWG_FW_FILE_DP)) {
+      CopyGuid (ImageGuid, &((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *) LoadedImage->FilePath)->FvFileName);
+    }
+    return;
+  }
+}
+
+/**
+  Fill the exported description of a database record.
+
+  @param[in]  Record                    Database record
+  @param[in]  Index                     Position of the record in the database
+  @param[in]  Handles                   Handles with the loaded image protocol in SMM
+  @param[in]  HandleCount               Number of entries in Handles
+  @param[out] Child                     Exported child record
+**/
+STATIC
+VOID
+SmiLatencyFillChild (
+  IN  DATABASE_RECORD                   *Record,
+  IN  UINTN                             Index,
+  IN  EFI_HANDLE                        *Handles,
+  IN  UINTN                             HandleCount,
+  OUT SMI_LATENCY_CHILD_RECORD          *Child
+  )
+{
+  UINTN                                 ProtocolIndex;
+  UINTN                                 Handler;
+
+  ZeroMem (Child, sizeof (SMI_LATENCY_CHILD_RECORD));
+  for (ProtocolIndex = 0; ProtocolIndex < PCH_SMM_PROTOCOL_TYPE_MAX; ProtocolIndex++) {
+    if (mPrivateData.Protocols[ProtocolIndex].Type == Record->ProtocolType) {
+      CopyGuid (&Child->ProtocolGuid, mPrivateData.Protocols[ProtocolIndex].Guid);
+      break;
+    }
+  }
+  Child->ProtocolType = (UINT32) Record->ProtocolType;
+  if (Record->ProtocolType == PchSmiDispatchType) {
+    Child->SubType = (UINT32) Record->PchSmiType;
+    Handler = (UINTN) Record->PchSmiCallback;
+  } else {
+    Handler = (UINTN) Record->Callback;
+  }
+  SmiLatencyGetImageGuid (Handler, Handles, HandleCount, &Child->ImageGuid);
+  Child->Index = (UINT32) Index;
+  CopyMem (&Child->Statistics, &Record->Latency, sizeof (SMI_LATENCY_STATISTICS));
+}
+
+/**
+  Take a snapshot of the latency database.
+
+  @retval EFI_SUCCESS                   The snapshot is in mLatencySnapshot
+  @retval EFI_OUT_OF_RESOURCES          Fail to allocate pool for the snapshot
+**/
+STATIC
+EFI_STATUS
+SmiLatencyTakeSnapshot (
+  VOID
+  )
+{
+  EFI_STATUS                            Status;
+  SMI_LATENCY_PROFILE_DATABASE          *Database;
+  SMI_LATENCY_CHILD_RECORD              *Child;
+  LIST_ENTRY                            *LinkInDb;
+  UINTN                                 ChildCount;
+  EFI_HANDLE                            *Handles;
+  UINTN                                 HandleSize;
+  UINTN                                 Index;
+
+  ChildCount = 0;
+  LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+  while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    ChildCount++;
+    LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb);
+  }
+
+  if (mLatencySnapshot != NULL) {
+    gSmst->SmmFreePool (mLatencySnapshot);
+    mLatencySnapshot     = NULL;
+    mLatencySnapshotSize = 0;
+  }
+
+  Status = gSmst->SmmAllocatePool (
+                    EfiRuntimeServicesData,
+                    sizeof (SMI_LATENCY_PROFILE_DATABASE) + ChildCount * sizeof (SMI_LATENCY_CHILD_RECORD),
+                    (VOID **) &mLatencySnapshot
+                    );
+  if (EFI_ERROR (Status)) {
+    mLatencySnapshot = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+  mLatencySnapshotSize = sizeof (SMI_LATENCY_PROFILE_DATABASE) + ChildCount * sizeof (SMI_LATENCY_CHILD_RECORD);
+
+  Database = (SMI_LATENCY_PROFILE_DATABASE *) mLatencySnapshot;
+  Database->Signature  = SMI_LATENCY_PROFILE_SIGNATURE;
+  Database->Length     = (UINT32) mLatencySnapshotSize;
+  Database->ChildCount = (UINT32) ChildCount;
+  Database->Reserved   = 0;
+  CopyMem (&Database->Dispatcher, &mDispatcherLatency, sizeof (SMI_LATENCY_STATISTICS));
+
+  //
+  // The loaded images are used to name the driver of each child handler
+  //
+  Handles    = NULL;
+  HandleSize = 0;
+  Status = gSmst->SmmLocateHandle (ByProtocol, &gEfiLoadedImageProtocolGuid, NULL, &HandleSize, Handles);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, HandleSize, (VOID **) &Handles);
+    if (!EFI_ERROR (Status)) {
+      Status = gSmst->SmmLocateHandle (ByProtocol, &gEfiLoadedImageProtocolGuid, NULL, &HandleSize, Handles);
+    }
+  }
+  if (EFI_ERROR (Status)) {
+    HandleSize = 0;
+  }
+
+  Child = (SMI_LATENCY_CHILD_RECORD *) (Database + 1);
+  Index = 0;
+  LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+  while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    SmiLatencyFillChild (DATABASE_RECORD_FROM_LINK (LinkInDb), Index, Handles, HandleSize / sizeof (EFI_HANDLE), Child);
+    Child++;
+    Index++;
+    LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb);
+  }
+
+  if (Handles != NULL) {
+    gSmst->SmmFreePool (Handles);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Clear the dispatcher and the child latency statistics.
+**/
+STATIC
+VOID
+SmiLatencyReset (
+  VOID
+  )
+{
+  DATABASE_RECORD                       *RecordInDb;
+  LIST_ENTRY                            *LinkInDb;
+
+  ZeroMem (&mDispatcherLatency, sizeof (SMI_LATENCY_STATISTICS));
+  LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+  while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+    ZeroMem (&RecordInDb->Latency, sizeof (SMI_LATENCY_STATISTICS));
+    LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb);
+  }
+}
+
+/**
+  Copy a chunk of the latency database snapshot to the caller.
+
+  @param[in, out] GetData               The GET_DATA_BY_OFFSET parameter in the communicate buffer
+**/
+STATIC
+VOID
+SmiLatencyGetDataByOffset (
+  IN OUT SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET  *GetData
+  )
+{
+  SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET  Parameter;
+
+  CopyMem (&Parameter, GetData, sizeof (Parameter));
+
+  if ((mLatencySnapshot == NULL) || (Parameter.DataOffset >= mLatencySnapshotSize)) {
+    GetData->Header.ReturnStatus = (UINT64) (INT64) (INTN) EFI_NOT_READY;
+    return;
+  }
+
+  if (Parameter.DataSize > mLatencySnapshotSize - Parameter.DataOffset) {
+    Parameter.DataSize = mLatencySnapshotSize - Parameter.DataOffset;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((EFI_PHYSICAL_ADDRESS) Parameter.DataBuffer, Parameter.DataSize)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyProfile: data buffer is in SMRAM or overflow!\n"));
+    GetData->Header.ReturnStatus = (UINT64) (INT64) (INTN) EFI_ACCESS_DENIED;
+    return;
+  }
+
+  CopyMem (
+    (VOID *) (UINTN) Parameter.DataBuffer,
+    mLatencySnapshot + Parameter.DataOffset,
+    (UINTN) Parameter.DataSize
+    );
+  GetData->DataSize            = Parameter.DataSize;
+  GetData->DataOffset          = Parameter.DataOffset + Parameter.DataSize;
+  GetData->Header.ReturnStatus = 0;
+}
+
+/**
+  MM communicate handler exporting the SMI latency statistics.
+
+  @param[in]     DispatchHandle         The unique handle assigned to this handler by SmiHandlerRegister().
+  @param[in]     RegisterContext        Not used
+  @param[in,out] CommBuffer             A pointer to a collection of data in memory that will
+                                        be conveyed from a non-SMM environment into an SMM environment.
+  @param[in,out] CommBufferSize         The size of the CommBuffer.
+
+  @retval EFI_SUCCESS                   The interrupt was handled.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+SmiLatencyProfileHandler (
+  IN     EFI_HANDLE                     DispatchHandle,
+  IN     CONST VOID                     *RegisterContext,
+  IN OUT VOID                           *CommBuffer,
+  IN OUT UINTN                          *CommBufferSize
+  )
+{
+  SMI_LATENCY_PROFILE_PARAMETER_HEADER    *Header;
+  SMI_LATENCY_PROFILE_PARAMETER_GET_INFO  *GetInfo;
+  UINTN                                   TempCommBufferSize;
+
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  TempCommBufferSize = *CommBufferSize;
+  if (TempCommBufferSize < sizeof (SMI_LATENCY_PROFILE_PARAMETER_HEADER)) {
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((UINTN) CommBuffer, TempCommBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyProfile: communication buffer in SMRAM or overflow!\n"));
+    return EFI_SUCCESS;
+  }
+
+  Header = (SMI_LATENCY_PROFILE_PARAMETER_HEADER *) CommBuffer;
+  Header->ReturnStatus = (UINT64) -1;
+
+  switch (Header->Command) {
+    case SMI_LATENCY_PROFILE_COMMAND_GET_INFO:
+      if (TempCommBufferSize != sizeof (SMI_LATENCY_PROFILE_PARAMETER_GET_INFO)) {
+        break;
+      }
+      GetInfo = (SMI_LATENCY_PROFILE_PARAMETER_GET_INFO *) CommBuffer;
+      if (EFI_ERROR (SmiLatencyTakeSnapshot ())) {
+        GetInfo->Header.ReturnStatus = (UINT64) (INT64) (INTN) EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      GetInfo->DataSize            = mLatencySnapshotSize;
+      GetInfo->Header.ReturnStatus = 0;
+      break;
+    case SMI_LATENCY_PROFILE_COMMAND_GET_DATA_BY_OFFSET:
+      if (TempCommBufferSize != sizeof (SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET)) {
+        break;
+      }
+      SmiLatencyGetDataByOffset ((SMI_LATENCY_PROFILE_PARAMETER_GET_DATA_BY_OFFSET *) CommBuffer);
+      break;
+    case SMI_LATENCY_PROFILE_COMMAND_RESET:
+      SmiLatencyReset ();
+      Header->ReturnStatus = 0;
+      break;
+    default:
+      break;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Register the MM communicate handler exporting the SMI latency statistics.
+**/
+VOID
+InstallSmiLatencyProfile (
+  VOID
+  )
+{
+  EFI_STATUS                            Status;
+
+  if (!FeaturePcdGet (PcdSmiLatencyProfileEnable)) {
+    return;
+  }
+
+  Status = gSmst->SmiHandlerRegister (SmiLatencyProfileHandler, &gSmiLatencyProfileGuid, &mLatencyProfileHandle);
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Log the statistics collected during boot. The MM communicate handler stays
+  registered so that the statistics of runtime SMIs can still be read.
+**/
+VOID
+DumpSmiLatencyProfile (
+  VOID
+  )
+{
+  SMI_LATENCY_PROFILE_DATABASE          *Database;
+  SMI_LATENCY_CHILD_RECORD              *Child;
+  UINT32                                Index;
+
+  if (mLatencyProfileHandle == NULL) {
+    return;
+  }
+
+  if (!EFI_ERROR (SmiLatencyTakeSnapshot ())) {
+    Database = (SMI_LATENCY_PROFILE_DATABASE *) mLatencySnapshot;
+    DEBUG ((
+      DEBUG_INFO,
+      "SmiLatencyProfile: dispatcher count %ld, max %ld cycles\n",
+      Database->Dispatcher.Count,
+      Database->Dispatcher.MaxCycles
+      ));
+    Child = (SMI_LATENCY_CHILD_RECORD *) (Database + 1);
+    for (Index = 0; Index < Database->ChildCount; Index++, Child++) {
+      if (Child->Statistics.Count == 0) {
+        continue;
+      }
+      DEBUG ((
+        DEBUG_INFO,
+        "SmiLatencyProfile: child %d %g type %d, count %ld, max %ld cycles\n",
+        Child->Index,
+        &Child->ImageGuid,
+        Child->ProtocolType,
+        Child->Statistics.Count,
+        Child->Statistics.MaxCycles
+        ));
+    }
+    gSmst->SmmFreePool (mLatencySnapshot);
+  }
+
+  mLatencySnapshot     = NULL;
+  mLatencySnapshotSize = 0;
+}
@@ -594,6 +594,24 @@ Mvpp2BmPoolPut (
   Mvpp2Write(Priv, MVPP2_BM_PHY_RLS_REG(Pool), (UINT32)BufPhysAddr);
 }
 
+/*
+ * Release buffer to BM, assuming the upper address bits were already
+ * programmed by a previous Mvpp2BmPoolPut with the same high bits.
+ */
+STATIC
+inline
+VOID
+Mvpp2BmPoolPutLow (
+  IN MVPP2_SHARED *Priv,
+  IN INT32 Pool,
+  IN UINT64 BufPhysAddr,
+  IN UINT64 BufVirtAddr
+  )
+{
+  Mvpp2Write(Priv, MVPP2_BM_VIRT_RLS_REG, (UINT32)BufVirtAddr);
+  Mvpp2Write(Priv, MVPP2_BM_PHY_RLS_REG(Pool), (UINT32)BufPhysAddr);
+}
+
 STATIC
 inline
 VOID
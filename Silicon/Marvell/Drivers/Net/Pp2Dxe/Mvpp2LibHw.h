@@ -21,6 +21,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MVPP22_XLG_OFFSET                                  0x130f00
 #define MVPP22_XLG_REG_SIZE                                0x1000
 #define MVPP22_RFU1_OFFSET                                 0x441000
+#define MVPP22_MIB_COUNTERS_OFFSET                         0x129000
+#define MVPP22_MIB_COUNTERS_PORT_SZ                        0x100
 
 /* RX Fifo Registers */
 #define MVPP2_RX_DATA_FIFO_SIZE_REG(port)                 (0x00 + 4 * (port))
@@ -257,6 +259,24 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MVPP2_PHY_AN_CFG0_REG                             0x34
 #define MVPP2_PHY_AN_STOP_SMI0_MASK                       BIT(7)
 #define MVPP2_MIB_COUNTERS_BASE(port)                     (0x1000 + ((port) >> 1) * 0x400 + (port) * 0x400)
+#define MVPP2_MIB_GOOD_OCTETS_RCVD                        0x0
+#define MVPP2_MIB_BAD_OCTETS_RCVD                         0x8
+#define MVPP2_MIB_CRC_ERRORS_SENT                         0xc
+#define MVPP2_MIB_UNICAST_FRAMES_RCVD                     0x10
+#define MVPP2_MIB_BROADCAST_FRAMES_RCVD                   0x18
+#define MVPP2_MIB_MULTICAST_FRAMES_RCVD                   0x1c
+#define MVPP2_MIB_GOOD_OCTETS_SENT                        0x38
+#define MVPP2_MIB_UNICAST_FRAMES_SENT                     0x40
+#define MVPP2_MIB_MULTICAST_FRAMES_SENT                   0x48
+#define MVPP2_MIB_BROADCAST_FRAMES_SENT                   0x4c
+#define MVPP2_MIB_RX_FIFO_OVERRUN                         0x5c
+#define MVPP2_MIB_UNDERSIZE_RCVD                          0x60
+#define MVPP2_MIB_FRAGMENTS_RCVD                          0x64
+#define MVPP2_MIB_OVERSIZE_RCVD                           0x68
+#define MVPP2_MIB_JABBER_RCVD                             0x6c
+#define MVPP2_MIB_MAC_RCV_ERROR                           0x70
+#define MVPP2_MIB_BAD_CRC_EVENT                           0x74
+#define MVPP2_MIB_COLLISION                               0x78
 #define MVPP2_MIB_LATE_COLLISION                          0x7c
 #define MVPP2_ISR_SUM_MASK_REG                            0x220c
 #define MVPP2_MNG_EXTENDED_GLOBAL_CTRL_REG                0x305c
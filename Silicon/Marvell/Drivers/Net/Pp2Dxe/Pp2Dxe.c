@@ -98,7 +98,7 @@ EFI_SIMPLE_NETWORK_MODE Pp2SnpModeTemplate = {
   },                                                    // Permanent Address
   NET_IFTYPE_ETHERNET,                                  // IfType
   TRUE,                                                 // MacAddressChangeable
-  FALSE,                                                // MultipleTxSupported
+  TRUE,                                                 // MultipleTxSupported
   TRUE,                                                 // MediaPresentSupported
   FALSE                                                 // MediaPresent
 };
@@ -142,6 +142,143 @@ QueueRemove (
   return Buffer;
 }
 
+STATIC
+UINTN
+QueueCount (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  if (Pp2Context->CompletionQueueTail >= Pp2Context->CompletionQueueHead) {
+    return Pp2Context->CompletionQueueTail - Pp2Context->CompletionQueueHead;
+  }
+
+  return QUEUE_DEPTH - Pp2Context->CompletionQueueHead + Pp2Context->CompletionQueueTail;
+}
+
+/*
+ * Move buffers of packets already sent by the hardware from the in-flight
+ * list to the completion queue. Packets are sent in order, so the oldest
+ * in-flight buffers are the completed ones.
+ */
+STATIC
+VOID
+Pp2DxeTxReap (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_PORT *Port = &Pp2Context->Port;
+  PP2DXE_DRIVER_STATS *Stats = &Pp2Context->Stats;
+  UINTN TxSent;
+  UINT64 Now;
+  UINT64 Elapsed;
+  EFI_STATUS Status;
+
+  if (Pp2Context->TxInFlightCount == 0) {
+    return;
+  }
+
+  TxSent = (UINTN)Mvpp2TxqSentDescProc(Port, &Port->Txqs[0]);
+  ASSERT (TxSent <= Pp2Context->TxInFlightCount);
+  TxSent = MIN (TxSent, Pp2Context->TxInFlightCount);
+  if (TxSent == 0) {
+    return;
+  }
+
+  /*
+   * Completion is only seen when reaping, so the time from post to reap is
+   * an upper bound of the time the hardware took to send the packet.
+   */
+  Now = GetPerformanceCounter ();
+
+  while (TxSent-- > 0) {
+    Elapsed = GetTimeInNanoSecond (Now - Pp2Context->TxInFlightTime[Pp2Context->TxInFlightHead]);
+    Stats->TxCompleted++;
+    Stats->TxCompletionTime += Elapsed;
+    Stats->TxCompletionTimeMax = MAX (Stats->TxCompletionTimeMax, Elapsed);
+
+    /*
+     * Transmit keeps in-flight and completed buffers below QUEUE_DEPTH,
+     * so there is always room in the completion queue.
+     */
+    Status = QueueInsert (Pp2Context, Pp2Context->TxInFlight[Pp2Context->TxInFlightHead]);
+    ASSERT_EFI_ERROR (Status);
+
+    Pp2Context->TxInFlight[Pp2Context->TxInFlightHead] = NULL;
+    Pp2Context->TxInFlightHead = (Pp2Context->TxInFlightHead + 1) % MVPP2_MAX_TXD;
+    Pp2Context->TxInFlightCount--;
+  }
+}
+
+/* Read a MIB counter of the port */
+STATIC
+UINT32
+Pp2DxeMibRead (
+  IN PP2DXE_PORT *Port,
+  IN UINT32 Offset
+  )
+{
+  return MmioRead32 (Port->Priv->Base + MVPP22_MIB_COUNTERS_OFFSET +
+                     Port->GopIndex * MVPP22_MIB_COUNTERS_PORT_SZ + Offset);
+}
+
+/*
+ * Accumulate the MIB counters of the port. The hardware clears them on read,
+ * so this must be the only place reading them.
+ */
+STATIC
+VOID
+Pp2DxeMibUpdate (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_PORT *Port = &Pp2Context->Port;
+  PP2DXE_MIB_COUNTERS *Mib = &Pp2Context->Mib;
+
+  /* Octet counters are 64-bit, the low word has to be read first */
+  Mib->GoodOctetsRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_GOOD_OCTETS_RCVD);
+  Mib->GoodOctetsRcvd += LShiftU64 (Pp2DxeMibRead (Port, MVPP2_MIB_GOOD_OCTETS_RCVD + 4), 32);
+  Mib->GoodOctetsSent += Pp2DxeMibRead (Port, MVPP2_MIB_GOOD_OCTETS_SENT);
+  Mib->GoodOctetsSent += LShiftU64 (Pp2DxeMibRead (Port, MVPP2_MIB_GOOD_OCTETS_SENT + 4), 32);
+
+  Mib->BadOctetsRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_BAD_OCTETS_RCVD);
+  Mib->CrcErrorsSent += Pp2DxeMibRead (Port, MVPP2_MIB_CRC_ERRORS_SENT);
+  Mib->UnicastFramesRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_UNICAST_FRAMES_RCVD);
+  Mib->BroadcastFramesRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_BROADCAST_FRAMES_RCVD);
+  Mib->MulticastFramesRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_MULTICAST_FRAMES_RCVD);
+  Mib->UnicastFramesSent += Pp2DxeMibRead (Port, MVPP2_MIB_UNICAST_FRAMES_SENT);
+  Mib->MulticastFramesSent += Pp2DxeMibRead (Port, MVPP2_MIB_MULTICAST_FRAMES_SENT);
+  Mib->BroadcastFramesSent += Pp2DxeMibRead (Port, MVPP2_MIB_BROADCAST_FRAMES_SENT);
+  Mib->RxFifoOverrun += Pp2DxeMibRead (Port, MVPP2_MIB_RX_FIFO_OVERRUN);
+  Mib->UndersizeRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_UNDERSIZE_RCVD);
+  Mib->FragmentsRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_FRAGMENTS_RCVD);
+  Mib->OversizeRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_OVERSIZE_RCVD);
+  Mib->JabberRcvd += Pp2DxeMibRead (Port, MVPP2_MIB_JABBER_RCVD);
+  Mib->MacRcvError += Pp2DxeMibRead (Port, MVPP2_MIB_MAC_RCV_ERROR);
+  Mib->BadCrcEvent += Pp2DxeMibRead (Port, MVPP2_MIB_BAD_CRC_EVENT);
+  Mib->Collision += Pp2DxeMibRead (Port, MVPP2_MIB_COLLISION);
+  Mib->LateCollision += Pp2DxeMibRead (Port, MVPP2_MIB_LATE_COLLISION);
+}
+
+/* Wait until all posted packets are sent by the hardware */
+STATIC
+VOID
+Pp2DxeTxDrain (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  INTN PollingCount;
+
+  PollingCount = 0;
+  while (Pp2Context->TxInFlightCount != 0) {
+    if (PollingCount++ > MVPP2_TX_SEND_MAX_POLLING_COUNT) {
+      DEBUG((DEBUG_ERROR, "Pp2Dxe%d: %u packets not sent\n", Pp2Context->Instance, (UINT32)Pp2Context->TxInFlightCount));
+      Pp2Context->Stats.TxUnsent += Pp2Context->TxInFlightCount;
+      break;
+    }
+    Pp2DxeTxReap (Pp2Context);
+  }
+}
+
 STATIC
 EFI_STATUS
 Pp2DxeBmPoolInit (
@@ -685,9 +822,23 @@ Pp2DxeHalt (
 {
   PP2DXE_PORT *Port = &Pp2Context->Port;
   MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
+  PP2DXE_RX_PACKET *Packet;
   INTN Index;
 
+  /* Let the hardware finish DMA from the buffers still owned by the caller */
+  if (Pp2Context->LateInitialized) {
+    Pp2DxeTxDrain (Pp2Context);
+  }
+
   if (Mvpp2Shared->BmEnabled) {
+    /* Give the buffers of packets not received yet back to BM */
+    while (Pp2Context->RxRingCount > 0) {
+      Packet = &Pp2Context->RxRing[Pp2Context->RxRingHead];
+      Mvpp2BmPoolPut (Mvpp2Shared, Packet->PoolId, Packet->PhysAddr, Packet->VirtAddr);
+      Pp2Context->RxRingHead = (Pp2Context->RxRingHead + 1) % MVPP2_RX_SW_RING_SIZE;
+      Pp2Context->RxRingCount--;
+    }
+
     for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
       Mvpp2BmStop(Mvpp2Shared, Index);
     }
@@ -697,6 +848,10 @@ Pp2DxeHalt (
 
   Mvpp2TxqDrainSet(Port, 0, TRUE);
   Mvpp2IngressDisable(Port);
+
+  /* Discard packets buffered by software */
+  Pp2Context->RxRingHead = 0;
+  Pp2Context->RxRingCount = 0;
   Mvpp2EgressDisable(Port);
 
   MvGop110PortEventsMask(Port);
@@ -909,7 +1064,115 @@ Pp2SnpNetStat (
   OUT EFI_NETWORK_STATISTICS     *StatisticsTable  OPTIONAL
   )
 {
-  return EFI_UNSUPPORTED;
+  PP2DXE_CONTEXT *Pp2Context;
+  PP2DXE_MIB_COUNTERS *Mib;
+  PP2DXE_DRIVER_STATS *Stats;
+  EFI_NETWORK_STATISTICS Table;
+  EFI_TPL SavedTpl;
+  EFI_STATUS Status;
+
+  /* Check input parameters. */
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!Reset && StatisticsSize == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (StatisticsSize != NULL && *StatisticsSize != 0 && StatisticsTable == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Pp2Context = INSTANCE_FROM_SNP (This);
+
+  /* Check whether the driver was started and initialized. */
+  if (This->Mode->State != EfiSimpleNetworkInitialized) {
+    switch (This->Mode->State) {
+    case EfiSimpleNetworkStopped:
+      DEBUG ((DEBUG_WARN, "Pp2Dxe%d: not started\n", Pp2Context->Instance));
+      ReturnUnlock (SavedTpl, EFI_NOT_STARTED);
+    case EfiSimpleNetworkStarted:
+      DEBUG ((DEBUG_WARN, "Pp2Dxe%d: not initialized\n", Pp2Context->Instance));
+      ReturnUnlock (SavedTpl, EFI_DEVICE_ERROR);
+    default:
+      DEBUG ((DEBUG_WARN,
+        "Pp2Dxe%d: wrong state: %u\n",
+        Pp2Context->Instance,
+        This->Mode->State));
+      ReturnUnlock (SavedTpl, EFI_DEVICE_ERROR);
+    }
+  }
+
+  Mib = &Pp2Context->Mib;
+  Stats = &Pp2Context->Stats;
+
+  if (Pp2Context->LateInitialized) {
+    Pp2DxeMibUpdate (Pp2Context);
+  }
+
+  Status = EFI_SUCCESS;
+  if (StatisticsSize != NULL) {
+    /* Statistics the port does not count are reported as all ones */
+    SetMem (&Table, sizeof (Table), 0xFF);
+
+    Table.RxUnicastFrames = Mib->UnicastFramesRcvd;
+    Table.RxBroadcastFrames = Mib->BroadcastFramesRcvd;
+    Table.RxMulticastFrames = Mib->MulticastFramesRcvd;
+    Table.RxGoodFrames = Table.RxUnicastFrames + Table.RxBroadcastFrames + Table.RxMulticastFrames;
+    Table.RxUndersizeFrames = Mib->UndersizeRcvd + Mib->FragmentsRcvd;
+    Table.RxOversizeFrames = Mib->OversizeRcvd + Mib->JabberRcvd;
+    Table.RxCrcErrorFrames = Mib->BadCrcEvent;
+    Table.RxTotalFrames = Table.RxGoodFrames + Table.RxUndersizeFrames + Table.RxOversizeFrames +
+                          Table.RxCrcErrorFrames + Mib->MacRcvError;
+    Table.RxDroppedFrames = Mib->RxFifoOverrun + Stats->RxErrorDrops + Stats->RxOversizeDrops;
+    Table.RxTotalBytes = Mib->GoodOctetsRcvd + Mib->BadOctetsRcvd;
+
+    Table.TxUnicastFrames = Mib->UnicastFramesSent;
+    Table.TxBroadcastFrames = Mib->BroadcastFramesSent;
+    Table.TxMulticastFrames = Mib->MulticastFramesSent;
+    Table.TxGoodFrames = Table.TxUnicastFrames + Table.TxBroadcastFrames + Table.TxMulticastFrames;
+    Table.TxCrcErrorFrames = Mib->CrcErrorsSent;
+    Table.TxTotalFrames = Table.TxGoodFrames + Table.TxCrcErrorFrames;
+    Table.TxDroppedFrames = Stats->TxUnsent;
+    Table.TxTotalBytes = Mib->GoodOctetsSent;
+
+    Table.Collisions = Mib->Collision + Mib->LateCollision;
+
+    if (*StatisticsSize < sizeof (Table)) {
+      Status = EFI_BUFFER_TOO_SMALL;
+    }
+
+    if (StatisticsTable != NULL) {
+      CopyMem (StatisticsTable, &Table, MIN (*StatisticsSize, sizeof (Table)));
+    }
+
+    *StatisticsSize = sizeof (Table);
+  }
+
+  DEBUG ((DEBUG_INFO,
+    "Pp2Dxe%d: rx drops %lu error %lu oversize, %lu buffer too small, %lu refill stalls\n",
+    Pp2Context->Instance,
+    Stats->RxErrorDrops,
+    Stats->RxOversizeDrops,
+    Stats->RxBufferTooSmall,
+    Stats->RxRefillStalls));
+  DEBUG ((DEBUG_INFO,
+    "Pp2Dxe%d: tx %lu ring full, %lu unsent, completion avg %lu us max %lu us\n",
+    Pp2Context->Instance,
+    Stats->TxRingFull,
+    Stats->TxUnsent,
+    (Stats->TxCompleted != 0) ? DivU64x64Remainder (Stats->TxCompletionTime, Stats->TxCompleted * 1000, NULL) : 0,
+    DivU64x32 (Stats->TxCompletionTimeMax, 1000)));
+
+  if (Reset) {
+    ZeroMem (Mib, sizeof (*Mib));
+    ZeroMem (Stats, sizeof (*Stats));
+  }
+
+  ReturnUnlock (SavedTpl, Status);
 }
 
 EFI_STATUS
@@ -1064,6 +1327,7 @@ Pp2SnpGetStatus (
   Snp->Mode->MediaPresent = LinkUp;
 
   if (TxBuf != NULL) {
+    Pp2DxeTxReap (Pp2Context);
     *TxBuf = QueueRemove (Pp2Context);
   }
 
@@ -1087,13 +1351,11 @@ Pp2SnpTransmit (
   MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
   MVPP2_TX_QUEUE *AggrTxq = Mvpp2Shared->AggrTxqs;
   MVPP2_TX_DESC *TxDesc;
-  EFI_STATUS Status;
-  INTN PollingCount;
-  INTN TxSent;
   UINT8 *DataPtr = Buffer;
   UINT16 EtherType;
   UINT32 State = This->Mode->State;
   EFI_TPL SavedTpl;
+  UINTN Index;
 
   if (This == NULL || Buffer == NULL) {
     DEBUG((DEBUG_ERROR, "Pp2Dxe: NULL Snp or Buffer\n"));
@@ -1133,11 +1395,23 @@ Pp2SnpTransmit (
     ReturnUnlock(SavedTpl, EFI_NOT_READY);
   }
 
+  /*
+   * Reap completed packets and make sure the new one can be tracked
+   * until the caller collects it through GetStatus.
+   */
+  Pp2DxeTxReap (Pp2Context);
+  if (Pp2Context->TxInFlightCount >= MVPP2_TX_IN_FLIGHT_MAX ||
+      Pp2Context->TxInFlightCount + QueueCount (Pp2Context) >= QUEUE_DEPTH - 1) {
+    Pp2Context->Stats.TxRingFull++;
+    ReturnUnlock(SavedTpl, EFI_NOT_READY);
+  }
+
   /* Fetch next descriptor */
   TxDesc = Mvpp2TxqNextDescGet(AggrTxq);
 
   if (!TxDesc) {
     DEBUG((DEBUG_ERROR, "No tx descriptor to use\n"));
+    Pp2Context->Stats.TxRingFull++;
     ReturnUnlock(SavedTpl, EFI_OUT_OF_RESOURCES);
   }
 
@@ -1164,41 +1438,108 @@ Pp2SnpTransmit (
 
   InvalidateDataCacheRange (DataPtr, BufferSize);
 
-  /* Issue send */
-  Mvpp2AggrTxqPendDescAdd(Port, 1);
-
   /*
-   * Egress processing:
-   * Wait until packet is passed from per-cpu aggregated queue
-   * to physical per-port TXQ.
+   * Issue send. Completion is reaped lazily in GetStatus and Transmit,
+   * so that many packets can be in flight.
    */
-  PollingCount = 0;
-  TxSent = Mvpp2AggrTxqPendDescNumGet(Mvpp2Shared, 0);
-  do {
-    if (PollingCount++ > MVPP2_TX_SEND_MAX_POLLING_COUNT) {
-      DEBUG((DEBUG_ERROR, "Pp2Dxe: transmit polling failed\n"));
-      ReturnUnlock(SavedTpl, EFI_TIMEOUT);
+  Mvpp2AggrTxqPendDescAdd(Port, 1);
+
+  Index = (Pp2Context->TxInFlightHead + Pp2Context->TxInFlightCount) % MVPP2_MAX_TXD;
+  Pp2Context->TxInFlight[Index] = Buffer;
+  Pp2Context->TxInFlightTime[Index] = GetPerformanceCounter ();
+  Pp2Context->TxInFlightCount++;
+
+  ReturnUnlock (SavedTpl, EFI_SUCCESS);
+}
+
+/*
+ * Drain all descriptors received by the hardware into the software ring.
+ * The RXQ status is updated once per batch, instead of once per packet.
+ * Good packets stay in their BM buffer until Receive copies them out, so
+ * each packet is copied only once. Buffers of dropped packets go back to
+ * BM right away.
+ */
+STATIC
+VOID
+Pp2DxeRxDrain (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_PORT *Port = &Pp2Context->Port;
+  MVPP2_RX_QUEUE *Rxq = &Port->Rxqs[0];
+  PP2DXE_RX_PACKET *Packet;
+  MVPP2_RX_DESC *RxDesc;
+  UINTN PhysAddr, VirtAddr;
+  UINT32 StatusReg;
+  UINT32 AddrHigh;
+  UINT32 LastAddrHigh;
+  INTN ReceivedPackets;
+  INTN Processed;
+  INTN PoolId;
+  UINTN PktLength;
+
+  ReceivedPackets = Mvpp2RxqReceived(Port, Rxq->Id);
+  if (ReceivedPackets + (INTN)Pp2Context->RxRingCount >= MVPP2_BM_SIZE) {
+    /* Every BM buffer was waiting in the RXQ or the software ring, the pool ran dry */
+    Pp2Context->Stats.RxRefillStalls++;
+  }
+
+  ReceivedPackets = MIN (ReceivedPackets, (INTN)(MVPP2_RX_SW_RING_SIZE - Pp2Context->RxRingCount));
+  if (ReceivedPackets <= 0) {
+    return;
+  }
+
+  LastAddrHigh = MAX_UINT32;
+  for (Processed = 0; Processed < ReceivedPackets; Processed++) {
+    RxDesc = Mvpp2RxqNextDescGet(Rxq);
+    StatusReg = RxDesc->status;
+
+    /* extract addresses from descriptor */
+    PhysAddr = RxDesc->BufPhysAddrKeyHash & MVPP22_ADDR_MASK;
+    VirtAddr = RxDesc->BufCookieBmQsetClsInfo & MVPP22_ADDR_MASK;
+    PktLength = (UINTN) RxDesc->DataSize - 2;
+    PoolId = (StatusReg & MVPP2_RXD_BM_POOL_ID_MASK) >> MVPP2_RXD_BM_POOL_ID_OFFS;
+
+    if ((StatusReg & MVPP2_RXD_BUF_HDR) == 0 &&
+        (StatusReg & MVPP2_RXD_ERR_SUMMARY) == 0 &&
+        RxDesc->DataSize <= RX_BUFFER_SIZE) {
+      Packet = &Pp2Context->RxRing[(Pp2Context->RxRingHead + Pp2Context->RxRingCount) % MVPP2_RX_SW_RING_SIZE];
+      Packet->PhysAddr = PhysAddr;
+      Packet->VirtAddr = VirtAddr;
+      Packet->PoolId = PoolId;
+      Packet->Length = PktLength;
+      Pp2Context->RxRingCount++;
+      continue;
     }
-    TxSent = Mvpp2AggrTxqPendDescNumGet(Mvpp2Shared, 0);
-  } while (TxSent);
 
-  /* Wait for packet to be transmitted by hardware. */
-  PollingCount = 0;
-  TxSent = Mvpp2TxqSentDescProc(Port, &Port->Txqs[0]);
-  while (!TxSent) {
-    if (PollingCount++ > MVPP2_TX_SEND_MAX_POLLING_COUNT) {
-      DEBUG((DEBUG_ERROR, "Pp2Dxe: transmit polling failed\n"));
-      ReturnUnlock(SavedTpl, EFI_TIMEOUT);
+    /* Drop packets with error or with buffer header (MC, SG) */
+    if ((StatusReg & MVPP2_RXD_BUF_HDR) || (StatusReg & MVPP2_RXD_ERR_SUMMARY)) {
+      DEBUG((DEBUG_WARN,
+        "Pp2Dxe%d: dropping packet, status 0x%08x\n",
+        Pp2Context->Instance,
+        StatusReg));
+      Pp2Context->Stats.RxErrorDrops++;
+    } else {
+      DEBUG((DEBUG_ERROR, "Pp2Dxe: dropping oversized packet\n"));
+      Pp2Context->Stats.RxOversizeDrops++;
+    }
+
+    /*
+     * Refill: pass the buffer back to BM. All buffers come from the same
+     * region, so the upper address bits only need to be programmed once.
+     */
+    AddrHigh = ((Upper32Bits(VirtAddr) & MVPP22_ADDR_HIGH_MASK) << MVPP22_BM_VIRT_HIGH_RLS_OFFST) |
+               ((Upper32Bits(PhysAddr) & MVPP22_ADDR_HIGH_MASK) << MVPP22_BM_PHY_HIGH_RLS_OFFSET);
+    if (AddrHigh != LastAddrHigh) {
+      Mvpp2BmPoolPut (Port->Priv, PoolId, PhysAddr, VirtAddr);
+      LastAddrHigh = AddrHigh;
+    } else {
+      Mvpp2BmPoolPutLow (Port->Priv, PoolId, PhysAddr, VirtAddr);
     }
-    TxSent = Mvpp2TxqSentDescProc(Port, &Port->Txqs[0]);
   }
 
-  /*
-   * At this point TxSent has increased - HW sent the packet
-   * Add buffer to completion queue and return.
-   */
-  Status = QueueInsert (Pp2Context, Buffer);
-  ReturnUnlock (SavedTpl, Status);
+  /* Update counters with all descriptors processed and freed */
+  Mvpp2RxqStatusUpdate(Port, Rxq->Id, ReceivedPackets, ReceivedPackets);
 }
 
 EFI_STATUS
@@ -1213,18 +1554,10 @@ Pp2SnpReceive (
   OUT UINT16                     *EtherType OPTIONAL
   )
 {
-  INTN ReceivedPackets;
   PP2DXE_CONTEXT *Pp2Context;
-  PP2DXE_PORT *Port;
-  UINTN PhysAddr, VirtAddr;
-  EFI_STATUS Status;
+  PP2DXE_RX_PACKET *Packet;
   EFI_TPL SavedTpl;
-  UINT32 StatusReg;
-  INTN PoolId;
-  UINTN PktLength;
   UINT8 *DataPtr;
-  MVPP2_RX_DESC *RxDesc;
-  MVPP2_RX_QUEUE *Rxq;
 
   /* Check input parameters. */
   if (This == NULL || Buffer == NULL || BufferSize == NULL) {
@@ -1253,41 +1586,30 @@ Pp2SnpReceive (
     }
   }
 
-  Port = &Pp2Context->Port;
-  ASSERT (Port != NULL);
-  Rxq = &Port->Rxqs[0];
-  ASSERT (Rxq != NULL);
-
-  ReceivedPackets = Mvpp2RxqReceived(Port, Rxq->Id);
-
-  if (ReceivedPackets == 0) {
-    ReturnUnlock(SavedTpl, EFI_NOT_READY);
-  }
-
-  /* Process one packet per call */
-  RxDesc = Mvpp2RxqNextDescGet(Rxq);
-  StatusReg = RxDesc->status;
-
-  /* extract addresses from descriptor */
-  PhysAddr = RxDesc->BufPhysAddrKeyHash & MVPP22_ADDR_MASK;
-  VirtAddr = RxDesc->BufCookieBmQsetClsInfo & MVPP22_ADDR_MASK;
-
-  /* Drop packets with error or with buffer header (MC, SG) */
-  if ((StatusReg & MVPP2_RXD_BUF_HDR) || (StatusReg & MVPP2_RXD_ERR_SUMMARY)) {
-    DEBUG((DEBUG_WARN, "Pp2Dxe: dropping packet\n"));
-    Status = EFI_DEVICE_ERROR;
-    goto drop;
+  /* Only touch the hardware once the software ring is empty */
+  if (Pp2Context->RxRingCount == 0) {
+    Pp2DxeRxDrain (Pp2Context);
+    if (Pp2Context->RxRingCount == 0) {
+      ReturnUnlock(SavedTpl, EFI_NOT_READY);
+    }
   }
 
-  PktLength = (UINTN) RxDesc->DataSize - 2;
-  if (PktLength > *BufferSize) {
-    *BufferSize = PktLength;
+  Packet = &Pp2Context->RxRing[Pp2Context->RxRingHead];
+  if (Packet->Length > *BufferSize) {
+    *BufferSize = Packet->Length;
     DEBUG((DEBUG_ERROR, "Pp2Dxe: buffer too small\n"));
+    Pp2Context->Stats.RxBufferTooSmall++;
     ReturnUnlock(SavedTpl, EFI_BUFFER_TOO_SMALL);
   }
 
-  CopyMem (Buffer, (VOID*) (PhysAddr + 2), PktLength);
-  *BufferSize = PktLength;
+  CopyMem (Buffer, (VOID*) (Packet->PhysAddr + 2), Packet->Length);
+  *BufferSize = Packet->Length;
+
+  /* Refill: pass packet back to BM */
+  Mvpp2BmPoolPut (Pp2Context->Port.Priv, Packet->PoolId, Packet->PhysAddr, Packet->VirtAddr);
+
+  Pp2Context->RxRingHead = (Pp2Context->RxRingHead + 1) % MVPP2_RX_SW_RING_SIZE;
+  Pp2Context->RxRingCount--;
 
   if (HeaderSize != NULL) {
     *HeaderSize = Pp2Context->Snp.Mode->MediaHeaderSize;
@@ -1312,17 +1634,7 @@ Pp2SnpReceive (
     *EtherType = NTOHS (*(UINT16 *)(&DataPtr[12]));
   }
 
-  Status = EFI_SUCCESS;
-
-drop:
-  /* Refill: pass packet back to BM */
-  PoolId = (StatusReg & MVPP2_RXD_BM_POOL_ID_MASK) >> MVPP2_RXD_BM_POOL_ID_OFFS;
-  Mvpp2BmPoolPut (Pp2Context->Port.Priv, PoolId, PhysAddr, VirtAddr);
-
-  /* Update counters with 1 packet received and 1 packet refilled */
-  Mvpp2RxqStatusUpdate(Port, Rxq->Id, 1, 1);
-
-  ReturnUnlock(SavedTpl, Status);
+  ReturnUnlock(SavedTpl, EFI_SUCCESS);
 }
 
 EFI_STATUS
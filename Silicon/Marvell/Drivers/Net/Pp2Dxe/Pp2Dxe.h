@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/NetLib.h>
 #include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 
@@ -148,6 +149,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
  */
 #define MVPP2_TX_SEND_MAX_POLLING_COUNT   10000
 
+/*
+ * Maximum number of packets posted to the hardware, whose completion was not
+ * yet reaped. Bounded by the physical TXQ Size, so that the aggregated queue
+ * never holds more descriptors than the port queue can accept.
+ */
+#define MVPP2_TX_IN_FLIGHT_MAX            (MVPP2_MAX_TXD - 1)
+
+/*
+ * Number of received packets held by software. All descriptors received by
+ * the hardware are drained at once into this ring, so that the RXQ status
+ * is updated once per batch. The ring only records the BM buffers, which
+ * go back to BM once Receive has copied the packet out.
+ */
+#define MVPP2_RX_SW_RING_SIZE             MVPP2_MAX_RXD
+
 /* Structures */
 typedef struct {
   /* Physical number of this Tx queue */
@@ -318,6 +334,59 @@ struct Pp2DxePort {
   UINT8 FirstRxq;
 };
 
+typedef struct {
+  UINTN PhysAddr;
+  UINTN VirtAddr;
+  INTN PoolId;
+  UINTN Length;
+} PP2DXE_RX_PACKET;
+
+/*
+ * Hardware MIB counters, accumulated by software because the hardware
+ * clears them on read.
+ */
+typedef struct {
+  UINT64 GoodOctetsRcvd;
+  UINT64 BadOctetsRcvd;
+  UINT64 UnicastFramesRcvd;
+  UINT64 BroadcastFramesRcvd;
+  UINT64 MulticastFramesRcvd;
+  UINT64 GoodOctetsSent;
+  UINT64 UnicastFramesSent;
+  UINT64 MulticastFramesSent;
+  UINT64 BroadcastFramesSent;
+  UINT64 CrcErrorsSent;
+  UINT64 RxFifoOverrun;
+  UINT64 UndersizeRcvd;
+  UINT64 FragmentsRcvd;
+  UINT64 OversizeRcvd;
+  UINT64 JabberRcvd;
+  UINT64 MacRcvError;
+  UINT64 BadCrcEvent;
+  UINT64 Collision;
+  UINT64 LateCollision;
+} PP2DXE_MIB_COUNTERS;
+
+/* Events seen by the driver, which the MIB counters do not account for */
+typedef struct {
+  /* Descriptors dropped for a receive error or a buffer header */
+  UINT64 RxErrorDrops;
+  /* Packets dropped for not fitting the receive buffer */
+  UINT64 RxOversizeDrops;
+  /* Receive calls with a caller buffer too small for the packet */
+  UINT64 RxBufferTooSmall;
+  /* RXQ drains which found every BM buffer in use, i.e. refill came too late */
+  UINT64 RxRefillStalls;
+  /* Transmit calls rejected for lack of TX descriptors */
+  UINT64 TxRingFull;
+  /* Packets still not sent when draining the TXQ timed out */
+  UINT64 TxUnsent;
+  /* Packets reaped, and time from post to reap in nanoseconds */
+  UINT64 TxCompleted;
+  UINT64 TxCompletionTime;
+  UINT64 TxCompletionTimeMax;
+} PP2DXE_DRIVER_STATS;
+
 typedef struct {
   MAC_ADDR_DEVICE_PATH      Pp2Mac;
   EFI_DEVICE_PATH_PROTOCOL  End;
@@ -338,6 +407,15 @@ typedef struct {
   VOID                        *CompletionQueue[QUEUE_DEPTH];
   UINTN                       CompletionQueueHead;
   UINTN                       CompletionQueueTail;
+  VOID                        *TxInFlight[MVPP2_MAX_TXD];
+  UINT64                      TxInFlightTime[MVPP2_MAX_TXD];
+  UINTN                       TxInFlightHead;
+  UINTN                       TxInFlightCount;
+  PP2DXE_RX_PACKET            RxRing[MVPP2_RX_SW_RING_SIZE];
+  UINTN                       RxRingHead;
+  UINTN                       RxRingCount;
+  PP2DXE_MIB_COUNTERS         Mib;
+  PP2DXE_DRIVER_STATS         Stats;
   EFI_EVENT                   EfiExitBootServicesEvent;
   PP2_DEVICE_PATH             *DevicePath;
   EFI_ADAPTER_INFORMATION_PROTOCOL Aip;
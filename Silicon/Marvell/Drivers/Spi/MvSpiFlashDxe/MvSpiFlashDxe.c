@@ -158,22 +158,21 @@ MvSpiFlashErase (
 {
   EFI_STATUS Status;
   UINT32 EraseAddr;
-  UINTN EraseSize;
+  UINTN EraseSize, MinEraseSize, SectorSize;
   UINT8 Cmd[5];
 
+  SectorSize = Slave->Info->SectorSize;
+
   if (Slave->Info->Flags & NOR_FLASH_ERASE_4K) {
-    Cmd[0] = CMD_ERASE_4K;
-    EraseSize = SIZE_4KB;
+    MinEraseSize = SIZE_4KB;
   } else if (Slave->Info->Flags & NOR_FLASH_ERASE_32K) {
-    Cmd[0] = CMD_ERASE_32K;
-    EraseSize = SIZE_32KB;
+    MinEraseSize = SIZE_32KB;
   } else {
-    Cmd[0] = CMD_ERASE_64K;
-    EraseSize = Slave->Info->SectorSize;
+    MinEraseSize = SectorSize;
   }
 
   // Check input parameters
-  if (Offset % EraseSize || Length % EraseSize) {
+  if (Offset % MinEraseSize || Length % MinEraseSize) {
     DEBUG((DEBUG_ERROR, "SpiFlash: Either erase offset or length "
       "is not multiple of erase size\n"));
     return EFI_DEVICE_ERROR;
@@ -182,6 +181,19 @@ MvSpiFlashErase (
   while (Length) {
     EraseAddr = Offset;
 
+    // Use the largest erase command fitting the remaining range
+    if ((Offset % SectorSize) == 0 && Length >= SectorSize) {
+      Cmd[0] = CMD_ERASE_64K;
+      EraseSize = SectorSize;
+    } else if ((Slave->Info->Flags & NOR_FLASH_ERASE_32K) &&
+               (Offset % SIZE_32KB) == 0 && Length >= SIZE_32KB) {
+      Cmd[0] = CMD_ERASE_32K;
+      EraseSize = SIZE_32KB;
+    } else {
+      Cmd[0] = CMD_ERASE_4K;
+      EraseSize = SIZE_4KB;
+    }
+
     SpiFlashBank (Slave, EraseAddr);
 
     SpiFlashFormatAddress (EraseAddr, Slave->AddrSize, Cmd);
@@ -230,7 +242,10 @@ MvSpiFlashRead (
     }
     SpiFlashFormatAddress (ReadAddr, Slave->AddrSize, Cmd);
     // Program proper read address and read data
-    Status = MvSpiFlashReadCmd (Slave, Cmd, Slave->AddrSize + 2, Buf, Length);
+    Status = MvSpiFlashReadCmd (Slave, Cmd, Slave->AddrSize + 2, Buf, ReadLength);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
     Offset += ReadLength;
     Length -= ReadLength;
@@ -283,6 +298,54 @@ MvSpiFlashWrite (
   return EFI_SUCCESS;
 }
 
+/**
+  Check whether new data can be programmed over old data without an erase.
+  Programming can only clear bits, so an erase is needed as soon as the new
+  data has a bit set which is clear in the old data.
+
+  @param[in]  OldData     Current content of the flash.
+  @param[in]  NewData     Data to be programmed.
+  @param[in]  Length      Length of both buffers.
+
+  @retval TRUE            The range must be erased first.
+  @retval FALSE           The new data can be programmed directly.
+**/
+STATIC
+BOOLEAN
+MvSpiFlashNeedsErase (
+  IN CONST UINT8 *OldData,
+  IN CONST UINT8 *NewData,
+  IN UINTN       Length
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    if ((OldData[Index] & NewData[Index]) != NewData[Index]) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Update the beginning of a sector with new data, preserving the rest of it.
+
+  The sector is left untouched if it already holds the new data, and is only
+  programmed, without an erase, if the update merely clears bits.
+
+  @param[in]  Slave       SPI device.
+  @param[in]  Offset      Offset of the sector in the flash.
+  @param[in]  ToUpdate    Number of bytes to update from the sector start.
+  @param[in]  Buf         New data.
+  @param[in]  TmpBuf      Scratch buffer of EraseSize bytes.
+  @param[in]  EraseSize   Size of the sector.
+  @param[out] Written     Set to TRUE if the flash was modified.
+
+  @retval EFI_SUCCESS     The sector holds the new data.
+  @retval Others          An error occurred while accessing the flash.
+**/
 STATIC
 EFI_STATUS
 MvSpiFlashUpdateBlock (
@@ -291,10 +354,14 @@ MvSpiFlashUpdateBlock (
   IN UINTN ToUpdate,
   IN UINT8 *Buf,
   IN UINT8 *TmpBuf,
-  IN UINTN EraseSize
+  IN UINTN EraseSize,
+  OUT BOOLEAN *Written
   )
 {
   EFI_STATUS Status;
+  UINTN First, Last;
+
+  *Written = FALSE;
 
   // Read backup
   Status = MvSpiFlashRead (Slave, Offset, EraseSize, TmpBuf);
@@ -303,6 +370,32 @@ MvSpiFlashUpdateBlock (
       return Status;
     }
 
+  // Skip the sector if its content is unchanged
+  First = 0;
+  while (First < ToUpdate && TmpBuf[First] == Buf[First]) {
+    First++;
+  }
+  if (First == ToUpdate) {
+    return EFI_SUCCESS;
+  }
+
+  *Written = TRUE;
+
+  // Only clearing bits, program the changed bytes in place
+  if (!MvSpiFlashNeedsErase (&TmpBuf[First], &Buf[First], ToUpdate - First)) {
+    Last = ToUpdate - 1;
+    while (TmpBuf[Last] == Buf[Last]) {
+      Last--;
+    }
+
+    Status = MvSpiFlashWrite (Slave, Offset + First, Last - First + 1,
+      &Buf[First]);
+    if (EFI_ERROR (Status)) {
+      DEBUG((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
+    }
+    return Status;
+  }
+
   // Erase entire sector
   Status = MvSpiFlashErase (Slave, Offset, EraseSize);
   if (EFI_ERROR (Status)) {
@@ -311,7 +404,7 @@ MvSpiFlashUpdateBlock (
     }
 
   // Write new data
-  MvSpiFlashWrite (Slave, Offset, ToUpdate, Buf);
+  Status = MvSpiFlashWrite (Slave, Offset, ToUpdate, Buf);
   if (EFI_ERROR (Status)) {
       DEBUG((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
       return Status;
@@ -341,6 +434,7 @@ MvSpiFlashUpdate (
   EFI_STATUS Status;
   UINT64 SectorSize, ToUpdate, Scale = 1;
   UINT8 *TmpBuf, *End;
+  BOOLEAN Written;
 
   SectorSize = Slave->Info->SectorSize;
 
@@ -357,13 +451,18 @@ MvSpiFlashUpdate (
 
   for (; Buf < End; Buf += ToUpdate, Offset += ToUpdate) {
     ToUpdate = MIN((UINT64)(End - Buf), SectorSize);
-    Print (L"   \rUpdating, %d%%", 100 - (End - Buf) / Scale);
-    Status = MvSpiFlashUpdateBlock (Slave, Offset, ToUpdate, Buf, TmpBuf, SectorSize);
+    Status = MvSpiFlashUpdateBlock (Slave, Offset, ToUpdate, Buf, TmpBuf,
+               SectorSize, &Written);
 
     if (EFI_ERROR (Status)) {
       DEBUG((DEBUG_ERROR, "SpiFlash: Error while updating\n"));
+      FreePool (TmpBuf);
       return Status;
     }
+
+    if (Written) {
+      Print (L"   \rUpdating, %d%%", 100 - (End - Buf - ToUpdate) / Scale);
+    }
   }
 
   Print(L"\n");
@@ -389,9 +488,10 @@ MvSpiFlashUpdateWithProgress (
   UINTN ToUpdate;
   UINTN Index;
   UINT8 *TmpBuf;
+  BOOLEAN Written;
 
   SectorSize = Slave->Info->SectorSize;
-  SectorNum = (ByteCount / SectorSize) + 1;
+  SectorNum = (ByteCount + SectorSize - 1) / SectorSize;
   ToUpdate = SectorSize;
 
   TmpBuf = (UINT8 *)AllocateZeroPool (SectorSize);
@@ -401,14 +501,9 @@ MvSpiFlashUpdateWithProgress (
   }
 
   for (Index = 0; Index < SectorNum; Index++) {
-    if (Progress != NULL) {
-      Progress (StartPercentage +
-                ((Index * (EndPercentage - StartPercentage)) / SectorNum));
-    }
-
     // In the last chunk update only an actual number of remaining bytes.
     if (Index + 1 == SectorNum) {
-      ToUpdate = ByteCount % SectorSize;
+      ToUpdate = ByteCount - Index * SectorSize;
     }
 
     Status = MvSpiFlashUpdateBlock (Slave,
@@ -416,11 +511,19 @@ MvSpiFlashUpdateWithProgress (
                ToUpdate,
                Buffer + Index * SectorSize,
                TmpBuf,
-               SectorSize);
+               SectorSize,
+               &Written);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a: Error while updating\n", __func__));
+      FreePool (TmpBuf);
       return Status;
     }
+
+    // Unchanged sectors are skipped silently
+    if (Written && Progress != NULL) {
+      Progress (StartPercentage +
+                (((Index + 1) * (EndPercentage - StartPercentage)) / SectorNum));
+    }
   }
   FreePool (TmpBuf);
 
@@ -159,6 +159,42 @@ SpiSetupTransfer (
   EfiReleaseLock (&SpiMaster->Lock);
 }
 
+STATIC
+EFI_STATUS
+SpiWaitReady (
+  IN UINTN SpiRegBase
+  )
+{
+  UINT32 Iterator;
+
+  for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
+    if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __func__));
+  return EFI_TIMEOUT;
+}
+
+STATIC
+VOID
+SpiSetWordMode (
+  IN UINTN   SpiRegBase,
+  IN BOOLEAN WordMode
+  )
+{
+  UINT32 Reg;
+
+  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
+  if (WordMode) {
+    Reg |= SPI_BYTE_LENGTH;
+  } else {
+    Reg &= ~SPI_BYTE_LENGTH;
+  }
+  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+}
+
 EFI_STATUS
 EFIAPI
 MvSpiTransfer (
@@ -171,18 +207,20 @@ MvSpiTransfer (
   )
 {
   SPI_MASTER *SpiMaster;
-  UINT64  Length;
-  UINT32  Iterator, Reg;
+  EFI_STATUS Status;
+  UINTN   Length;
+  UINT32  Data;
   UINT8   *DataOutPtr = (UINT8 *)DataOut;
   UINT8   *DataInPtr  = (UINT8 *)DataIn;
-  UINT8   DataToSend  = 0;
+  UINT32  DataToSend  = 0;
   UINTN   SpiRegBase;
 
   SpiMaster = SPI_MASTER_FROM_SPI_MASTER_PROTOCOL (This);
 
   SpiRegBase = Slave->HostRegisterBaseAddress;
 
-  Length = 8 * DataByteCount;
+  Length = DataByteCount;
+  Status = EFI_SUCCESS;
 
   if (!EfiAtRuntime ()) {
     EfiAcquireLock (&SpiMaster->Lock);
@@ -192,39 +230,63 @@ MvSpiTransfer (
     SpiActivateCs (Slave);
   }
 
+  //
+  // Move the bulk of the data in 16-bit mode, which halves the number of
+  // register accesses and ready polls. Words are shifted out MSB first, so
+  // the first byte goes into the upper half.
+  //
+  if (Length >= 2) {
+    SpiSetWordMode (SpiRegBase, TRUE);
+
+    while (Length >= 2) {
+      if (DataOutPtr != NULL) {
+        DataToSend = ((UINT32)DataOutPtr[0] << 8) | DataOutPtr[1];
+        DataOutPtr += 2;
+      }
+      // Transmit Data
+      MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
+      MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
+      // Wait for memory ready
+      Status = SpiWaitReady (SpiRegBase);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+      if (DataInPtr != NULL) {
+        Data = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
+        DataInPtr[0] = (UINT8)(Data >> 8);
+        DataInPtr[1] = (UINT8)Data;
+        DataInPtr += 2;
+      }
+      Length -= 2;
+    }
+  }
+
   // Set 8-bit mode
-  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
-  Reg &= ~SPI_BYTE_LENGTH;
-  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+  SpiSetWordMode (SpiRegBase, FALSE);
 
-  while (Length > 0) {
-    if (DataOut != NULL) {
+  if (Length > 0) {
+    if (DataOutPtr != NULL) {
       DataToSend = *DataOutPtr & 0xFF;
     }
     // Transmit Data
     MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
     MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
     // Wait for memory ready
-    for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
-      if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
-        if (DataInPtr != NULL) {
-          *DataInPtr = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
-          DataInPtr++;
-        }
-        if (DataOutPtr != NULL) {
-          DataOutPtr++;
-        }
-        Length -= 8;
-        break;
-      }
+    Status = SpiWaitReady (SpiRegBase);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
     }
-
-    if (Iterator >= SPI_TIMEOUT) {
-      DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __func__));
-      return EFI_TIMEOUT;
+    if (DataInPtr != NULL) {
+      *DataInPtr = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
     }
   }
 
+Exit:
+  if (EFI_ERROR (Status)) {
+    // A timeout may hit while still in 16-bit mode
+    SpiSetWordMode (SpiRegBase, FALSE);
+  }
+
   if (Flag & SPI_TRANSFER_END) {
     SpiDeactivateCs (Slave);
   }
@@ -233,7 +295,7 @@ MvSpiTransfer (
     EfiReleaseLock (&SpiMaster->Lock);
   }
 
-  return EFI_SUCCESS;
+  return Status;
 }
 
 EFI_STATUS
@@ -249,6 +311,16 @@ MvSpiReadWrite (
   )
 {
   EFI_STATUS Status;
+  UINT64     StartTicks;
+  UINT64     ElapsedNs;
+  UINT64     KBps;
+
+  StartTicks = 0;
+  DEBUG_CODE_BEGIN ();
+  if (!EfiAtRuntime () && (DataIn != NULL) && (DataSize >= SPI_THROUGHPUT_REPORT_SIZE)) {
+    StartTicks = GetPerformanceCounter ();
+  }
+  DEBUG_CODE_END ();
 
   Status = MvSpiTransfer (This, Slave, CmdSize, Cmd, NULL, SPI_TRANSFER_BEGIN);
   if (EFI_ERROR (Status)) {
@@ -262,6 +334,19 @@ MvSpiReadWrite (
     return EFI_DEVICE_ERROR;
   }
 
+  DEBUG_CODE_BEGIN ();
+  if (StartTicks != 0) {
+    ElapsedNs = GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks);
+    if (ElapsedNs != 0) {
+      // Bytes per millisecond, i.e. KB/s
+      KBps = DivU64x64Remainder (MultU64x32 (DataSize, 1000000), ElapsedNs, NULL);
+      DEBUG ((DEBUG_INFO, "%a: Read %Lu bytes in %Lu us, %Lu.%03Lu MB/s\n",
+        __func__, (UINT64)DataSize, DivU64x32 (ElapsedNs, 1000),
+        DivU64x32 (KBps, 1000), ModU64x32 (KBps, 1000)));
+    }
+  }
+  DEBUG_CODE_END ();
+
   return EFI_SUCCESS;
 }
 
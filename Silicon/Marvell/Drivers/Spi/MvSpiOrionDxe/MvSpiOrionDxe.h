@@ -7,12 +7,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef __SPI_MASTER_H__
 #define __SPI_MASTER_H__
 
+#include <Library/BaseLib.h>
 #include <Library/IoLib.h>
 #include <Library/PcdLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DxeServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Uefi/UefiBaseType.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -60,6 +62,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define SPI_TIMEOUT                     100000
 
+// Reads of at least this size report their throughput in debug builds
+#define SPI_THROUGHPUT_REPORT_SIZE      SIZE_64KB
+
 typedef struct {
   MARVELL_SPI_MASTER_PROTOCOL SpiMasterProtocol;
   UINTN                   Signature;